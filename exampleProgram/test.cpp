@@ -19,8 +19,11 @@
 #include <iostream>
 #include <locale>
 #include <array>
+#include <vector>
+#include <algorithm>
 #include <memory.h>
 #include <signal.h>
+#include <sys/resource.h>
 
 #include "epc/epctools.h"
 //#include "epc/ethread.h"
@@ -41,6 +44,8 @@
 
 #include "epc/efqdn.h"
 
+#include "epc/epfcp.h"
+
 std::locale defaultLocale;
 std::locale mylocale;
 
@@ -2467,6 +2472,322 @@ Void udpsockettest()
 ///////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////
 
+class DemuxBenchSocket : public ESocket::UdpPrivate
+{
+public:
+   DemuxBenchSocket(ESocket::ThreadPrivate &thread)
+      : ESocket::UdpPrivate(thread, 16384)
+   {
+      m_peer = NULL;
+      m_exchanges = 0;
+      m_completed = 0;
+   }
+
+   Void start(DemuxBenchSocket *peer, Int exchanges)
+   {
+      m_peer = peer;
+      m_exchanges = exchanges;
+      m_completed = 0;
+      write(m_peer->getLocal(), reinterpret_cast<cpUChar>(&m_completed), sizeof(m_completed));
+   }
+
+   Void onReceive(const ESocket::Address &from, const ESocket::Address &to, cpUChar pData, Int length)
+   {
+      if (!m_peer)
+      {
+         // the responder, echo the packet back to the sender
+         write(from, pData, length);
+         return;
+      }
+
+      if (++m_completed < m_exchanges)
+         write(m_peer->getLocal(), reinterpret_cast<cpUChar>(&m_completed), sizeof(m_completed));
+      else
+         getThread().quit();
+   }
+
+   Int getCompleted() { return m_completed; }
+
+private:
+   DemuxBenchSocket *m_peer;
+   Int m_exchanges;
+   Int m_completed;
+};
+
+class DemuxBenchThread : public ESocket::ThreadPrivate
+{
+public:
+   DemuxBenchThread(ESocket::DemuxType type, Int sockets, Int exchanges, UShort port)
+      : ESocket::ThreadPrivate(type)
+   {
+      m_sockets = sockets;
+      m_exchanges = exchanges;
+      m_port = port;
+      m_completed = 0;
+      m_elapsed = 0;
+      m_failed = False;
+   }
+
+   Void onInit()
+   {
+      DemuxBenchSocket *psocket = NULL;
+
+      // the sockets are released in onQuit()
+      try
+      {
+         // the idle sockets are created first so the active pair has the
+         // highest file descriptors, the worst case for a select() scan
+         for (Int i = 0; i < m_sockets - 2; i++)
+         {
+            psocket = new DemuxBenchSocket(*this);
+            m_created.push_back(psocket);
+            psocket->bind("127.0.0.1", 0);
+         }
+         psocket = m_sender = new DemuxBenchSocket(*this);
+         m_created.push_back(psocket);
+         m_sender->bind("127.0.0.1", m_port);
+         psocket = m_responder = new DemuxBenchSocket(*this);
+         m_created.push_back(psocket);
+         m_responder->bind("127.0.0.1", m_port + 1);
+      }
+      catch (EError &e)
+      {
+         m_failed = True;
+         m_reason = e.what();
+         quit();
+         return;
+      }
+
+      m_timer.Start();
+      m_sender->start(m_responder, m_exchanges);
+   }
+
+   Void onQuit()
+   {
+      if (!m_failed)
+      {
+         m_elapsed = m_timer.MicroSeconds();
+         m_completed = m_sender->getCompleted();
+      }
+
+      // close the sockets so that each run starts with the same number of
+      //   open file descriptors
+      for (auto psocket : m_created)
+         delete psocket;
+      m_created.clear();
+   }
+
+   Void errorHandler(EError &err, ESocket::BasePrivate *psocket)
+   {
+      std::cout << "DemuxBenchThread socket exception - " << err.what() << std::endl << std::flush;
+   }
+
+   Bool getFailed() { return m_failed; }
+   EString &getReason() { return m_reason; }
+   Int getCompleted() { return m_completed; }
+   epctime_t getElapsed() { return m_elapsed; }
+
+private:
+   Int m_sockets;
+   Int m_exchanges;
+   UShort m_port;
+   Int m_completed;
+   epctime_t m_elapsed;
+   Bool m_failed;
+   EString m_reason;
+   ETimer m_timer;
+   DemuxBenchSocket *m_sender;
+   DemuxBenchSocket *m_responder;
+   std::vector<DemuxBenchSocket*> m_created;
+};
+
+Void socketDemuxBenchmark()
+{
+   static Int exchanges = 100000;
+   static UShort port = 33333;
+   Int socketCounts[] = {10, 100, 5000};
+   ESocket::DemuxType types[] = {ESocket::DemuxType::Select, ESocket::DemuxType::Epoll};
+   Char buffer[128];
+
+   cout << "socketDemuxBenchmark() Start" << endl;
+
+   cout << "Enter number of request/response exchanges per run [" << exchanges << "]: ";
+   cin.getline(buffer, sizeof(buffer));
+   exchanges = buffer[0] ? std::stoi(buffer) : exchanges;
+   cout.imbue(defaultLocale);
+   cout << "Enter the base local port [" << port << "]: ";
+   cout.imbue(mylocale);
+   cin.getline(buffer, sizeof(buffer));
+   port = buffer[0] ? (UShort)std::stoi(buffer) : port;
+
+   // 5000 sockets needs more than the typical default of 1024 file descriptors
+   struct rlimit rl;
+   if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max)
+   {
+      rl.rlim_cur = rl.rlim_max;
+      setrlimit(RLIMIT_NOFILE, &rl);
+   }
+
+   for (auto sockets : socketCounts)
+   {
+      for (auto type : types)
+      {
+         DemuxBenchThread *pThread = new DemuxBenchThread(type, sockets, exchanges, port);
+         cpStr name = pThread->getDemuxName();
+
+         pThread->init(1, 1, NULL);
+         pThread->join();
+
+         if (pThread->getFailed())
+         {
+            cout << "demux [" << name << "] sockets [" << sockets << "] skipped - " << pThread->getReason() << endl;
+         }
+         else
+         {
+            Int wakeups = pThread->getCompleted() * 2;
+            epctime_t elapsed = pThread->getElapsed();
+            cout << "demux [" << name << "] sockets [" << sockets << "] wakeups [" << wakeups
+                 << "] elapsed [" << elapsed << "us] per wakeup ["
+                 << (wakeups ? (Double)elapsed / wakeups : 0.0) << "us]" << endl;
+         }
+
+         delete pThread;
+      }
+   }
+
+   cout << "socketDemuxBenchmark() Complete" << endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
+template <class TThread>
+class QueueBenchReceiver : public TThread
+{
+public:
+   QueueBenchReceiver(Int expected)
+   {
+      m_expected = expected;
+      m_received = 0;
+      m_elapsed = 0;
+      m_latency.resize(expected);
+   }
+
+   Void defaultMessageHandler(EThreadMessage &msg)
+   {
+      struct timespec ts;
+      clock_gettime(CLOCK_REALTIME, &ts);
+      epctime_t now = ((epctime_t)ts.tv_sec) * 1000000000 + ts.tv_nsec;
+
+      if (m_received == 0)
+         m_timer.Start();
+
+      // the queue stamps each message with the time it was pushed
+      m_latency[m_received] = now - (epctime_t)msg.data().getTimer();
+
+      if (++m_received == m_expected)
+      {
+         m_elapsed = m_timer.MicroSeconds();
+         this->quit();
+      }
+   }
+
+   epctime_t getElapsed() { return m_elapsed; }
+   std::vector<epctime_t> &getLatency() { return m_latency; }
+
+private:
+   Int m_expected;
+   Int m_received;
+   epctime_t m_elapsed;
+   ETimer m_timer;
+   std::vector<epctime_t> m_latency;
+};
+
+template <class TThread>
+class QueueBenchSender : public EThreadBasic
+{
+public:
+   QueueBenchSender(QueueBenchReceiver<TThread> &receiver, Int messages)
+      : m_receiver(receiver)
+   {
+      m_messages = messages;
+   }
+
+   Dword threadProc(pVoid arg)
+   {
+      for (Int i = 0; i < m_messages; i++)
+         m_receiver.sendMessage(EM_USER + 1);
+      return 0;
+   }
+
+private:
+   QueueBenchReceiver<TThread> &m_receiver;
+   Int m_messages;
+};
+
+template <class TThread>
+Void queueBenchmarkRun(cpStr name, Int senders, Int messages, Int queueSize)
+{
+   QueueBenchReceiver<TThread> receiver(senders * messages);
+   std::vector<QueueBenchSender<TThread>*> threads;
+
+   receiver.init(1, 1, NULL, queueSize);
+
+   for (Int i = 0; i < senders; i++)
+   {
+      threads.push_back(new QueueBenchSender<TThread>(receiver, messages));
+      threads.back()->init(NULL);
+   }
+
+   for (auto t : threads)
+   {
+      t->join();
+      delete t;
+   }
+   receiver.join();
+
+   std::vector<epctime_t> &latency = receiver.getLatency();
+   size_t p50 = latency.size() / 2;
+   size_t p99 = latency.size() * 99 / 100;
+   std::nth_element(latency.begin(), latency.begin() + p50, latency.end());
+   epctime_t p50ns = latency[p50];
+   std::nth_element(latency.begin(), latency.begin() + p99, latency.end());
+   epctime_t p99ns = latency[p99];
+
+   Double seconds = (Double)receiver.getElapsed() / 1000000;
+   cout << "queue [" << name << "] senders [" << senders << "] messages [" << latency.size()
+        << "] msgs/sec [" << numberFormatWithCommas<Double>(seconds > 0 ? latency.size() / seconds : 0)
+        << "] p50 hop [" << p50ns << "ns] p99 hop [" << p99ns << "ns]" << endl;
+}
+
+Void threadQueueBenchmark()
+{
+   static Int messages = 1000000;
+   static Int queueSize = 16384;
+   Int senderCounts[] = {1, 4};
+   Char buffer[128];
+
+   cout << "threadQueueBenchmark() Start" << endl;
+
+   cout << "Enter number of messages per sender [" << messages << "]: ";
+   cin.getline(buffer, sizeof(buffer));
+   messages = buffer[0] ? std::stoi(buffer) : messages;
+   cout << "Enter the queue size [" << queueSize << "]: ";
+   cin.getline(buffer, sizeof(buffer));
+   queueSize = buffer[0] ? std::stoi(buffer) : queueSize;
+
+   for (auto senders : senderCounts)
+   {
+      queueBenchmarkRun<EThreadPrivate>("EThreadQueuePrivate", senders, messages, queueSize);
+      queueBenchmarkRun<EThreadLockFree>("EThreadQueueLockFree", senders, messages, queueSize);
+   }
+
+   cout << "threadQueueBenchmark() Complete" << endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+
 #define EM_RWLOCKTEST (EM_USER + 1)
 
 class ERWLockTestThread : public EThreadPrivate
@@ -3797,6 +4118,199 @@ Void memoryPool_test()
 
 }
 
+class MemoryPoolBenchThread : public EThreadBasic
+{
+public:
+   MemoryPoolBenchThread(EMemory::Pool &pool, Int iterations, Int batch)
+      : m_pool(pool)
+   {
+      m_iterations = iterations;
+      m_batch = batch;
+   }
+
+   Dword threadProc(pVoid arg)
+   {
+      std::vector<pVoid> blocks(m_batch);
+
+      // allocate and free in batches so the thread holds several blocks at once
+      for (Int i = 0; i < m_iterations; i += m_batch)
+      {
+         for (Int j = 0; j < m_batch; j++)
+            blocks[j] = m_pool.allocate();
+         for (Int j = 0; j < m_batch; j++)
+            m_pool.deallocate(blocks[j]);
+      }
+      return 0;
+   }
+
+private:
+   EMemory::Pool &m_pool;
+   Int m_iterations;
+   Int m_batch;
+};
+
+Void memoryPoolBenchmarkRun(Int threads, Int iterations, Int batch, Bool cached)
+{
+   EMemory::Pool pool(128, 65536);
+   std::vector<MemoryPoolBenchThread*> workers;
+   ETimer timer;
+
+   if (!cached)
+      pool.setCacheSize(0);
+
+   timer.Start();
+   for (Int i = 0; i < threads; i++)
+   {
+      workers.push_back(new MemoryPoolBenchThread(pool, iterations, batch));
+      workers.back()->init(NULL);
+   }
+   for (auto w : workers)
+   {
+      w->join();
+      delete w;
+   }
+   timer.Stop();
+
+   Double seconds = (Double)timer.MicroSeconds() / 1000000;
+   Double ops = (Double)threads * iterations * 2;
+   cout << "pool [" << (cached ? "cached" : "locked") << "] threads [" << threads
+        << "] elapsed [" << timer.MicroSeconds() << "us] ops/sec ["
+        << numberFormatWithCommas<Double>(seconds > 0 ? ops / seconds : 0)
+        << "] nodes [" << pool.nodeCount() << "]" << endl;
+}
+
+Void memoryPoolBenchmark()
+{
+   static Int iterations = 1000000;
+   static Int batch = 16;
+   Int threadCounts[] = {1, 2, 4, 8};
+   Char buffer[128];
+
+   cout << "memoryPoolBenchmark() Start" << endl;
+
+   cout << "Enter number of allocations per thread [" << iterations << "]: ";
+   cin.getline(buffer, sizeof(buffer));
+   iterations = buffer[0] ? std::stoi(buffer) : iterations;
+   cout << "Enter the number of blocks held by each thread [" << batch << "]: ";
+   cin.getline(buffer, sizeof(buffer));
+   batch = buffer[0] ? std::max(std::stoi(buffer), 1) : batch;
+
+   for (auto threads : threadCounts)
+   {
+      memoryPoolBenchmarkRun(threads, iterations, batch, False);
+      memoryPoolBenchmarkRun(threads, iterations, batch, True);
+   }
+
+   cout << "memoryPoolBenchmark() Complete" << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+struct SeqTableBenchEntry
+{
+   SeqTableBenchEntry() : sn(0), wnd(0) {}
+   SeqTableBenchEntry(ULong s) : sn(s), wnd(0) {}
+   ULong sn;
+   Int wnd;
+};
+
+Void seqTableBenchmarkReport(cpStr name, ETimer &timer, Int windows, Int perWindow, size_t remaining)
+{
+   Double seconds = (Double)timer.MicroSeconds() / 1000000;
+   Double ops = (Double)windows * perWindow;
+   cout << "table [" << name << "] elapsed [" << timer.MicroSeconds() << "us] requests/sec ["
+        << numberFormatWithCommas<Double>(seconds > 0 ? ops / seconds : 0)
+        << "] remaining [" << remaining << "]" << endl;
+}
+
+Void seqTableBenchmarkMap(Int windows, Int perWindow)
+{
+   std::unordered_map<ULong,SeqTableBenchEntry> tbl;
+   ULong sn = 0;
+   Int crw = 1;
+   ETimer timer;
+
+   // each request is inserted, looked up as a possible duplicate and
+   // assigned to the current response window, then the table is swept
+   // for the entries in the window that is expiring
+   timer.Start();
+   for (Int w = 0; w < windows; w++)
+   {
+      for (Int i = 0; i < perWindow; i++, sn++)
+      {
+         tbl.insert(std::make_pair(sn, SeqTableBenchEntry(sn)));
+         auto it = tbl.find(sn);
+         if (it != tbl.end())
+            it->second.wnd = crw;
+      }
+      crw ^= 3;
+      auto it = tbl.begin();
+      while (it != tbl.end())
+      {
+         if (it->second.wnd == crw)
+            it = tbl.erase(it);
+         else
+            it++;
+      }
+   }
+   timer.Stop();
+
+   seqTableBenchmarkReport("unordered_map", timer, windows, perWindow, tbl.size());
+}
+
+Void seqTableBenchmarkTable(Int windows, Int perWindow, Int ringSize)
+{
+   PFCP::SeqNbrTable<SeqTableBenchEntry> tbl(ringSize);
+   ULong sn = 0;
+   Int crw = 1;
+   ETimer timer;
+
+   timer.Start();
+   for (Int w = 0; w < windows; w++)
+   {
+      for (Int i = 0; i < perWindow; i++, sn++)
+      {
+         tbl.insert(sn, SeqTableBenchEntry(sn));
+         SeqTableBenchEntry *e = tbl.setWindow(sn, crw);
+         if (e != nullptr)
+            e->wnd = crw;
+      }
+      crw ^= 3;
+      tbl.expire(crw);
+   }
+   timer.Stop();
+
+   EString name;
+   name.format("SeqNbrTable ring=%d overflow=%u", ringSize, (UInt)tbl.overflowSize());
+   seqTableBenchmarkReport(name.c_str(), timer, windows, perWindow, tbl.size());
+}
+
+Void seqTableBenchmark()
+{
+   static Int windows = 1000;
+   static Int perWindow = 10000;
+   Char buffer[128];
+
+   cout << "seqTableBenchmark() Start" << endl;
+
+   cout << "Enter the number of response windows [" << windows << "]: ";
+   cin.getline(buffer, sizeof(buffer));
+   windows = buffer[0] ? std::stoi(buffer) : windows;
+   cout << "Enter the number of requests per response window [" << perWindow << "]: ";
+   cin.getline(buffer, sizeof(buffer));
+   perWindow = buffer[0] ? std::max(std::stoi(buffer), 1) : perWindow;
+
+   // two windows of entries are outstanding at any time, so a ring smaller
+   // than that spills into the overflow map
+   seqTableBenchmarkMap(windows, perWindow);
+   seqTableBenchmarkTable(windows, perWindow, 0);
+   seqTableBenchmarkTable(windows, perWindow, perWindow);
+   seqTableBenchmarkTable(windows, perWindow, perWindow * 4);
+
+   cout << "seqTableBenchmark() Complete" << endl;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -3952,7 +4466,11 @@ Void printMenu()
        "19. Directory test                             41. Work Group                   \n"
        "20. Hash test                                  42. Memory Pool test             \n"
        "21. Thread test (1 reader/writer)              43. Load/Save DNS Queries        \n"
-       "22. Deadlock                                   44. FQDN tests\n"
+       "22. Deadlock                                   44. FQDN tests                   \n"
+       "                                               45. Socket demux benchmark       \n"
+       "                                               46. Thread queue benchmark       \n"
+       "                                               47. Memory pool benchmark        \n"
+       "                                               48. Sequence table benchmark     \n"
        "\n",
        EpcTools::isPublicEnabled() ? "" : "NOT ");
 }
@@ -4026,6 +4544,10 @@ Void run(EGetOpt &options)
             case 42: memoryPool_test();            break;
             case 43: loadSaveDnsQueries();         break;
             case 44: fqdn_test();                  break;
+            case 45: socketDemuxBenchmark();       break;
+            case 46: threadQueueBenchmark();       break;
+            case 47: memoryPoolBenchmark();        break;
+            case 48: seqTableBenchmark();          break;
             default: cout << "Invalid Selection" << endl << endl;    break;
          }
       }
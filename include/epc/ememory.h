@@ -20,23 +20,58 @@
 /// @file
 /// @brief Contains the class definitions to support the pool based memory allocation.
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include "eerror.h"
 #include "esynch.h"
 #include "etime.h"
 
 DECLARE_ERROR(EMemory_NodeSizeTooSmall);
+DECLARE_ERROR(EMemory_NodeAllocationFailed);
 
 class EMemory
 {
 public:
    class Pool;
+   class Node;
+
+   /// @brief The size of the huge pages used to back pool nodes.
+   static const size_t HugePageSize = 2097152;
+
+   /// @brief Returns the number of NUMA nodes in the system, 1 if NUMA is not supported.
+   static Int numaNodes()                 { return topology().nodes_; }
+
+   /// @brief Returns the NUMA node of the CPU the calling thread is running on.
+   static Int currentNumaNode()
+   {
+      const Topology &t = topology();
+      if (t.nodes_ == 1)
+         return 0;
+      Int cpu = sched_getcpu();
+      return cpu >= 0 && cpu < static_cast<Int>(t.cpus_.size()) ? t.cpus_[cpu] : 0;
+   }
 
    class Block
    {
       friend Pool;
    public:
       Block()
-         : next_(nullptr)
+         : next_(nullptr),
+           node_(nullptr)
 #ifdef EMEMORY_STATISTICS
            , cnt_(0)
 #endif
@@ -44,6 +79,7 @@ public:
       }
 
       Block *next()     { return next_; }
+      Node *node()      { return node_; }
       pUChar data()     { return data_; }
 
 #ifdef EMEMORY_STATISTICS
@@ -62,6 +98,7 @@ public:
 
    private:
       Block *next_;
+      Node *node_;
 #ifdef EMEMORY_STATISTICS
       ETime last_; // the last time the block was allocated
       size_t cnt_; // the number of times this block has been allocated
@@ -73,11 +110,23 @@ public:
    {
       friend Pool;
    public:
-      Node(Pool &pool) : pool_(pool), next_(nullptr) {}
+      Node(Pool &pool)
+         : pool_(pool),
+           next_(nullptr),
+           prev_(nullptr),
+           availNext_(nullptr),
+           availPrev_(nullptr),
+           free_(nullptr),
+           freeCnt_(0),
+           mapped_(0)
+      {
+      }
 
       Pool &pool()            { return pool_; }
       Node *next()            { return next_; }
       pUChar data()           { return data_; }
+      /// @brief Returns the number of blocks in this node held by the pool's free list.
+      size_t freeCount()      { return freeCnt_; }
    
    protected:
       Node &next(Node *nxt)   { next_ = nxt; return *this; }
@@ -86,64 +135,201 @@ public:
       Node();
       Pool &pool_;
       Node *next_;
+      Node *prev_;
+      Node *availNext_;
+      Node *availPrev_;
+      Block *free_;
+      size_t freeCnt_;
+      size_t mapped_; // the length of the mapping, 0 if allocated from the heap
       UChar data_[0];
    };
 
+   /// @brief A pool of fixed size memory blocks.
+   /// @details Blocks are carved out of larger nodes.  Each thread keeps a
+   ///   small cache (magazine) of free blocks for each pool it uses, so most
+   ///   allocations and deallocations do not lock.  The magazine is refilled
+   ///   from, and returned to, the pool's free list in batches of half its
+   ///   capacity.  A node whose blocks are all in the pool's free list can be
+   ///   released back to the OS, see setReleaseFreeNodes() and release().
+   ///   Nodes can be backed by huge pages and bound to a NUMA node, see
+   ///   setHugePages() and setNumaNode().
    class Pool
    {
    public:
       Pool(size_t allocSize=0, size_t nodeSize=0, size_t blockCount=0)
          : head_(nullptr),
-           free_(nullptr),
+           avail_(nullptr),
+           availTail_(nullptr),
+           mags_(nullptr),
+           id_(registerPool()),
            as_(allocSize),
-           ns_(nodeSize),
+           ns_(0),
            bs_(0),
-           bc_(blockCount)
+           bc_(0),
+           rns_(nodeSize),
+           rbc_(blockCount),
+           cs_(0),
+           csSet_(False),
+           nodes_(0),
+           emptyNodes_(0),
+           release_(False),
+           hp_(False),
+           numa_(-1)
       {
          setSize();
       }
       ~Pool()
       {
+         {
+            // the blocks cached by other threads are lost with the nodes
+            EMutexLock l(registry().mutex_);
+            for (Magazine *mag = mags_; mag; mag = mag->next_)
+            {
+               mag->pool_ = nullptr;
+               mag->head_ = nullptr;
+               mag->count_ = 0;
+            }
+            mags_ = nullptr;
+            registry().ids_.push_back(id_);
+         }
+
          while (head_)
          {
             Node *nxt = head_->next();
-            delete [] reinterpret_cast<pUChar>(head_);
+            releaseNode(head_);
             head_ = nxt;
          }
       }
 
+      /// @brief Returns the pool that a block was allocated from.
+      /// @param data the pointer returned by allocate().
+      static Pool &owner(pVoid data)
+      {
+         return reinterpret_cast<Block*>(reinterpret_cast<pUChar>(data) - sizeof(Block))->node()->pool();
+      }
+
       size_t allocSize() const            { return as_; }
       size_t blockSize() const            { return bs_; }
       size_t blockCount() const           { return bc_; }
       size_t nodeSize() const             { return ns_; }
+      /// @brief Returns the maximum number of free blocks cached by each thread.
+      size_t cacheSize() const            { return cs_; }
+      /// @brief Returns the number of nodes currently allocated.
+      size_t nodeCount() const            { return nodes_; }
+      /// @brief Indicates if nodes are released to the OS when all of their blocks are free.
+      Bool releaseFreeNodes() const       { return release_; }
+      /// @brief Indicates if nodes are allocated from huge pages.
+      Bool hugePages() const              { return hp_; }
+      /// @brief Returns the NUMA node that nodes are allocated from, -1 if not assigned.
+      Int numaNode() const                { return numa_; }
 
       Pool &setSize(size_t as, size_t ns, size_t bc=0)
       {
          as_ = as;
-         ns_ = ns;
-         bc_ = bc;
+         rns_ = ns;
+         rbc_ = bc;
          setSize();
          return *this;
       }
 
-      pVoid allocate()
+      /// @brief Assigns whether nodes are allocated from huge pages.
+      /// @details The node size is rounded up to a multiple of HugePageSize
+      ///   and the number of blocks per node is increased to fill it.  Each
+      ///   node is mapped with MAP_HUGETLB, falling back to an aligned mapping
+      ///   advised with MADV_HUGEPAGE (transparent huge pages) if no huge pages
+      ///   are reserved.  Must be called before the first allocation.
+      /// @param hp True to allocate nodes from huge pages.
+      /// @return a reference to this pool.
+      Pool &setHugePages(Bool hp)
+      {
+         hp_ = hp;
+         setSize();
+         return *this;
+      }
+
+      /// @brief Assigns the NUMA node that the memory for new nodes is allocated from.
+      /// @details The memory of each node is mapped with a preferred policy
+      ///   for the NUMA node, so it falls back to another NUMA node instead of
+      ///   failing when the preferred node is out of memory.
+      /// @param node the NUMA node, -1 to use the default memory policy of
+      ///   the allocating thread.
+      /// @return a reference to this pool.
+      Pool &setNumaNode(Int node)
+      {
+         EMutexLock l(mutex_);
+         numa_ = node;
+         return *this;
+      }
+
+      /// @brief Assigns the maximum number of free blocks cached by each thread.
+      /// @param cs the maximum number of free blocks, 0 disables the cache so
+      ///   every allocation locks the pool.  By default the cache holds up to
+      ///   64 blocks or 256KB, whichever is less.
+      /// @return a reference to this pool.
+      Pool &setCacheSize(size_t cs)
+      {
+         cs_ = cs;
+         csSet_ = True;
+         return *this;
+      }
+
+      /// @brief Assigns whether a node is released to the OS when all of its
+      ///   blocks are in the pool's free list.
+      /// @param release True to release free nodes.  One free node is always
+      ///   retained to avoid repeatedly allocating and releasing a node.
+      /// @return a reference to this pool.
+      Pool &setReleaseFreeNodes(Bool release)
       {
          EMutexLock l(mutex_);
-         if (!free_)
+         release_ = release;
+         return *this;
+      }
+
+      /// @brief Releases all nodes whose blocks are all in the pool's free
+      ///   list.  The calling thread's cached blocks are returned to the
+      ///   pool first.
+      /// @return the number of nodes released.
+      size_t release()
+      {
+         Magazine *mag = magazine();
+         if (mag)
+            flush(*mag, mag->count_);
+
+         EMutexLock l(mutex_);
+         size_t cnt = 0;
+         Node *n = avail_;
+         while (n)
          {
-            pUChar mem = new UChar[ns_];
-            Node *n = new (mem) Node(*this);
-            pUChar data = n->data();
-            for (size_t i=0; i<bc_; i++)
+            Node *nxt = n->availNext_;
+            if (n->freeCnt_ == bc_)
             {
-               Block *blk = new (data) Block();
-               blk->next(free_);
-               free_ = blk;
-               data += bs_;
+               emptyNodes_--;
+               freeNode(n);
+               cnt++;
             }
+            n = nxt;
+         }
+         return cnt;
+      }
+
+      pVoid allocate()
+      {
+         Block *blk;
+         Magazine *mag = magazine();
+
+         if (mag)
+         {
+            if (!mag->head_)
+               refill(*mag);
+            blk = mag->head_;
+            mag->head_ = blk->next();
+            mag->count_--;
+         }
+         else
+         {
+            EMutexLock l(mutex_);
+            blk = take();
          }
-         Block *blk = free_;
-         free_ = blk->next();
 #ifdef EMEMORY_STATISTICS
          blk->allocate();
 #endif
@@ -152,18 +338,352 @@ public:
 
       Void deallocate(pVoid data)
       {
-         EMutexLock l(mutex_);
          Block *blk = reinterpret_cast<Block*>(reinterpret_cast<pUChar>(data) - sizeof(Block));
-         blk->next(free_);
-         free_ = blk;
+         Magazine *mag = magazine();
+
+         if (mag)
+         {
+            if (mag->count_ >= cs_)
+               flush(*mag, (cs_ + 1) / 2);
+            blk->next(mag->head_);
+            mag->head_ = blk;
+            mag->count_++;
+         }
+         else
+         {
+            EMutexLock l(mutex_);
+            give(blk);
+         }
       }
 
    private:
+      // a thread's cache of free blocks for a single pool
+      struct Magazine
+      {
+         Pool *pool_;
+         Block *head_;
+         size_t count_;
+         Magazine *next_;
+         Magazine *prev_;
+      };
+
+      // the magazines of a thread indexed by the pool id
+      struct Cache
+      {
+         Cache() : closed_(False) {}
+         ~Cache()
+         {
+            EMutexLock l(registry().mutex_);
+            for (auto mag : mags_)
+            {
+               if (!mag)
+                  continue;
+               if (mag->pool_)
+               {
+                  Pool &pool = *mag->pool_;
+                  {
+                     EMutexLock pl(pool.mutex_);
+                     while (mag->head_)
+                     {
+                        Block *blk = mag->head_;
+                        mag->head_ = blk->next();
+                        pool.give(blk);
+                     }
+                  }
+                  pool.unlinkMagazine(mag);
+               }
+               delete mag;
+            }
+            mags_.clear();
+            closed_ = True;
+         }
+         std::vector<Magazine*> mags_;
+         Bool closed_;
+      };
+
+      struct Registry
+      {
+         Registry() : next_(0) {}
+         EMutexPrivate mutex_;
+         std::vector<size_t> ids_;
+         size_t next_;
+      };
+
+      static Registry &registry()
+      {
+         static Registry r;
+         return r;
+      }
+
+      static Cache &cache()
+      {
+         static thread_local Cache c;
+         return c;
+      }
+
+      static size_t registerPool()
+      {
+         Registry &r = registry();
+         EMutexLock l(r.mutex_);
+         if (r.ids_.empty())
+            return r.next_++;
+         size_t id = r.ids_.back();
+         r.ids_.pop_back();
+         return id;
+      }
+
+      Magazine *magazine()
+      {
+         if (cs_ == 0)
+            return nullptr;
+         Cache &c = cache();
+         if (id_ < c.mags_.size())
+         {
+            Magazine *mag = c.mags_[id_];
+            if (mag && mag->pool_ == this)
+               return mag;
+         }
+         return c.closed_ ? nullptr : attachMagazine(c);
+      }
+
+      Magazine *attachMagazine(Cache &c)
+      {
+         EMutexLock l(registry().mutex_);
+         if (id_ >= c.mags_.size())
+            c.mags_.resize(id_ + 1, nullptr);
+         Magazine *mag = c.mags_[id_];
+         if (!mag)
+            mag = c.mags_[id_] = new Magazine();
+         // a magazine left over from a destroyed pool with the same id is
+         // already empty and detached
+         mag->pool_ = this;
+         mag->head_ = nullptr;
+         mag->count_ = 0;
+         mag->prev_ = nullptr;
+         mag->next_ = mags_;
+         if (mags_)
+            mags_->prev_ = mag;
+         mags_ = mag;
+         return mag;
+      }
+
+      Void unlinkMagazine(Magazine *mag)
+      {
+         if (mag->prev_)
+            mag->prev_->next_ = mag->next_;
+         else
+            mags_ = mag->next_;
+         if (mag->next_)
+            mag->next_->prev_ = mag->prev_;
+         mag->pool_ = nullptr;
+      }
+
+      Void refill(Magazine &mag)
+      {
+         size_t cnt = (cs_ + 1) / 2;
+         EMutexLock l(mutex_);
+         while (cnt--)
+         {
+            Block *blk = take();
+            blk->next(mag.head_);
+            mag.head_ = blk;
+            mag.count_++;
+         }
+      }
+
+      Void flush(Magazine &mag, size_t cnt)
+      {
+         EMutexLock l(mutex_);
+         while (cnt-- && mag.head_)
+         {
+            Block *blk = mag.head_;
+            mag.head_ = blk->next();
+            mag.count_--;
+            give(blk);
+         }
+      }
+
+      // removes a block from the free list, the pool must be locked
+      Block *take()
+      {
+         if (!avail_)
+            newNode();
+
+         Node *n = avail_;
+         if (n->freeCnt_ == bc_)
+            emptyNodes_--;
+
+         Block *blk = n->free_;
+         n->free_ = blk->next();
+         if (--n->freeCnt_ == 0)
+            unlinkAvail(n);
+
+         return blk;
+      }
+
+      // adds a block to the free list, the pool must be locked
+      Void give(Block *blk)
+      {
+         Node *n = blk->node_;
+
+         blk->next(n->free_);
+         n->free_ = blk;
+         if (++n->freeCnt_ == 1)
+         {
+            // allocate from partially used nodes first
+            linkAvailFront(n);
+         }
+         if (n->freeCnt_ == bc_)
+         {
+            if (release_ && emptyNodes_ > 0)
+            {
+               freeNode(n);
+            }
+            else
+            {
+               // let the node drain by moving it behind the partially used nodes
+               emptyNodes_++;
+               unlinkAvail(n);
+               linkAvailBack(n);
+            }
+         }
+      }
+
+      Void newNode()
+      {
+         size_t mapped = 0;
+         pUChar mem = allocNode(mapped);
+         Node *n = new (mem) Node(*this);
+         n->mapped_ = mapped;
+         pUChar data = n->data();
+         for (size_t i=0; i<bc_; i++)
+         {
+            Block *blk = new (data) Block();
+            blk->node_ = n;
+            blk->next(n->free_);
+            n->free_ = blk;
+            data += bs_;
+         }
+         n->freeCnt_ = bc_;
+
+         n->next(head_);
+         if (head_)
+            head_->prev_ = n;
+         head_ = n;
+
+         linkAvailFront(n);
+         nodes_++;
+         emptyNodes_++;
+      }
+
+      Void freeNode(Node *n)
+      {
+         unlinkAvail(n);
+         if (n->prev_)
+            n->prev_->next(n->next());
+         else
+            head_ = n->next();
+         if (n->next())
+            n->next()->prev_ = n->prev_;
+         nodes_--;
+         releaseNode(n);
+      }
+
+      pUChar allocNode(size_t &mapped)
+      {
+         if (!hp_ && numa_ < 0)
+            return new UChar[ns_];
+
+         size_t align = hp_ ? static_cast<size_t>(HugePageSize) : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+         size_t len = (ns_ + align - 1) / align * align;
+         pVoid mem = MAP_FAILED;
+
+         if (hp_)
+            mem = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+         if (mem == MAP_FAILED)
+         {
+            // over allocate so the mapping can be trimmed to a huge page boundary
+            size_t extra = hp_ ? align : 0;
+            pUChar raw = reinterpret_cast<pUChar>(mmap(nullptr, len + extra,
+               PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (raw == MAP_FAILED)
+               throw EMemory_NodeAllocationFailed();
+            pUChar aligned = reinterpret_cast<pUChar>((reinterpret_cast<uintptr_t>(raw) + extra) & ~(extra ? extra - 1 : 0));
+            if (aligned > raw)
+               munmap(raw, aligned - raw);
+            if (raw + len + extra > aligned + len)
+               munmap(aligned + len, raw + len + extra - (aligned + len));
+            if (hp_)
+               madvise(aligned, len, MADV_HUGEPAGE);
+            mem = aligned;
+         }
+
+         if (numa_ >= 0)
+         {
+            const int MpolPreferred = 1;
+            unsigned long mask[16] = {};
+            if (numa_ < static_cast<Int>(sizeof(mask) * 8))
+            {
+               mask[numa_ / (sizeof(unsigned long) * 8)] |= 1UL << (numa_ % (sizeof(unsigned long) * 8));
+               syscall(SYS_mbind, mem, len, MpolPreferred, mask, sizeof(mask) * 8, 0);
+            }
+         }
+
+         mapped = len;
+         return reinterpret_cast<pUChar>(mem);
+      }
+
+      static Void releaseNode(Node *n)
+      {
+         if (n->mapped_)
+            munmap(n, n->mapped_);
+         else
+            delete [] reinterpret_cast<pUChar>(n);
+      }
+
+      Void linkAvailFront(Node *n)
+      {
+         n->availPrev_ = nullptr;
+         n->availNext_ = avail_;
+         if (avail_)
+            avail_->availPrev_ = n;
+         else
+            availTail_ = n;
+         avail_ = n;
+      }
+
+      Void linkAvailBack(Node *n)
+      {
+         n->availNext_ = nullptr;
+         n->availPrev_ = availTail_;
+         if (availTail_)
+            availTail_->availNext_ = n;
+         else
+            avail_ = n;
+         availTail_ = n;
+      }
+
+      Void unlinkAvail(Node *n)
+      {
+         if (n->availPrev_)
+            n->availPrev_->availNext_ = n->availNext_;
+         else
+            avail_ = n->availNext_;
+         if (n->availNext_)
+            n->availNext_->availPrev_ = n->availPrev_;
+         else
+            availTail_ = n->availPrev_;
+         n->availNext_ = nullptr;
+         n->availPrev_ = nullptr;
+      }
+
       Void setSize()
       {
          if (as_ == 0)
             return;
 
+         ns_ = rns_;
+         bc_ = rbc_;
          if (ns_ == 0)
          {
             bs_ = sizeof(Block) + as_;
@@ -180,16 +700,403 @@ public:
             if (bc_ == 0)
                throw EMemory_NodeSizeTooSmall();
          }
+
+         if (hp_)
+         {
+            // fill the huge pages backing the node with blocks
+            ns_ = (ns_ + HugePageSize - 1) / HugePageSize * HugePageSize;
+            bc_ = (ns_ - sizeof(Node)) / bs_;
+         }
+
+         if (!csSet_)
+            cs_ = std::min(static_cast<size_t>(64), static_cast<size_t>(262144) / bs_);
       }
 
       EMutexPrivate mutex_;
       Node *head_;
-      Block *free_;
+      Node *avail_;
+      Node *availTail_;
+      Magazine *mags_;
+      size_t id_;
       size_t as_;
       size_t ns_;
       size_t bs_;
       size_t bc_;
+      size_t rns_; // the requested node size
+      size_t rbc_; // the requested block count
+      size_t cs_;
+      Bool csSet_;
+      size_t nodes_;
+      size_t emptyNodes_;
+      Bool release_;
+      Bool hp_;
+      Int numa_;
+   };
+
+   /// @brief A set of pools with the same block size, one for each NUMA node.
+   /// @details allocate() uses the pool of the NUMA node that the calling
+   ///   thread is running on so objects are placed in local memory.  A block
+   ///   can be deallocated by any thread and is returned to the pool it was
+   ///   allocated from.
+   class NumaPool
+   {
+   public:
+      NumaPool(size_t allocSize=0, size_t nodeSize=0, size_t blockCount=0)
+      {
+         for (Int i = 0; i < numaNodes(); i++)
+         {
+            pools_.push_back(new Pool(allocSize, nodeSize, blockCount));
+            if (numaNodes() > 1)
+               pools_.back()->setNumaNode(i);
+         }
+      }
+      ~NumaPool()
+      {
+         for (auto p : pools_)
+            delete p;
+      }
+
+      size_t allocSize() const            { return pools_.front()->allocSize(); }
+      size_t blockSize() const            { return pools_.front()->blockSize(); }
+      size_t blockCount() const           { return pools_.front()->blockCount(); }
+      size_t nodeSize() const             { return pools_.front()->nodeSize(); }
+      /// @brief Returns the number of pools, one for each NUMA node.
+      size_t poolCount() const            { return pools_.size(); }
+      /// @brief Returns the pool for a NUMA node.
+      Pool &pool(Int numaNode)            { return *pools_[numaNode]; }
+      /// @brief Returns the pool for the NUMA node the calling thread is running on.
+      Pool &local()                       { return *pools_[pools_.size() == 1 ? 0 : currentNumaNode()]; }
+
+      NumaPool &setSize(size_t as, size_t ns, size_t bc=0)
+      {
+         for (auto p : pools_)
+            p->setSize(as, ns, bc);
+         return *this;
+      }
+      NumaPool &setCacheSize(size_t cs)
+      {
+         for (auto p : pools_)
+            p->setCacheSize(cs);
+         return *this;
+      }
+      NumaPool &setReleaseFreeNodes(Bool release)
+      {
+         for (auto p : pools_)
+            p->setReleaseFreeNodes(release);
+         return *this;
+      }
+      NumaPool &setHugePages(Bool hp)
+      {
+         for (auto p : pools_)
+            p->setHugePages(hp);
+         return *this;
+      }
+
+      pVoid allocate()                    { return local().allocate(); }
+      Void deallocate(pVoid data)         { Pool::owner(data).deallocate(data); }
+
+   private:
+      NumaPool(const NumaPool &);
+      NumaPool &operator=(const NumaPool &);
+
+      std::vector<Pool*> pools_;
+   };
+
+   class BufferPool;
+
+   /// @brief A reference counted handle to a fixed size buffer allocated from
+   ///   a BufferPool.  The buffer is returned to the pool when the last handle
+   ///   referencing it is released.
+   class Buffer
+   {
+      friend BufferPool;
+   public:
+      Buffer() : hdr_(nullptr) {}
+      Buffer(const Buffer &b) : hdr_(b.hdr_) { if (hdr_) hdr_->refs_.fetch_add(1, std::memory_order_relaxed); }
+      Buffer(Buffer &&b) : hdr_(b.hdr_) { b.hdr_ = nullptr; }
+      ~Buffer() { release(); }
+
+      Buffer &operator=(const Buffer &b)
+      {
+         if (hdr_ != b.hdr_)
+         {
+            release();
+            hdr_ = b.hdr_;
+            if (hdr_)
+               hdr_->refs_.fetch_add(1, std::memory_order_relaxed);
+         }
+         return *this;
+      }
+      Buffer &operator=(Buffer &&b)
+      {
+         if (this != &b)
+         {
+            release();
+            hdr_ = b.hdr_;
+            b.hdr_ = nullptr;
+         }
+         return *this;
+      }
+
+      /// @brief Indicates if this handle references a buffer.
+      Bool valid() const         { return hdr_ != nullptr; }
+      /// @brief Indicates if this is the only handle referencing the buffer.
+      Bool unique() const        { return hdr_ != nullptr && hdr_->refs_.load(std::memory_order_acquire) == 1; }
+      /// @brief Returns a pointer to the buffer data.
+      pUChar data()              { return hdr_ ? hdr_->data_ : nullptr; }
+      /// @brief Returns a pointer to the buffer data.
+      cpUChar data() const       { return hdr_ ? hdr_->data_ : nullptr; }
+      /// @brief Returns the size of the buffer.
+      size_t capacity() const    { return hdr_ ? hdr_->cap_ : 0; }
+      /// @brief Returns the number of bytes of the buffer that are in use.
+      size_t length() const      { return hdr_ ? hdr_->len_ : 0; }
+      /// @brief Assigns the number of bytes of the buffer that are in use.
+      Buffer &setLength(size_t len)  { if (hdr_) hdr_->len_ = len; return *this; }
+
+      /// @brief Releases the reference to the buffer.
+      Void release();
+
+      /// @brief Gives up this handle's reference without releasing it.  The
+      ///   reference must later be reclaimed with attach().
+      /// @return an opaque pointer to the reference.
+      pVoid detach()             { pVoid ref = hdr_; hdr_ = nullptr; return ref; }
+      /// @brief Creates a handle that assumes a reference given up by detach().
+      /// @param ref the opaque pointer returned by detach().
+      /// @return the handle that owns the reference.
+      static Buffer attach(pVoid ref) { return Buffer(reinterpret_cast<Header*>(ref)); }
+
+   private:
+      struct Header
+      {
+         std::atomic<Int> refs_;
+         BufferPool *pool_;
+         size_t cap_;
+         size_t len_;
+         UChar data_[0];
+      };
+
+      Buffer(Header *hdr) : hdr_(hdr) {}
+
+      Header *hdr_;
+   };
+
+   /// @brief A pool of reference counted fixed size buffers.
+   class BufferPool
+   {
+      friend Buffer;
+   public:
+      /// @brief Class constructor.
+      /// @param bufferSize the usable size of each buffer.
+      /// @param bufferCount the number of buffers allocated at a time when the pool is exhausted.
+      BufferPool(size_t bufferSize, size_t bufferCount=64)
+         : pool_(sizeof(Buffer::Header) + bufferSize, 0, bufferCount),
+           bs_(bufferSize)
+      {
+      }
+
+      /// @brief Returns the usable size of each buffer.
+      size_t bufferSize() const  { return bs_; }
+
+      /// @brief Allocates a buffer with a reference count of one.
+      Buffer allocate()
+      {
+         Buffer::Header *hdr = reinterpret_cast<Buffer::Header*>(pool_.allocate());
+         new (&hdr->refs_) std::atomic<Int>(1);
+         hdr->pool_ = this;
+         hdr->cap_ = bs_;
+         hdr->len_ = 0;
+         return Buffer(hdr);
+      }
+
+   private:
+      Void deallocate(Buffer::Header *hdr)
+      {
+         pool_.deallocate(hdr);
+      }
+
+      Pool pool_;
+      size_t bs_;
+   };
+
+   /// @brief The base class for objects whose lifetime is managed by RefPtr
+   ///   handles.  The reference count is stored in the object, so a handle
+   ///   is a single pointer and no separate control block is allocated.
+   class RefCounted
+   {
+   public:
+      /// @brief Returns the number of handles referencing this object.
+      Int refCount() const       { return refs_.load(std::memory_order_acquire); }
+
+      /// @cond DOXYGEN_EXCLUDE
+      Void addRef() const        { refs_.fetch_add(1, std::memory_order_relaxed); }
+      Void releaseRef() const
+      {
+         if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+      }
+      /// @endcond
+
+   protected:
+      RefCounted() : refs_(0) {}
+      // a copied object is referenced by none of the source object's handles
+      RefCounted(const RefCounted &) : refs_(0) {}
+      virtual ~RefCounted() {}
+      RefCounted &operator=(const RefCounted &) { return *this; }
+
+   private:
+      mutable std::atomic<Int> refs_;
    };
+
+   /// @brief A handle to a RefCounted object that deletes the object when the
+   ///   last handle is released.
+   /// @details
+   ///   Copying a handle increments the reference count while moving a
+   ///   handle does not.  detach() and attach() hand a reference off between
+   ///   threads as a raw pointer, such as in an EThreadMessage, without
+   ///   changing the reference count.
+   /// @tparam T the RefCounted derived object type.
+   template<class T>
+   class RefPtr
+   {
+      template<class U> friend class RefPtr;
+   public:
+      RefPtr() : p_(nullptr) {}
+      RefPtr(std::nullptr_t) : p_(nullptr) {}
+      /// @brief Class constructor.
+      /// @param p the object to reference.
+      explicit RefPtr(T *p) : p_(p) { if (p_) p_->addRef(); }
+      RefPtr(const RefPtr &r) : p_(r.p_) { if (p_) p_->addRef(); }
+      RefPtr(RefPtr &&r) : p_(r.p_) { r.p_ = nullptr; }
+      template<class U>
+      RefPtr(const RefPtr<U> &r) : p_(r.p_) { if (p_) p_->addRef(); }
+      template<class U>
+      RefPtr(RefPtr<U> &&r) : p_(r.p_) { r.p_ = nullptr; }
+      ~RefPtr() { if (p_) p_->releaseRef(); }
+
+      RefPtr &operator=(const RefPtr &r)
+      {
+         RefPtr(r).swap(*this);
+         return *this;
+      }
+      RefPtr &operator=(RefPtr &&r)
+      {
+         RefPtr(std::move(r)).swap(*this);
+         return *this;
+      }
+      RefPtr &operator=(std::nullptr_t)
+      {
+         reset();
+         return *this;
+      }
+
+      /// @brief Returns a pointer to the referenced object.
+      T *get() const                { return p_; }
+      T *operator->() const         { return p_; }
+      T &operator*() const          { return *p_; }
+      /// @brief Indicates if this handle references an object.
+      explicit operator bool() const { return p_ != nullptr; }
+      /// @brief Returns the number of handles referencing the object.
+      long use_count() const        { return p_ ? p_->refCount() : 0; }
+
+      /// @brief Releases the reference to the object.
+      Void reset()                  { RefPtr().swap(*this); }
+      /// @brief Releases the reference to the current object and references
+      ///   another.
+      /// @param p the object to reference.
+      Void reset(T *p)              { RefPtr(p).swap(*this); }
+      Void swap(RefPtr &r)          { std::swap(p_, r.p_); }
+
+      /// @brief Gives up this handle's reference without releasing it.  The
+      ///   reference must later be reclaimed with attach().
+      /// @return a pointer to the object.
+      T *detach()                   { T *p = p_; p_ = nullptr; return p; }
+      /// @brief Creates a handle that assumes a reference given up by detach().
+      /// @param p the pointer returned by detach().
+      /// @return the handle that owns the reference.
+      static RefPtr attach(T *p)    { RefPtr r; r.p_ = p; return r; }
+
+   private:
+      T *p_;
+   };
+
+   /// @brief Creates a RefCounted derived object.
+   /// @param args the arguments passed to the object constructor.
+   /// @return the handle referencing the new object.
+   template<class T, class... Args>
+   static RefPtr<T> makeRef(Args&&... args)
+   {
+      return RefPtr<T>(new T(std::forward<Args>(args)...));
+   }
+
+private:
+   // the NUMA node of each CPU
+   struct Topology
+   {
+      Topology()
+         : nodes_(1)
+      {
+         DIR *dir = opendir("/sys/devices/system/node");
+         if (!dir)
+            return;
+
+         Int maxnode = -1;
+         struct dirent *ent;
+         while ((ent = readdir(dir)) != nullptr)
+         {
+            Int node;
+            if (sscanf(ent->d_name, "node%d", &node) != 1)
+               continue;
+            maxnode = std::max(maxnode, node);
+
+            EString path = EString("/sys/devices/system/node/") + ent->d_name;
+            DIR *ndir = opendir(path.c_str());
+            if (!ndir)
+               continue;
+            struct dirent *cent;
+            while ((cent = readdir(ndir)) != nullptr)
+            {
+               Int cpu;
+               if (sscanf(cent->d_name, "cpu%d", &cpu) != 1)
+                  continue;
+               if (cpu >= static_cast<Int>(cpus_.size()))
+                  cpus_.resize(cpu + 1, 0);
+               cpus_[cpu] = node;
+            }
+            closedir(ndir);
+         }
+         closedir(dir);
+
+         if (maxnode > 0)
+            nodes_ = maxnode + 1;
+      }
+      std::vector<Int> cpus_;
+      Int nodes_;
+   };
+
+   static const Topology &topology()
+   {
+      static Topology t;
+      return t;
+   }
 };
 
+template<class T, class U>
+inline bool operator==(const EMemory::RefPtr<T> &a, const EMemory::RefPtr<U> &b) { return a.get() == b.get(); }
+template<class T, class U>
+inline bool operator!=(const EMemory::RefPtr<T> &a, const EMemory::RefPtr<U> &b) { return a.get() != b.get(); }
+template<class T>
+inline bool operator==(const EMemory::RefPtr<T> &a, std::nullptr_t) { return a.get() == nullptr; }
+template<class T>
+inline bool operator!=(const EMemory::RefPtr<T> &a, std::nullptr_t) { return a.get() != nullptr; }
+
+inline Void EMemory::Buffer::release()
+{
+   if (hdr_)
+   {
+      if (hdr_->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+         hdr_->pool_->deallocate(hdr_);
+      hdr_ = nullptr;
+   }
+}
+
 #endif // #ifndef __EMEMORY_H
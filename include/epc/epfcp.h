@@ -21,8 +21,10 @@
 /// @brief Contains the class definitions to support the PFCP protocol stack.
 
 #include <atomic>
+#include <memory>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "epctools.h"
 #include "eip.h"
@@ -52,19 +54,19 @@ namespace PFCP
    class ApplicationWorkGroupBase;
 
    class Translator;
+   class TranslatorMsgInfo;
    template<class TWorker> class ApplicationWorkGroup;
    class TranslationThread;
    class CommunicationThread;
 
    class RemoteNode;
-   typedef std::shared_ptr<RemoteNode> RemoteNodeSPtr;
+   typedef EMemory::RefPtr<RemoteNode> RemoteNodeSPtr;
 
    class LocalNode;
-   typedef std::shared_ptr<LocalNode> LocalNodeSPtr;
+   typedef EMemory::RefPtr<LocalNode> LocalNodeSPtr;
 
    class ReqOut;
    typedef ReqOut *ReqOutPtr;
-   typedef std::unordered_map<ULong,ReqOutPtr> ReqOutUMap;
 
    class RspOut;
    typedef RspOut *RspOutPtr;
@@ -76,11 +78,13 @@ namespace PFCP
       (PFCP::Configuration::threadApplication()._sendThreadMessage(EThreadMessage(        \
          static_cast<UInt>(PFCP::ApplicationEvents::a),static_cast<pVoid>(b))))
    #define SEND_TO_TRANSLATION(a,b)                                                       \
-      (PFCP::TranslationThread::Instance().sendMessage(EThreadMessage(                    \
-         static_cast<UInt>(PFCP::TranslationThread::Events::a),static_cast<pVoid>(b))))
+      (PFCP::TranslationThread::Instance(PFCP::_shardOf(b)).sendPriorityMessage(EThreadMessage( \
+         static_cast<UInt>(PFCP::TranslationThread::Events::a),static_cast<pVoid>(b)),    \
+         PFCP::_priorityOf(b)))
    #define SEND_TO_COMMUNICATION(a,b)                                                     \
-      (PFCP::CommunicationThread::Instance().sendMessage(EThreadMessage(                  \
-         static_cast<UInt>(PFCP::CommunicationThread::Events::a),static_cast<pVoid>(b))))
+      (PFCP::CommunicationThread::Instance(PFCP::_shardOf(b)).sendPriorityMessage(EThreadMessage( \
+         static_cast<UInt>(PFCP::CommunicationThread::Events::a),static_cast<pVoid>(b)),  \
+         PFCP::_priorityOf(b)))
 
    /////////////////////////////////////////////////////////////////////////////
    /////////////////////////////////////////////////////////////////////////////
@@ -156,6 +160,17 @@ namespace PFCP
       /// @return timeout count
       UInt getTimeout() const { return timeout_; }
 
+      /// @brief Returns the number of times a duplicate of this request was
+      ///   answered by resending the cached response.  This is thread-safe.
+      /// @return response cache hit count
+      UInt getRspCacheHit() const { return rspcachehit_; }
+
+      /// @brief Returns the number of times a duplicate of this request was
+      ///   discarded because the response had not been sent yet.  This is
+      ///   thread-safe.
+      /// @return response cache miss count
+      UInt getRspCacheMiss() const { return rspcachemiss_; }
+
       /// @brief Increments the received count
       /// @return the incremented received count
       UInt incReceived() { return ++received_; }
@@ -170,6 +185,14 @@ namespace PFCP
       /// @return the incremented timeout count
       UInt incTimeout() { return ++timeout_; }
 
+      /// @brief Increments the response cache hit count
+      /// @return the incremented response cache hit count
+      UInt incRspCacheHit() { return ++rspcachehit_; }
+
+      /// @brief Increments the response cache miss count
+      /// @return the incremented response cache miss count
+      UInt incRspCacheMiss() { return ++rspcachemiss_; }
+
    private:
       MessageStats();
 
@@ -178,6 +201,8 @@ namespace PFCP
       std::atomic<UInt> received_;
       SentArray sent_;
       std::atomic<UInt> timeout_;
+      std::atomic<UInt> rspcachehit_;
+      std::atomic<UInt> rspcachemiss_;
    };
 
    using MessageStatsMap = std::unordered_map<MessageId, MessageStats>;
@@ -220,7 +245,10 @@ namespace PFCP
       static void* operator new(size_t sz);
       static void operator delete(void* m);
    private:
+      static Void initPool(size_t sz);
       static EMemory::Pool pool_;
+      static std::atomic<Bool> poolinit_;
+      static EMutexPrivate poolmtx_;
    };
 
    /////////////////////////////////////////////////////////////////////////////
@@ -232,6 +260,28 @@ namespace PFCP
 
    /// @endcond
 
+   /// @brief Identifies how received PFCP messages are distributed to the
+   ///   communication thread shards.
+   enum class ShardMode
+   {
+      /// @brief Each shard has its own socket bound to the PFCP port with
+      ///   SO_REUSEPORT and the kernel selects the socket by remote address.
+      ReusePort,
+      /// @brief A single socket is read by the first shard, which forwards
+      ///   each message to the shard that owns the remote address.
+      Steering
+   };
+
+   /// @brief Identifies what is done with a session establishment request
+   ///   that is received while the local node is overloaded.
+   enum class OverloadAction
+   {
+      /// @brief The request is answered with Configuration::overloadCause().
+      Reject,
+      /// @brief The request is discarded.
+      Drop
+   };
+
    /// @brief Contains all of the configuration values used in the PFCP stack.
    class Configuration
    {
@@ -246,6 +296,104 @@ namespace PFCP
       static Int socketBufferSize()                                  { return bufsize_; }
       static Int setSocketBufferSize(Int sz)                         { return bufsize_ = sz; }
 
+      static Int socketBatchSize()                                   { return batchsz_; }
+      static Int setSocketBatchSize(Int sz)                          { return batchsz_ = sz; }
+
+      static Int pooledReceiveBufferSize()                           { return bufpoolsz_; }
+      static Int setPooledReceiveBufferSize(Int sz)                  { return bufpoolsz_ = sz; }
+
+      /// @brief The size of the pooled buffers that outgoing messages are
+      ///   encoded into, 0 encodes into a scratch buffer and copies the
+      ///   message.  The encoders do not check the size of the destination,
+      ///   so a non-zero size is raised to ESocket::UPD_MAX_MSG_LENGTH.
+      static Int pooledSendBufferSize()                              { return sndpoolsz_; }
+      static Int setPooledSendBufferSize(Int sz)
+      {
+         return sndpoolsz_ = sz > 0 ? std::max(sz, static_cast<Int>(ESocket::UPD_MAX_MSG_LENGTH)) : sz;
+      }
+
+      /// @brief Indicates if the encoded response to each received request
+      ///   is kept for the response window, so that a retransmitted request
+      ///   is answered by the CommunicationThread by resending it.
+      static Bool responseCache()                                    { return rspcache_; }
+      static Bool setResponseCache(Bool rc)                          { return rspcache_ = rc; }
+
+      /// @brief The number of ring slots in each table of outstanding and
+      ///   received requests, 0 stores the requests in a hash map.  It should
+      ///   exceed the number of requests exchanged with a peer per response
+      ///   window.
+      static Int sequenceWindowSize()                                { return seqwndsz_; }
+      static Int setSequenceWindowSize(Int sz)                       { return seqwndsz_ = sz; }
+
+      /// @brief Indicates if the node messages (heartbeats, associations,
+      ///   etc.) are queued to the communication and translation threads
+      ///   ahead of the session messages.
+      static Bool nodeMessagePriority()                              { return nodepri_; }
+      static Bool setNodeMessagePriority(Bool np)                    { return nodepri_ = np; }
+
+      /// @brief The maximum number of consecutive node messages processed
+      ///   while session messages are queued, 0 always processes the node
+      ///   messages first.
+      static Int nodeMessageWeight()                                 { return nodewt_; }
+      static Int setNodeMessageWeight(Int wt)                        { return nodewt_ = wt; }
+
+      /// @brief Indicates if a received heartbeat request is answered by the
+      ///   CommunicationThread from a pre-encoded heartbeat response instead
+      ///   of being decoded and encoded by the TranslationThread.
+      static Bool heartbeatFastPath()                                { return hbfast_; }
+      static Bool setHeartbeatFastPath(Bool fp)                      { return hbfast_ = fp; }
+
+      /// @brief The percentage of the translation or application event queue
+      ///   in use at which a local node becomes overloaded and stops admitting
+      ///   new sessions, 0 disables the overload control.
+      static Int overloadHighWatermark()                             { return ovldhwm_; }
+      static Int setOverloadHighWatermark(Int pct)                   { return ovldhwm_ = pct; }
+
+      /// @brief The percentage of the translation and application event
+      ///   queues in use at or below which an overloaded local node admits new
+      ///   sessions again.
+      static Int overloadLowWatermark()                              { return ovldlwm_; }
+      static Int setOverloadLowWatermark(Int pct)                    { return ovldlwm_ = pct; }
+
+      /// @brief What is done with the session establishment requests that are
+      ///   received while overloaded.
+      static OverloadAction overloadAction()                         { return ovldact_; }
+      static OverloadAction setOverloadAction(OverloadAction act)    { return ovldact_ = act; }
+
+      /// @brief The cause value of the response to a rejected session
+      ///   establishment request.
+      static UChar overloadCause()                                   { return ovldcause_; }
+      static UChar setOverloadCause(UChar cause)                     { return ovldcause_ = cause; }
+
+      /// @brief The period of validity in seconds of the overload control
+      ///   information included in a rejection, 0 omits the information.
+      static Int overloadControlValidity()                           { return ovldvalid_; }
+      static Int setOverloadControlValidity(Int secs)                { return ovldvalid_ = secs; }
+
+      /// @brief Indicates if the session memory pools are backed by huge pages.
+      static Bool sessionHugePages()                                 { return sesshp_; }
+      static Bool setSessionHugePages(Bool hp)                       { return sesshp_ = hp; }
+
+      static Int communicationShards()                               { return shards_; }
+      static Int setCommunicationShards(Int shards)                  { return shards_ = std::max(shards, 1); }
+
+      static ShardMode shardMode()                                   { return shardmode_; }
+      static ShardMode setShardMode(ShardMode mode)                  { return shardmode_ = mode; }
+
+      /// @brief The placement of the communication threads.  Each shard is
+      ///   placed with EThreadPlacement::forIndex() of its shard number.
+      static const EThreadPlacement &communicationPlacement()        { return commplc_; }
+      static const EThreadPlacement &setCommunicationPlacement(const EThreadPlacement &p) { return commplc_ = p; }
+
+      /// @brief The placement of the translation threads.  Each shard is
+      ///   placed with EThreadPlacement::forIndex() of its shard number.
+      static const EThreadPlacement &translationPlacement()          { return xlatplc_; }
+      static const EThreadPlacement &setTranslationPlacement(const EThreadPlacement &p) { return xlatplc_ = p; }
+
+      /// @brief The placement of the timer pool thread.
+      static const EThreadPlacement &timerPlacement()                { return tmrplc_; }
+      static const EThreadPlacement &setTimerPlacement(const EThreadPlacement &p) { return tmrplc_ = p; }
+
       static LongLong t1()                                           { return t1_; }
       static LongLong setT1(LongLong t1)                             { return t1_ = t1; }
 
@@ -315,6 +463,25 @@ namespace PFCP
    private:
       static UShort port_;
       static Int bufsize_;
+      static Int batchsz_;
+      static Int bufpoolsz_;
+      static Int sndpoolsz_;
+      static Bool rspcache_;
+      static Int seqwndsz_;
+      static Bool nodepri_;
+      static Int nodewt_;
+      static Bool hbfast_;
+      static Int ovldhwm_;
+      static Int ovldlwm_;
+      static OverloadAction ovldact_;
+      static UChar ovldcause_;
+      static Int ovldvalid_;
+      static Bool sesshp_;
+      static Int shards_;
+      static ShardMode shardmode_;
+      static EThreadPlacement commplc_;
+      static EThreadPlacement xlatplc_;
+      static EThreadPlacement tmrplc_;
       static LongLong t1_;
       static LongLong hbt1_;
       static Int n1_;
@@ -367,30 +534,296 @@ namespace PFCP
    /////////////////////////////////////////////////////////////////////////////
    /////////////////////////////////////////////////////////////////////////////
 
+   /// @brief A table of entries keyed by PFCP sequence number that are aged
+   ///   out by response window.
+   /// @details
+   ///   Since sequence numbers are assigned in increasing order, the entries
+   ///   that are outstanding at any time occupy a narrow range of values.  Each
+   ///   entry is stored in a ring slot indexed by the low order bits of its
+   ///   sequence number, and the rare entry whose slot is already occupied is
+   ///   stored in an overflow map.  The sequence numbers assigned to each
+   ///   response window are recorded so that expiring a window only visits
+   ///   those entries instead of sweeping the entire table.  A ring size of
+   ///   zero stores every entry in the overflow map.
+   /// @tparam T the type of value stored in the table.
+   template<class T>
+   class SeqNbrTable
+   {
+   public:
+      /// @brief Class constructor.
+      /// @param ringSize the number of ring slots, rounded up to a power of 2.
+      ///   The ring is allocated when the first entry is inserted.
+      SeqNbrTable(size_t ringSize = 0)
+         : mask_(0),
+           size_(0),
+           ringsz_(0)
+      {
+         while (ringsz_ < ringSize)
+            ringsz_ = ringsz_ ? ringsz_ << 1 : 1;
+      }
+
+      /// @brief Returns the number of entries in the table.
+      /// @return the number of entries in the table.
+      size_t size() const { return size_; }
+      /// @brief Indicates if the table is empty.
+      /// @return True if the table is empty, otherwise False.
+      Bool empty() const { return size_ == 0; }
+      /// @brief Returns the number of entries stored in the overflow map.
+      /// @return the number of entries stored in the overflow map.
+      size_t overflowSize() const { return overflow_.size(); }
+
+      /// @brief Locates the entry for a sequence number.
+      /// @param sn the sequence number.
+      /// @return a pointer to the value or nullptr if not found.
+      T *find(ULong sn)
+      {
+         Slot *s = findSlot(sn);
+         return s ? &s->value : nullptr;
+      }
+      /// @brief Locates the entry for a sequence number.
+      /// @param sn the sequence number.
+      /// @return a pointer to the value or nullptr if not found.
+      const T *find(ULong sn) const
+      {
+         const Slot *s = const_cast<SeqNbrTable*>(this)->findSlot(sn);
+         return s ? &s->value : nullptr;
+      }
+      /// @brief Indicates if an entry exists for a sequence number.
+      /// @param sn the sequence number.
+      /// @return True if the entry exists, otherwise False.
+      Bool exists(ULong sn) const { return find(sn) != nullptr; }
+
+      /// @brief Adds an entry with a response window of 0.
+      /// @param sn the sequence number.
+      /// @param value the value to store.
+      /// @return a pointer to the stored value or nullptr if an entry already
+      ///   exists for the sequence number.
+      T *insert(ULong sn, const T &value)
+      {
+         if (ringsz_ > 0 && ring_.empty())
+         {
+            ring_.resize(ringsz_);
+            mask_ = ringsz_ - 1;
+         }
+
+         Slot *s = nullptr;
+         if (!ring_.empty())
+         {
+            Slot &rs = ring_[sn & mask_];
+            if (rs.used && rs.sn == sn)
+               return nullptr;
+            if (!rs.used && (overflow_.empty() || overflow_.find(sn) == overflow_.end()))
+               s = &rs;
+         }
+
+         if (s == nullptr)
+         {
+            auto result = overflow_.insert(std::make_pair(sn, Slot()));
+            if (!result.second)
+               return nullptr;
+            s = &result.first->second;
+         }
+
+         s->sn = sn;
+         s->wnd = 0;
+         s->used = True;
+         s->value = value;
+         size_++;
+         return &s->value;
+      }
+
+      /// @brief Removes the entry for a sequence number.
+      /// @param sn the sequence number.
+      /// @return True if the entry was removed, otherwise False.
+      Bool erase(ULong sn)
+      {
+         if (!ring_.empty())
+         {
+            Slot &rs = ring_[sn & mask_];
+            if (rs.used && rs.sn == sn)
+            {
+               release(rs);
+               return True;
+            }
+         }
+         if (overflow_.erase(sn) == 1)
+         {
+            size_--;
+            return True;
+         }
+         return False;
+      }
+
+      /// @brief Assigns the response window of an entry, the entry will be
+      ///   removed when that window is expired.
+      /// @param sn the sequence number.
+      /// @param wnd the response window.
+      /// @return a pointer to the value or nullptr if not found.
+      T *setWindow(ULong sn, Int wnd)
+      {
+         Slot *s = findSlot(sn);
+         if (s == nullptr)
+            return nullptr;
+         s->wnd = wnd;
+         wnds_[wnd & WindowMask].push_back(sn);
+         return &s->value;
+      }
+
+      /// @brief Removes the entries assigned to a response window.
+      /// @param wnd the response window to expire.
+      /// @param f called with a reference to each value before it is removed.
+      template<class F>
+      Void expire(Int wnd, F f)
+      {
+         std::vector<ULong> &sns = wnds_[wnd & WindowMask];
+         for (auto sn : sns)
+         {
+            // the entry may have been removed or moved to another window
+            // since the sequence number was recorded
+            Slot *s = findSlot(sn);
+            if (s == nullptr || s->wnd != wnd)
+               continue;
+            f(s->value);
+            erase(sn);
+         }
+         sns.clear();
+      }
+      /// @brief Removes the entries assigned to a response window.
+      /// @param wnd the response window to expire.
+      Void expire(Int wnd) { expire(wnd, [](T &) {}); }
+
+      /// @brief Removes all of the entries.
+      /// @param f called with a reference to each value before it is removed.
+      template<class F>
+      Void clear(F f)
+      {
+         for (auto &s : ring_)
+         {
+            if (s.used)
+            {
+               f(s.value);
+               release(s);
+            }
+         }
+         for (auto &kv : overflow_)
+            f(kv.second.value);
+         overflow_.clear();
+         for (auto &sns : wnds_)
+            sns.clear();
+         size_ = 0;
+      }
+      /// @brief Removes all of the entries.
+      Void clear() { clear([](T &) {}); }
+
+   private:
+      static const Int WindowMask = 3;
+
+      struct Slot
+      {
+         Slot() : sn(0), wnd(0), used(False), value() {}
+         ULong sn;
+         Int wnd;
+         Bool used;
+         T value;
+      };
+
+      Slot *findSlot(ULong sn)
+      {
+         if (!ring_.empty())
+         {
+            Slot &rs = ring_[sn & mask_];
+            if (rs.used && rs.sn == sn)
+               return &rs;
+         }
+         if (overflow_.empty())
+            return nullptr;
+         auto it = overflow_.find(sn);
+         return it == overflow_.end() ? nullptr : &it->second;
+      }
+
+      Void release(Slot &s)
+      {
+         s.used = False;
+         s.value = T();
+         size_--;
+      }
+
+      ULong mask_;
+      size_t size_;
+      size_t ringsz_;
+      std::vector<Slot> ring_;
+      std::unordered_map<ULong,Slot> overflow_;
+      std::vector<ULong> wnds_[WindowMask + 1];
+   };
+
+   /////////////////////////////////////////////////////////////////////////////
+   /////////////////////////////////////////////////////////////////////////////
+
    /// @brief Allocates and deallocates SEID's (PFCP session ID's).  Each "slice"
    ///   should have it's own instance of this object.
+   /// @details
+   ///   A SEID combines a slot index in the low order 32 bits with the
+   ///   generation of that slot in the high order 32 bits.  Freed slots are
+   ///   reused after their generation is incremented, so the slot index can
+   ///   be used to directly index a session table while the generation
+   ///   identifies a SEID that is no longer valid.  A SEID is never 0.
    class SeidManager
    {
    public:
       /// @brief Default constructor.
-      SeidManager() : next_(SEID_MINIMUM) {}
+      SeidManager() : slots_(0) {}
       /// @brief Assigns the next available SEID.  This operation is thread safe.
       Seid alloc()
       {
-         Seid seid;
-         // this logic depends on the numeric overflow from a max value to zero
-         // when the value is incremented.
-         while ((seid = next_++) < SEID_MINIMUM);
-         return seid;
+         EMutexLock l(mutex_);
+         ULong slot;
+         if (free_.empty())
+         {
+            slot = static_cast<ULong>(gens_.size());
+            gens_.push_back(static_cast<ULong>(GENERATION_MINIMUM));
+            slots_.store(gens_.size(), std::memory_order_release);
+         }
+         else
+         {
+            slot = free_.back();
+            free_.pop_back();
+         }
+         return (static_cast<Seid>(gens_[slot]) << SLOT_BITS) | slot;
       }
-      /// @brief Releases a previously allocated SEID.
+      /// @brief Releases a previously allocated SEID so that its slot can be
+      ///   reused.  A SEID that is not currently allocated is ignored.  This
+      ///   operation is thread safe.
       Void free(Seid seid)
       {
-         // currently, nothing is done to "free" a SEID
-      }
+         ULong slot = slotOf(seid);
+         EMutexLock l(mutex_);
+         if (slot >= gens_.size() || gens_[slot] != generationOf(seid))
+            return;
+         if (++gens_[slot] < GENERATION_MINIMUM)
+            gens_[slot] = GENERATION_MINIMUM;
+         free_.push_back(slot);
+      }
+      /// @brief Returns the slot index encoded in a SEID.
+      /// @param seid the SEID.
+      /// @return the slot index.
+      static ULong slotOf(Seid seid)         { return static_cast<ULong>(seid & SLOT_MASK); }
+      /// @brief Returns the slot generation encoded in a SEID.
+      /// @param seid the SEID.
+      /// @return the slot generation.
+      static ULong generationOf(Seid seid)   { return static_cast<ULong>(seid >> SLOT_BITS); }
+      /// @brief Returns the number of slots that have been allocated, so the
+      ///   slot of every SEID assigned by this object is less than this value.
+      ///   This operation is thread safe.
+      /// @return the number of allocated slots.
+      size_t capacity() const                { return slots_.load(std::memory_order_acquire); }
    private:
-      static const Seid SEID_MINIMUM = 1;
-      std::atomic_ullong next_;
+      static const Int SLOT_BITS = 32;
+      static const Seid SLOT_MASK = 0x00000000ffffffff;
+      static const ULong GENERATION_MINIMUM = 1;
+      EMutexPrivate mutex_;
+      std::vector<ULong> gens_;
+      std::vector<ULong> free_;
+      std::atomic<size_t> slots_;
    };
 
    /////////////////////////////////////////////////////////////////////////////
@@ -463,7 +896,9 @@ namespace PFCP
       }
       RcvdReq(const RcvdReq &rr)
          : sn_(rr.sn_),
-           rw_(rr.rw_)
+           rw_(rr.rw_),
+           rspbuf_(rr.rspbuf_),
+           rspdata_(rr.rspdata_)
       {
       }
 
@@ -473,11 +908,28 @@ namespace PFCP
       Int rspWnd() const               { return rw_; }
       RcvdReq &setRspWnd(Int rw)       { rw_ = rw; return *this; }
 
+      // the encoded rsp, resent when the req is retransmitted
+      Bool hasRsp() const                          { return rspbuf_.valid() || !rspdata_.empty(); }
+      const EMemory::Buffer &rspBuffer() const     { return rspbuf_; }
+      cpUChar rspData() const                      { return rspdata_.data(); }
+      UShort rspLen() const                        { return static_cast<UShort>(rspdata_.size()); }
+      RcvdReq &setRsp(cpUChar data, UShort len, const EMemory::Buffer *buf)
+      {
+         if (buf != nullptr)
+            rspbuf_ = *buf;
+         else
+            rspdata_.assign(data, data + len);
+         return *this;
+      }
+
    private:
       ULong sn_;
       Int rw_;
+      EMemory::Buffer rspbuf_;
+      std::vector<UChar> rspdata_;
    };
-   typedef std::unordered_map<ULong,RcvdReq> RcvdReqUMap;
+   typedef SeqNbrTable<RcvdReq> RcvdReqTable;
+   typedef SeqNbrTable<ReqOutPtr> ReqOutTable;
    /// @endcond
 
    /////////////////////////////////////////////////////////////////////////////
@@ -485,12 +937,17 @@ namespace PFCP
 
    /// @brief Encapsulates the UDP Socket functionality used to communicate with
    ///   a PFCP peer.
-   class NodeSocket : public ESocket::UdpPrivate
+   class NodeSocket : public ESocket::UdpLockFree
    {
       friend class LocalNode;
+      friend class CommunicationThread;
    public:
-      /// @brief Default constructor.
+      /// @brief Default constructor.  The socket is serviced by the first
+      ///   communication thread shard.
       NodeSocket();
+      /// @brief Class constructor.
+      /// @param shard the communication thread shard that services the socket.
+      NodeSocket(Int shard);
       /// @brief Class destructor.
       virtual ~NodeSocket();
 
@@ -510,11 +967,21 @@ namespace PFCP
       /// @param data a pointer to the received data buffer.
       /// @param len the number of bytes received (and present in the buffer).
       Void onReceive(const ESocket::Address &src, const ESocket::Address &dst, cpUChar data, Int len);
+      /// @brief Called by the ESocket infrastructure when a UDP message is
+      ///   received into a pooled buffer.  The buffer is referenced by the
+      ///   internal message instead of being copied.
+      /// @param src the originating message IP address.
+      /// @param dst the destination (local) IP address where the message was received.
+      /// @param buf the buffer containing the received data.
+      Void onReceiveBuffer(const ESocket::Address &src, const ESocket::Address &dst, EMemory::Buffer &buf);
       /// @brief Called by the ESocket infrastructure when an error has been
       ///   detected on the socket.
       Void onError();
 
    private:
+      static EMemory::BufferPool &bufferPool();
+      Bool steer(const ESocket::Address &src, const ESocket::Address &dst, cpUChar data, Int len, EMemory::Buffer *buf);
+
       LocalNodeSPtr ln_;
    };
 
@@ -525,12 +992,13 @@ namespace PFCP
    DECLARE_ERROR(SessionBase_RemoteSeidAlreadySet);
 
    class SessionBase;
-   typedef std::shared_ptr<SessionBase> SessionBaseSPtr;
+   typedef EMemory::RefPtr<SessionBase> SessionBaseSPtr;
 
    /// @brief Represents a PFCP session.  It is expected that a developer
    ///   utilizing this library will derive their own specialized session
-   ///   object from this class.
-   class SessionBase
+   ///   object from this class.  Sessions are reference counted, create
+   ///   them with EMemory::makeRef().
+   class SessionBase : public EMemory::RefCounted
    {
    public:
       /// @brief Class constructor.
@@ -593,29 +1061,10 @@ namespace PFCP
 
       static void* operator new(size_t sz)
       {
-         if (pool_.allocSize() == 0)
-         {
-            if (sz >= (32768 - sizeof(EMemory::Node)))
-            {
-               pool_.setSize(sz, 0, 5);
-            }
-            else
-            {
-               size_t ns = 32768 - sizeof(EMemory::Node);
-               size_t bs = sz + sizeof(EMemory::Block);
-               bs += bs % sizeof(pVoid);
-               size_t bc = ns / bs;
-               if (bc < 5)
-               {
-                  pool_.setSize(sz, 0, 5);
-               }
-               else
-               {
-                  ns = sizeof(EMemory::Node) + bc * bs;
-                  pool_.setSize(sz, ns);
-               }
-            }
-         }
+         // the sessions are created by every communication thread shard, so
+         //   the pool is sized once under a lock by the first allocation
+         if (!poolinit_.load(std::memory_order_acquire))
+            initPool(sz);
          if (sz > pool_.allocSize())
          {
             EError ex;
@@ -633,7 +1082,10 @@ private:                                                 \
 
    private:
       SessionBase();
-      static EMemory::Pool pool_;
+      static Void initPool(size_t sz);
+      static EMemory::NumaPool pool_;
+      static std::atomic<Bool> poolinit_;
+      static EMutexPrivate poolmtx_;
       static ULongLong created_;
       static ULongLong deleted_;
       LocalNodeSPtr ln_;
@@ -646,9 +1098,143 @@ private:                                                 \
    /////////////////////////////////////////////////////////////////////////////
    /////////////////////////////////////////////////////////////////////////////
 
+   /// @brief A table of sessions indexed by the slot of a SEID that was
+   ///   allocated by a SeidManager.  The slots are grouped into pages that
+   ///   are only allocated while they hold a session, so a table does not
+   ///   grow to the highest slot used by the other tables.  A SEID whose slot
+   ///   is outside of the SeidManager capacity, or that was not allocated by
+   ///   a SeidManager, is stored in a hash table.  An entry is only returned
+   ///   if the complete SEID matches, so a stale SEID whose slot has been
+   ///   reused is not found.
+   class SessionTable
+   {
+   public:
+      /// @brief Default constructor.
+      SessionTable() : seidmgr_(nullptr), size_(0) {}
+
+      /// @brief Assigns the SeidManager that allocates the SEIDs stored in
+      ///   the table.  Without a SeidManager, all sessions are hashed.
+      /// @param seidmgr the SeidManager.
+      /// @return a reference to this object.
+      SessionTable &setSeidManager(const SeidManager &seidmgr) { seidmgr_ = &seidmgr; return *this; }
+
+      /// @brief Returns the number of sessions in the table.
+      /// @return the number of sessions in the table.
+      size_t size() const { return size_; }
+      /// @brief Indicates if the table is empty.
+      /// @return True if the table is empty, otherwise False.
+      Bool empty() const { return size_ == 0; }
+
+      /// @brief Returns the session for a SEID.
+      /// @param seid the SEID of the session.
+      /// @return the session object or an empty pointer if not found.
+      SessionBaseSPtr find(Seid seid) const
+      {
+         const Entry *e = findEntry(seid);
+         if (e)
+            return e->session;
+         if (!overflow_.empty())
+         {
+            auto it = overflow_.find(seid);
+            if (it != overflow_.end())
+               return it->second;
+         }
+         return SessionBaseSPtr();
+      }
+      /// @brief Adds a session.
+      /// @param seid the SEID of the session.
+      /// @param session the session object.
+      /// @return True if the session was added, False if the slot is in use.
+      Bool insert(Seid seid, const SessionBaseSPtr &session)
+      {
+         if (!isSlotted(seid))
+         {
+            if (!overflow_.insert(std::make_pair(seid, session)).second)
+               return False;
+            size_++;
+            return True;
+         }
+         ULong slot = SeidManager::slotOf(seid);
+         size_t pg = slot / PAGE_SIZE;
+         if (pg >= pages_.size())
+            pages_.resize(pg + 1);
+         if (!pages_[pg])
+            pages_[pg].reset(new Page());
+         Page &p = *pages_[pg];
+         Entry &e = p.entries[slot % PAGE_SIZE];
+         if (e.seid != 0)
+            return False;
+         e.seid = seid;
+         e.session = session;
+         p.used++;
+         size_++;
+         return True;
+      }
+      /// @brief Removes a session.
+      /// @param seid the SEID of the session.
+      /// @return True if the session was removed, otherwise False.
+      Bool erase(Seid seid)
+      {
+         Entry *e = const_cast<Entry*>(findEntry(seid));
+         if (e)
+         {
+            size_t pg = SeidManager::slotOf(seid) / PAGE_SIZE;
+            e->seid = 0;
+            e->session.reset();
+            if (--pages_[pg]->used == 0)
+               pages_[pg].reset();
+            size_--;
+            return True;
+         }
+         if (overflow_.erase(seid) == 0)
+            return False;
+         size_--;
+         return True;
+      }
+
+   private:
+      static const size_t PAGE_SIZE = 1024;
+
+      struct Entry
+      {
+         Entry() : seid(0) {}
+         Seid seid;
+         SessionBaseSPtr session;
+      };
+      struct Page
+      {
+         Page() : used(0) {}
+         Entry entries[PAGE_SIZE];
+         size_t used;
+      };
+
+      Bool isSlotted(Seid seid) const
+      {
+         return seidmgr_ != nullptr && SeidManager::generationOf(seid) != 0 &&
+            SeidManager::slotOf(seid) < seidmgr_->capacity();
+      }
+      const Entry *findEntry(Seid seid) const
+      {
+         size_t pg = SeidManager::slotOf(seid) / PAGE_SIZE;
+         if (pg >= pages_.size() || !pages_[pg])
+            return nullptr;
+         const Entry &e = pages_[pg]->entries[SeidManager::slotOf(seid) % PAGE_SIZE];
+         return e.seid == seid && seid != 0 ? &e : nullptr;
+      }
+
+      const SeidManager *seidmgr_;
+      size_t size_;
+      std::vector<std::unique_ptr<Page>> pages_;
+      SessionBaseSPtrUMap overflow_;
+   };
+
+   /////////////////////////////////////////////////////////////////////////////
+   /////////////////////////////////////////////////////////////////////////////
+
    /// @brief Contains the basic Node functionality common to both a LocalNode
-   ///   and a RemoteNode.
-   class Node
+   ///   and a RemoteNode.  Nodes are reference counted, create them with
+   ///   EMemory::makeRef().
+   class Node : public EMemory::RefCounted
    {
    public:
       /// @brief Default constructor.
@@ -735,7 +1321,7 @@ private:                                                 \
       SessionBaseSPtrUMap sessions_;
    };
 
-   typedef std::shared_ptr<Node> NodeSPtr;
+   typedef EMemory::RefPtr<Node> NodeSPtr;
 
    /////////////////////////////////////////////////////////////////////////////
    /////////////////////////////////////////////////////////////////////////////
@@ -767,6 +1353,12 @@ private:                                                 \
       /// @return a reference to this object.
       RemoteNode &setTeidRangeValue(Int trv)                { trv_ = trv; return *this; }
 
+      /// @brief Returns the communication thread shard that owns this remote
+      ///   node.  All messages to and from the remote node are processed by
+      ///   the communication and translation threads of this shard.
+      /// @return the shard index.
+      Int shard() const                                     { return shard_; }
+
       /// @brief Sets the number of activity windows.
       /// @param nbr the number of activity windows.
       /// @return a reference to this object.
@@ -832,6 +1424,24 @@ private:                                                 \
          /// @returns the incremented received count or zero if the message wasn't found
          UInt incTimeout(MessageId msgid);
 
+         /// @brief Increments the response cache hit count for the given request
+         ///   message identifier.  If the message identifier cannot be found in the
+         ///   map (see Configuration::MessageStatsTemplate()) then this is a no-op.
+         ///   This function also updates the last activity.  This method is
+         ///   thread-safe.
+         /// @param msgid the message identifier
+         /// @returns the incremented hit count or zero if the message wasn't found
+         UInt incRspCacheHit(MessageId msgid);
+
+         /// @brief Increments the response cache miss count for the given request
+         ///   message identifier.  If the message identifier cannot be found in the
+         ///   map (see Configuration::MessageStatsTemplate()) then this is a no-op.
+         ///   This function also updates the last activity.  This method is
+         ///   thread-safe.
+         /// @param msgid the message identifier
+         /// @returns the incremented miss count or zero if the message wasn't found
+         UInt incRspCacheMiss(MessageId msgid);
+
       private:
          ERWLock lock_;
          MessageStatsMap msgstats_;
@@ -865,11 +1475,13 @@ private:                                                 \
       RemoteNode &changeState(RemoteNodeSPtr &rn, State state);
       RemoteNode &restarted(RemoteNodeSPtr &rn, const ETime &restartTime);
       Bool addRcvdReq(ULong sn);
-      Bool delRcvdReq(ULong sn)                             { return rrumap_.erase(sn) == 1; }
+      Bool delRcvdReq(ULong sn)                             { return rrtbl_.erase(sn); }
       Bool setRcvdReqRspWnd(ULong sn, Int wnd);
       Bool setRcvdReqRspWnd(ULong sn);
       Void removeRcvdRqstEntries(Int wnd);
-      Bool rcvdReqExists(ULong sn) const                    { return rrumap_.find(sn) != rrumap_.end(); }
+      Bool rcvdReqExists(ULong sn) const                    { return rrtbl_.exists(sn); }
+      const RcvdReq *rcvdReq(ULong sn) const;
+      Bool setRcvdReqRsp(ULong sn, cpUChar data, UShort len, const EMemory::Buffer *buf);
 
       Void nextActivityWnd(Int wnd);
       Bool checkActivity();
@@ -879,13 +1491,16 @@ private:                                                 \
 
       RemoteNode &addSession(SessionBaseSPtr &s);
       RemoteNode &delSession(SessionBaseSPtr &s);
+
+      RemoteNode &setShard(Int shard)                       { shard_ = shard; return *this; }
       /// @endcond
 
    private:
       State state_;
       ESocket::Address addr_;
       Int trv_;
-      RcvdReqUMap rrumap_;
+      Int shard_;
+      RcvdReqTable rrtbl_;
       std::vector<ULong> awnds_;
       size_t awndcnt_;
       size_t aw_;
@@ -968,7 +1583,8 @@ private:                                                 \
       /// @brief Creates a new SEID.
       /// @return the newly created SEID.
       Seid allocSeid();
-      /// @brief Deallocates a SEID.
+      /// @brief Deallocates a SEID.  The local SEID of a session is
+      ///   deallocated when the session is deleted.
       /// @param seid the SEID to deallocate.
       Void freeSeid(Seid seid);
       /// @brief Allocates a message sequence number for a request message.
@@ -1023,13 +1639,47 @@ private:                                                 \
       SessionBaseSPtr createSession(LocalNodeSPtr &ln, RemoteNodeSPtr &rn);
 
       /// @brief Returns a reference to the underlying socket object for this local host.
+      ///   When the communication threads are sharded with SO_REUSEPORT,
+      ///   this is the socket of the first shard.
       /// @return a reference to the underlying socket object.
       NodeSocket &socket() { return socket_; }
 
+      /// @brief Returns the session object for the specified SEID.  The
+      ///   sessions are partitioned by communication thread shard, so this
+      ///   method searches the sessions of the calling thread's shard.
+      /// @param seid the SEID of the session to return.
+      /// @return the session object.
+      SessionBaseSPtr getSession(Seid seid)
+      {
+         return shard().sessions.find(seid);
+      }
+
       /// @brief Returns the current state of the local node.
       /// @return the current state of the local node.
       State state() const { return state_; }
 
+      /// @brief Indicates if the local node is overloaded.  While overloaded,
+      ///   new sessions are rejected or dropped depending on
+      ///   Configuration::overloadAction().
+      /// @return True if any communication thread shard is overloaded.
+      Bool overloaded() const { return ovldshards_.load(std::memory_order_relaxed) > 0; }
+      /// @brief Returns the number of session establishment requests that
+      ///   were rejected because the local node was overloaded.
+      /// @return the number of rejected session establishment requests.
+      UInt overloadRejected() const { return ovldrej_.load(std::memory_order_relaxed); }
+      /// @brief Returns the number of session establishment requests that
+      ///   were dropped because the local node was overloaded.
+      /// @return the number of dropped session establishment requests.
+      UInt overloadDropped() const { return ovlddrop_.load(std::memory_order_relaxed); }
+      /// @brief Returns the overload control sequence number, which is
+      ///   incremented each time the local node becomes overloaded.
+      /// @return the overload control sequence number.
+      UInt overloadSeqNbr() const { return ovldseq_.load(std::memory_order_relaxed); }
+      /// @brief Returns the percentage of the traffic that the peers are
+      ///   asked to reduce while overloaded.
+      /// @return the overload reduction metric.
+      Int overloadMetric() const { return ovldmetric_.load(std::memory_order_relaxed); }
+
    protected:
 
       /// @cond DOXYGEN_EXCLUDE
@@ -1042,38 +1692,65 @@ private:                                                 \
 
       Void nextActivityWnd(Int wnd);
       Void checkActivity(LocalNodeSPtr &ln);
+      Bool checkOverload(LocalNodeSPtr &ln);
 
-      Void onReceive(LocalNodeSPtr &ln, const ESocket::Address &src, const ESocket::Address &dst, cpUChar msg, Int len);
+      Void onReceive(LocalNodeSPtr &ln, const ESocket::Address &src, const ESocket::Address &dst, cpUChar msg, Int len, const EMemory::Buffer *buf = nullptr);
       Bool onReqOutTimeout(ReqOutPtr ro);
       Void removeOldReqs(Int rw);
 
       Void sndInitialReq(ReqOutPtr ro);
       Bool sndReq(ReqOutPtr ro);
       Void sndRsp(RspOutPtr ro);
+      Bool sndHeartbeatRsp(RemoteNodeSPtr &rn, const TranslatorMsgInfo &tmi, cpUChar msg, Int len);
 
       LocalNode &addSession(SessionBaseSPtr &s)
       {
          if (s && s->localSeid() != 0)
-            _addSession(s->localSeid(), s);
+            shard().sessions.insert(s->localSeid(), s);
          return *this;
       }
       LocalNode &delSession(SessionBaseSPtr &s)
       {
-         if (s && s->localSeid() != 0)
-            _delSession(s->localSeid());
+         // the SEID is recycled once the session is removed from the table
+         if (s && s->localSeid() != 0 && shard().sessions.erase(s->localSeid()))
+            freeSeid(s->localSeid());
          return *this;
       }
       SessionBaseSPtr createSession(LocalNodeSPtr &ln, Seid rs, RemoteNodeSPtr &rn);
+      RemoteNodeSPtr findRemoteNode(const ESocket::Address &src);
       /// @endcond
 
    private:
+      // the state that is only accessed by the communication thread of a
+      // single shard, so it is not protected by a lock
+      struct Shard
+      {
+         Shard() : socket(nullptr), rotbl(Configuration::sequenceWindowSize()), overloaded(False), hbrsplen(-1) {}
+         NodeSocket *socket;
+         ReqOutTable rotbl;
+         RemoteNodeUMap rns;
+         SessionTable sessions;
+         Bool overloaded;
+         // the pre-encoded heartbeat rsp, -1 until it is encoded
+         Int hbrsplen;
+         UChar hbrsp[64];
+      };
+
+      Shard &shard();
+      const Shard &shard() const;
+
       State state_;
       SeidManager seidmgr_;
       SequenceManager seqmgr_;
       NodeSocket socket_;
-      ReqOutUMap roumap_;
+      std::vector<Shard> shards_;
       RemoteNodeUMap rns_;
       ERWLock rnslck_;
+      std::atomic<Int> ovldshards_;
+      std::atomic<UInt> ovldrej_;
+      std::atomic<UInt> ovlddrop_;
+      std::atomic<UInt> ovldseq_;
+      std::atomic<Int> ovldmetric_;
    };
 
    typedef std::unordered_map<EIpAddress,LocalNodeSPtr> LocalNodeUMap;
@@ -1100,6 +1777,27 @@ private:                                                 \
       LocalNode::State os_;
       LocalNode::State ns_;
    };
+
+   class LocalNodeOverloadEvent : public EventBase
+   {
+   public:
+      LocalNodeOverloadEvent(LocalNodeSPtr &ln, Bool overloaded, Int load)
+         : ln_(ln),
+           ovld_(overloaded),
+           load_(load)
+      {
+      }
+
+      LocalNodeSPtr &localNode() { return ln_; }
+      Bool overloaded() const { return ovld_; }
+      Int load() const { return load_; }
+
+   private:
+      LocalNodeOverloadEvent();
+      LocalNodeSPtr ln_;
+      Bool ovld_;
+      Int load_;
+   };
    /////////////////////////////////////////////////////////////////////////////
    /////////////////////////////////////////////////////////////////////////////
 
@@ -1123,6 +1821,9 @@ private:                                                 \
       MsgClass msgClass() const              { return mc_; }
       /// @brief Returns True if this message is a request message, otherwise False.
       Bool isReq() const                     { return rqst_; }
+      /// @brief Returns True if this message is a view that decodes each
+      ///   information element when it is accessed, otherwise False.
+      virtual Bool isView() const            { return False; }
 
       /// @brief Assigns the sequence number for this message.
       /// @return a reference to this object.
@@ -1539,8 +2240,6 @@ private:                                                 \
    /// @cond DOXYGEN_EXCLUDE
    DECLARE_ERROR(InternalMsg_OutOfMemory);
 
-   class TranslatorMsgInfo;
-
    class InternalMsg
    {
    public:
@@ -1564,12 +2263,19 @@ private:                                                 \
            data_(nullptr),
            len_(0)
       {
-         assign(im.data_, im.len_);
+         if (im.buf_.valid())
+            assign(im.buf_);
+         else
+            assign(im.data_, im.len_);
       }
-      InternalMsg(const LocalNodeSPtr &ln, const RemoteNodeSPtr &rn, const TranslatorMsgInfo &tmi, cpUChar data, UShort len);
+      // the node handles are taken by value and moved into the message, so a
+      //   caller that passes a handle it no longer needs with std::move()
+      //   hands its reference to the message without touching the count
+      InternalMsg(LocalNodeSPtr ln, RemoteNodeSPtr rn, const TranslatorMsgInfo &tmi, cpUChar data, UShort len);
+      InternalMsg(LocalNodeSPtr ln, RemoteNodeSPtr rn, const TranslatorMsgInfo &tmi, const EMemory::Buffer &buf);
       virtual ~InternalMsg()
       {
-         if (data_ != nullptr)
+         if (data_ != nullptr && !buf_.valid())
             delete [] data_;
       }
 
@@ -1582,7 +2288,13 @@ private:                                                 \
          mt_ = im.mt_;
          mc_ = im.mc_;
          rqst_ = im.rqst_;
-         assign(im.data_, im.len_);
+         if (this != &im)
+         {
+            if (im.buf_.valid())
+               assign(im.buf_);
+            else
+               assign(im.data_, im.len_);
+         }
          return *this;
       }
 
@@ -1596,10 +2308,11 @@ private:                                                 \
       UChar version() const               { return ver_; }
       cpUChar data() const                { return data_; }
       UShort len() const                  { return len_; }
+      const EMemory::Buffer *buffer() const { return buf_.valid() ? &buf_ : nullptr; }
 
-      InternalMsg &setLocalNode(const LocalNodeSPtr &ln)    { ln_ = ln; return *this; }
-      InternalMsg &setRemoteNode(const RemoteNodeSPtr &rn)  { rn_ = rn; return *this; }
-      InternalMsg &setSession(const SessionBaseSPtr &ses)   { ses_ = ses; return *this; }
+      InternalMsg &setLocalNode(LocalNodeSPtr ln)           { ln_ = std::move(ln); return *this; }
+      InternalMsg &setRemoteNode(RemoteNodeSPtr rn)         { rn_ = std::move(rn); return *this; }
+      InternalMsg &setSession(SessionBaseSPtr ses)          { ses_ = std::move(ses); return *this; }
       InternalMsg &setSeqNbr(const ULong sn)                { seq_ = sn; return *this; }
       InternalMsg &setMsgType(const MsgType mt)             { mt_ = mt; return *this; }
       InternalMsg &setMsgClass(const MsgClass mc)           { mc_ = mc; return *this; }
@@ -1608,6 +2321,13 @@ private:                                                 \
 
       InternalMsg &assign(cpUChar data, UShort len)
       {
+         // a pooled buffer may be shared, so it is never written to
+         if (buf_.valid())
+         {
+            buf_.release();
+            data_ = nullptr;
+            len_ = 0;
+         }
          // allocate the memory if necessary
          if (len_ != len)
          {
@@ -1628,11 +2348,27 @@ private:                                                 \
          return *this;
       }
 
+      InternalMsg &assign(const EMemory::Buffer &buf)
+      {
+         // reference the pooled buffer instead of copying the data
+         if (buf_.valid())
+            buf_.release();
+         else if (data_ != nullptr)
+            delete [] data_;
+         buf_ = buf;
+         data_ = buf_.data();
+         len_ = static_cast<UShort>(buf_.length());
+         return *this;
+      }
+
       static void* operator new(size_t sz);
       static void operator delete(void* m);
 
    private:
+      static Void initPool();
       static EMemory::Pool pool_;
+      static std::atomic<Bool> poolinit_;
+      static EMutexPrivate poolmtx_;
       LocalNodeSPtr ln_;
       RemoteNodeSPtr rn_;
       SessionBaseSPtr ses_;
@@ -1643,6 +2379,7 @@ private:                                                 \
       UChar ver_;
       pUChar data_;
       UShort len_;
+      EMemory::Buffer buf_;
    };
 
    typedef InternalMsg *InternalMsgPtr;
@@ -1712,8 +2449,13 @@ private:                                                 \
            rs_(ri.rs_)
       {
       }
-      RspIn(const LocalNodeSPtr &ln, const RemoteNodeSPtr &rn, const TranslatorMsgInfo &tmi, cpUChar data, UShort len, AppMsgReqPtr am)
-         : InternalMsg(ln, rn, tmi, data, len),
+      RspIn(LocalNodeSPtr ln, RemoteNodeSPtr rn, const TranslatorMsgInfo &tmi, cpUChar data, UShort len, AppMsgReqPtr am)
+         : InternalMsg(std::move(ln), std::move(rn), tmi, data, len),
+           am_(am)
+      {
+      }
+      RspIn(LocalNodeSPtr ln, RemoteNodeSPtr rn, const TranslatorMsgInfo &tmi, const EMemory::Buffer &buf, AppMsgReqPtr am)
+         : InternalMsg(std::move(ln), std::move(rn), tmi, buf),
            am_(am)
       {
       }
@@ -1839,16 +2581,26 @@ private:                                                 \
    {
    public:
       ReqIn()
-         : rs_(0)
+         : rs_(0),
+           rc_(0)
       {
       }
       ReqIn(const ReqIn &ri)
          : InternalMsg(ri),
-           rs_(ri.rs_)
+           rs_(ri.rs_),
+           rc_(ri.rc_)
+      {
+      }
+      ReqIn(LocalNodeSPtr ln, RemoteNodeSPtr rn, const TranslatorMsgInfo &tmi, cpUChar data, UShort len)
+         : InternalMsg(std::move(ln), std::move(rn), tmi, data, len),
+           rs_(0),
+           rc_(0)
       {
       }
-      ReqIn(const LocalNodeSPtr &ln, const RemoteNodeSPtr &rn, const TranslatorMsgInfo &tmi, cpUChar data, UShort len)
-         : InternalMsg(ln, rn, tmi, data, len)
+      ReqIn(LocalNodeSPtr ln, RemoteNodeSPtr rn, const TranslatorMsgInfo &tmi, const EMemory::Buffer &buf)
+         : InternalMsg(std::move(ln), std::move(rn), tmi, buf),
+           rs_(0),
+           rc_(0)
       {
       }
       virtual ~ReqIn()
@@ -1860,9 +2612,14 @@ private:                                                 \
 
       const ETime &remoteStartTime()            { return rst_; }
       ReqIn &remoteStartTime(const ETime &rst)  { rst_ = rst; return *this; }
+
+      // a non-zero cause rejects the req without passing it to the application
+      UChar rejectCause() const                 { return rc_; }
+      ReqIn &rejectCause(UChar rc)              { rc_ = rc; return *this; }
    private:
       Seid rs_;
       ETime rst_;
+      UChar rc_;
    };
    typedef ReqIn *ReqInPtr;
    /// @endcond
@@ -2048,6 +2805,40 @@ Receiving a msg
       /// @param msg a pointer to the request messge that is not supported.
       /// @return a pointer to the encoded version not supported message.
       virtual RspOutPtr encodeVersionNotSupportedRsp(ReqInPtr msg) = 0;
+      /// @brief Encodes the rejection of a request that was received while
+      ///   the local node is overloaded.  The default implementation does not
+      ///   encode a rejection, so the request is discarded.  A discarded
+      ///   request is removed from the received requests of the remote node,
+      ///   so a retransmission of the request is processed again.
+      /// @param msg a pointer to the request message to reject.
+      /// @param cause the cause value of the rejection.
+      /// @return a pointer to the encoded response, or nullptr if the request
+      ///   is discarded.
+      virtual RspOutPtr encodeOverloadRsp(ReqInPtr msg, UChar cause);
+
+      /// @brief Retrieves the recovery time stamp of a received heartbeat
+      ///   request without decoding it.  This is called by the
+      ///   CommunicationThread, so it must not use the shared encode buffer.
+      ///   The default implementation returns False, so the heartbeat request
+      ///   is processed by the TranslationThread.
+      /// @param msg a pointer to the raw message buffer.
+      /// @param len the length of the raw message buffer.
+      /// @param startTime populated with the recovery time stamp.
+      /// @return True if the recovery time stamp was retrieved.
+      virtual Bool parseHeartbeatReq(cpUChar msg, Int len, ETime &startTime);
+      /// @brief Encodes the heartbeat response of a local node with a zero
+      ///   sequence number.  The CommunicationThread keeps the response and
+      ///   assigns the sequence number with assignRspSeqNbr() to answer each
+      ///   heartbeat request.  The default implementation returns 0.
+      /// @param ln the local node sending the response.
+      /// @param dest the buffer to encode the response into.
+      /// @param len the size of the buffer.
+      /// @return the length of the encoded response, 0 if it is not supported.
+      virtual UShort encodeHeartbeatRspTemplate(LocalNode &ln, pUChar dest, UShort len);
+      /// @brief Assigns the sequence number of an encoded response.
+      /// @param rsp a pointer to the encoded response.
+      /// @param seqNbr the sequence number to assign.
+      virtual Void assignRspSeqNbr(pUChar rsp, ULong seqNbr);
 
       /// @brief Encodes the PFCP request message specified by the application
       ///   message request.
@@ -2111,11 +2902,14 @@ Receiving a msg
 
    protected:
       /// @cond DOXYGEN_EXCLUDE
-      pUChar data() { return data_; }
+      pUChar data() { return scratch(); }
+      pUChar encodeBuffer(EMemory::Buffer &buf);
+      Void assignEncoded(InternalMsg &msg, EMemory::Buffer &buf, UShort len);
       /// @endcond
 
    private:
-      UChar data_[ESocket::UPD_MAX_MSG_LENGTH];
+      static EMemory::BufferPool &sendBufferPool();
+      static pUChar scratch();
    };
 
    /////////////////////////////////////////////////////////////////////////////
@@ -2220,7 +3014,9 @@ Receiving a msg
       /// DecodeReqError - TranslationThread --> ApplicationWorkGroup - DecodeReqExceptionDataPtr
       DecodeReqError          = (APPLICATION_BASE_EVENT + 11),
       /// DecodeRspError - TranslationThread --> ApplicationWorkGroup - EncodeRspExceptionDataPtr
-      DecodeRspError          = (APPLICATION_BASE_EVENT + 12)
+      DecodeRspError          = (APPLICATION_BASE_EVENT + 12),
+      /// LocalNodeOverload - CommunicationThread --> ApplicationWorkGroup - *LocalNodeOverloadEvent
+      LocalNodeOverload       = (APPLICATION_BASE_EVENT + 13)
    };
 
    /////////////////////////////////////////////////////////////////////////////
@@ -2246,12 +3042,16 @@ Receiving a msg
       /// @brief Creates a session object.
       /// @return a shared pointer to the session object
       virtual SessionBaseSPtr _createSession(LocalNodeSPtr &ln, RemoteNodeSPtr &rn) = 0;
+
+      /// @brief Returns the percentage of the application event queue in use.
+      /// @return the percentage of the application event queue in use.
+      virtual Int _queueLoad() = 0;
    };
    
    /// @brief The PFCP application work group template.  This template contains
    ///   the common event queue for the application worker threads.
    template <class TWorker>
-   class ApplicationWorkGroup : public EThreadWorkGroupPrivate<TWorker>, public ApplicationWorkGroupBase
+   class ApplicationWorkGroup : public EThreadWorkGroupLockFree<TWorker>, public ApplicationWorkGroupBase
    {
       friend CommunicationThread;
    public:
@@ -2292,6 +3092,75 @@ Receiving a msg
       /// @brief Stops the local node.
       /// @param ln a shared pointer to the LocalNode.
       Void stopLocalNode(LocalNodeSPtr &ln);
+
+   protected:
+      /// @cond DOXYGEN_EXCLUDE
+      Int _queueLoad() override
+      {
+         Int size = this->queueSize();
+         return size > 0 ? static_cast<Int>(static_cast<LongLong>(this->queueDepth()) * 100 / size) : 0;
+      }
+      /// @endcond
+
+      /// @brief Retrieves the dispatch key for an application event when the
+      ///   work group uses per worker dispatch.  Session messages are keyed by
+      ///   session and node messages by remote node so that the messages for a
+      ///   session are processed in order by a single worker.
+      /// @param msg the application event message.
+      /// @param key populated with the dispatch key.
+      /// @return True if the message has a dispatch key, otherwise False.
+      Bool dispatchKey(EThreadMessage &msg, ULongLong &key)
+      {
+         pVoid p = msg.getVoidPtr();
+         if (!p)
+            return False;
+         switch (static_cast<ApplicationEvents>(msg.getMessageId()))
+         {
+            case ApplicationEvents::RcvdReq:
+            case ApplicationEvents::ReqTimeout:       { return reqKey(static_cast<AppMsgReqPtr>(p), key); }
+            case ApplicationEvents::RcvdRsp:
+            case ApplicationEvents::SndRspError:      { return rspKey(static_cast<AppMsgRspPtr>(p), key); }
+            case ApplicationEvents::SndReqError:      { return reqKey(static_cast<SndReqExceptionDataPtr>(p)->req, key); }
+            case ApplicationEvents::EncodeReqError:   { return reqKey(static_cast<EncodeReqExceptionDataPtr>(p)->req, key); }
+            case ApplicationEvents::EncodeRspError:   { return rspKey(static_cast<EncodeRspExceptionDataPtr>(p)->rsp, key); }
+            case ApplicationEvents::RemoteNodeStateChange:
+            {
+               key = reinterpret_cast<ULongLong>(static_cast<RemoteNodeStateChangeEvent*>(p)->remoteNode().get());
+               return key != 0;
+            }
+            case ApplicationEvents::RemoteNodeRestart:
+            {
+               key = reinterpret_cast<ULongLong>(static_cast<RemoteNodeRestartEvent*>(p)->remoteNode().get());
+               return key != 0;
+            }
+            default:
+            {
+               return False;
+            }
+         }
+      }
+      /// @brief Indicates that application events are keyed, see dispatchKey().
+      /// @return True.
+      Bool usesDispatchKeys() const
+      {
+         return True;
+      }
+
+   private:
+      static Bool reqKey(AppMsgReqPtr am, ULongLong &key)
+      {
+         if (!am)
+            return False;
+         if (am->msgClass() == MsgClass::Session && static_cast<AppMsgSessionReqPtr>(am)->session())
+            key = reinterpret_cast<ULongLong>(static_cast<AppMsgSessionReqPtr>(am)->session().get());
+         else
+            key = reinterpret_cast<ULongLong>(am->remoteNode().get());
+         return key != 0;
+      }
+      static Bool rspKey(AppMsgRspPtr am, ULongLong &key)
+      {
+         return am ? reqKey(am->req(), key) : False;
+      }
    };
 
    /////////////////////////////////////////////////////////////////////////////
@@ -2301,7 +3170,7 @@ Receiving a msg
    ///   should be overridden to implement application specific behavior.  Any
    ///   additional event handlers can be added to handle application specific
    ///   (non PFCP) events.
-   class ApplicationWorker : public EThreadWorkerPrivate
+   class ApplicationWorker : public EThreadWorkerLockFree
    {
       friend Void Uninitialize();
    public:
@@ -2329,6 +3198,12 @@ Receiving a msg
       /// @param oldState the previous state of the local node.
       /// @param newState the new state of the local node.
       virtual Void onLocalNodeStateChange(LocalNodeSPtr &ln, LocalNode::State oldState, LocalNode::State newState);
+      /// @brief Called when a communication thread shard of the local node
+      ///   becomes overloaded or is no longer overloaded.
+      /// @param ln a shared pointer to the local node object.
+      /// @param overloaded True if the shard became overloaded.
+      /// @param load the percentage of the busiest event queue in use.
+      virtual Void onLocalNodeOverload(LocalNodeSPtr &ln, Bool overloaded, Int load);
       /// @brief Called when a new remote node/peer has been added.
       /// @param rn a shared pointer to the remote node object.
       /// @param oldState the previous state of the remote node.
@@ -2366,6 +3241,7 @@ Receiving a msg
       Void _onRcvdRsp(EThreadMessage &msg);
       Void _onReqTimeout(EThreadMessage &msg);
       Void _onLocalNodeStateChange(EThreadMessage &msg);
+      Void _onLocalNodeOverload(EThreadMessage &msg);
       Void _onRemoteNodeStateChange(EThreadMessage &msg);
       Void _onRemoteNodeRestart(EThreadMessage &msg);
       Void _onSndReqError(EThreadMessage &msg);
@@ -2373,11 +3249,12 @@ Receiving a msg
       Void _onEncodeReqError(EThreadMessage &msg);
       Void _onEncodeRspError(EThreadMessage &msg);
 
-      BEGIN_MESSAGE_MAP2(ApplicationWorker, EThreadWorkerPrivate)
+      BEGIN_MESSAGE_MAP2(ApplicationWorker, EThreadWorkerLockFree)
          ON_MESSAGE2(static_cast<UInt>(ApplicationEvents::RcvdReq), ApplicationWorker::_onRcvdReq)
          ON_MESSAGE2(static_cast<UInt>(ApplicationEvents::RcvdRsp), ApplicationWorker::_onRcvdRsp)
          ON_MESSAGE2(static_cast<UInt>(ApplicationEvents::ReqTimeout), ApplicationWorker::_onReqTimeout)
          ON_MESSAGE2(static_cast<UInt>(ApplicationEvents::LocalNodeStateChange), ApplicationWorker::_onLocalNodeStateChange)
+         ON_MESSAGE2(static_cast<UInt>(ApplicationEvents::LocalNodeOverload), ApplicationWorker::_onLocalNodeOverload)
          ON_MESSAGE2(static_cast<UInt>(ApplicationEvents::RemoteNodeStateChange), ApplicationWorker::_onRemoteNodeStateChange)
          ON_MESSAGE2(static_cast<UInt>(ApplicationEvents::RemoteNodeRestart), ApplicationWorker::_onRemoteNodeRestart)
          ON_MESSAGE2(static_cast<UInt>(ApplicationEvents::SndReqError), ApplicationWorker::_onSndReqError)
@@ -2392,10 +3269,111 @@ Receiving a msg
    /////////////////////////////////////////////////////////////////////////////
    /////////////////////////////////////////////////////////////////////////////
 
+   /// @cond DOXYGEN_EXCLUDE
+   // Determines the communication/translation thread shard that a message
+   // sent with SEND_TO_TRANSLATION() or SEND_TO_COMMUNICATION() belongs to.
+   // Messages that reference a remote node are routed to the shard that owns
+   // the remote node, all others (-1) stay on the shard of the calling thread.
+   template<class T>
+   inline auto _shardOfImpl(T *p, Int) -> decltype(p->remoteNode()->shard())
+   {
+      return p != nullptr && p->remoteNode() ? p->remoteNode()->shard() : -1;
+   }
+   template<class T>
+   inline Int _shardOfImpl(T *p, ...)
+   {
+      return -1;
+   }
+   inline Int _shardOfImpl(RemoteNode *rn, Int)
+   {
+      return rn != nullptr ? rn->shard() : -1;
+   }
+   template<class T>
+   inline Int _shardOf(T *p)
+   {
+      return _shardOfImpl(p, 0);
+   }
+
+   // Determines the queue priority of a message sent with SEND_TO_TRANSLATION()
+   // or SEND_TO_COMMUNICATION().  Heartbeats and the other node messages are
+   // sent with priority 1 so they are not delayed behind the session messages.
+   template<class T>
+   inline auto _priorityOfImpl(T *p, Int) -> decltype(p->msgClass(), Int())
+   {
+      return p != nullptr && p->msgClass() == MsgClass::Node ? 1 : 0;
+   }
+   template<class T>
+   inline Int _priorityOfImpl(T *p, ...)
+   {
+      return 0;
+   }
+   inline Int _priorityOfImpl(SndHeartbeatReqData *p, Int)  { return 1; }
+   inline Int _priorityOfImpl(RcvdHeartbeatReqData *p, Int) { return 1; }
+   inline Int _priorityOfImpl(SndHeartbeatRspData *p, Int)  { return 1; }
+   inline Int _priorityOfImpl(RcvdHeartbeatRspData *p, Int) { return 1; }
+   // rejecting a req while overloaded skips the backlog that caused it
+   inline Int _priorityOfImpl(ReqIn *p, Int)
+   {
+      return p != nullptr && (p->msgClass() == MsgClass::Node || p->rejectCause() != 0) ? 1 : 0;
+   }
+   template<class T>
+   inline Int _priorityOf(T *p)
+   {
+      return _priorityOfImpl(p, 0);
+   }
+
+   class RcvdMsgData
+   {
+   public:
+      RcvdMsgData(const LocalNodeSPtr &ln, const ESocket::Address &src, const ESocket::Address &dst,
+            cpUChar data, Int len, const EMemory::Buffer *buf)
+         : ln_(ln),
+           src_(src),
+           dst_(dst),
+           len_(len)
+      {
+         if (buf != nullptr)
+         {
+            buf_ = *buf;
+            data_ = buf_.data();
+         }
+         else
+         {
+            data_ = new UChar[len];
+            std::memcpy(data_, data, len);
+         }
+      }
+      ~RcvdMsgData()
+      {
+         if (!buf_.valid())
+            delete [] data_;
+      }
+
+      LocalNodeSPtr &localNode()                { return ln_; }
+      const ESocket::Address &src() const       { return src_; }
+      const ESocket::Address &dst() const       { return dst_; }
+      cpUChar data() const                      { return data_; }
+      Int len() const                           { return len_; }
+      const EMemory::Buffer *buffer() const     { return buf_.valid() ? &buf_ : nullptr; }
+
+   private:
+      LocalNodeSPtr ln_;
+      ESocket::Address src_;
+      ESocket::Address dst_;
+      pUChar data_;
+      Int len_;
+      EMemory::Buffer buf_;
+   };
+   typedef RcvdMsgData *RcvdMsgDataPtr;
+   /// @endcond
+
+   /////////////////////////////////////////////////////////////////////////////
+   /////////////////////////////////////////////////////////////////////////////
+
    /// @cond DOXYGEN_EXCLUDE
    #define TRANSLATION_BASE_EVENT (EM_USER + 20000)
 
-   class TranslationThread : public EThreadPrivate
+   class TranslationThread : public EThreadLockFree
    {
       friend Void Uninitialize();
       friend AppMsgReq;
@@ -2412,13 +3390,23 @@ Receiving a msg
 
       ~TranslationThread();
 
-      static TranslationThread &Instance()
+      static TranslationThread &Instance();
+      static TranslationThread &Instance(Int shard)
       {
+         if (shard < 0)
+            return Instance();
          if (this_ == nullptr)
-            this_ = new TranslationThread();
-         return *this_;
+         {
+            nshards_ = Configuration::communicationShards();
+            this_ = new TranslationThread*[nshards_]();
+         }
+         if (this_[shard] == nullptr)
+            this_[shard] = new TranslationThread(shard);
+         return *this_[shard];
       }
 
+      Int shard() const                                                 { return shard_; }
+
       Void onInit();
       Void onQuit();
 
@@ -2445,14 +3433,20 @@ Receiving a msg
      
       static Void cleanup()
       {
-         delete this_;
+         if (this_ == nullptr)
+            return;
+         for (Int i = 0; i < nshards_; i++)
+            delete this_[i];
+         delete [] this_;
          this_ = NULL;
       }
 
    private:
-      static TranslationThread *this_;
-      TranslationThread();
+      static TranslationThread **this_;
+      static Int nshards_;
+      TranslationThread(Int shard);
       Translator &xlator_;
+      Int shard_;
    };
    /// @endcond
 
@@ -2462,7 +3456,7 @@ Receiving a msg
    /// @cond DOXYGEN_EXCLUDE
    #define COMMUNICATION_BASE_EVENT (EM_USER + 30000)
 
-   class CommunicationThread : public ESocket::ThreadPrivate
+   class CommunicationThread : public ESocket::ThreadLockFree
    {
       friend Void Uninitialize();
       friend TranslationThread;
@@ -2478,25 +3472,50 @@ Receiving a msg
          RcvdReqError         = (COMMUNICATION_BASE_EVENT + 7),   // TranslationThread --> CommunicationThread - RcvdReqExceptionDataPtr - (Translator failure to parse req)
          RcvdRspError         = (COMMUNICATION_BASE_EVENT + 8),   // TranslationThread --> CommunicationThread - RcvdRspExceptionDataPtr - (Translator failure to parse response)
          ReqTimeout           = (COMMUNICATION_BASE_EVENT + 9),   // ETimerPool --> CommunicationThread - ReqOutPtr
-         AddSession           = (COMMUNICATION_BASE_EVENT + 10),  // ApplicationThread --> CommunicationThread - *SessionBaseSPtr
-         DelSession           = (COMMUNICATION_BASE_EVENT + 11),  // ApplicationThread --> CommunicationThread - *SessionBaseSPtr
-         DelNxtRmtSession     = (COMMUNICATION_BASE_EVENT + 12)   // ApplicationThread/CommunicationThread --> CommunicationThread - *RemoteNodeSPtr
+         AddSession           = (COMMUNICATION_BASE_EVENT + 10),  // ApplicationThread --> CommunicationThread - SessionBase* (detached reference)
+         DelSession           = (COMMUNICATION_BASE_EVENT + 11),  // ApplicationThread --> CommunicationThread - SessionBase* (detached reference)
+         DelNxtRmtSession     = (COMMUNICATION_BASE_EVENT + 12),  // ApplicationThread/CommunicationThread --> CommunicationThread - RemoteNode* (detached reference)
+         RcvdMsg              = (COMMUNICATION_BASE_EVENT + 13),  // CommunicationThread --> CommunicationThread - RcvdMsgDataPtr - (steered to the owning shard)
+         RcvdReqDropped       = (COMMUNICATION_BASE_EVENT + 14)   // TranslationThread --> CommunicationThread - ReqInPtr - (overloaded req discarded without a rsp)
       };
 
       ~CommunicationThread();
 
+      /// @brief Returns the communication thread of the calling thread's
+      ///   shard, or the first shard when called from any other thread.
       static CommunicationThread &Instance()
       {
+         return Instance(curshard_ < 0 ? 0 : curshard_);
+      }
+      static CommunicationThread &Instance(Int shard)
+      {
+         if (shard < 0)
+            return Instance();
          if (this_ == nullptr)
-            this_ = new CommunicationThread();
-         return *this_;
+         {
+            nshards_ = Configuration::communicationShards();
+            this_ = new CommunicationThread*[nshards_]();
+         }
+         if (this_[shard] == nullptr)
+            this_[shard] = new CommunicationThread(shard);
+         return *this_[shard];
       }
 
+      /// @brief Returns the number of communication/translation thread shards.
+      static Int shards()                                               { return Configuration::communicationShards(); }
+      /// @brief Returns the shard of the calling thread, 0 for threads that
+      ///   are not a communication or translation thread.
+      static Int currentShard()                                         { return curshard_ < 0 ? 0 : curshard_; }
+      /// @brief Returns the shard that owns the specified remote address.
+      static Int shardOf(const ESocket::Address &addr)                  { return ESocket::UdpLockFree::reusePortIndex(addr, shards()); }
+
+      Int shard() const                                                 { return shard_; }
+
       Void onInit();
       Void onQuit();
       Void onTimer(EThreadEventTimer *ptimer);
 
-      Void errorHandler(EError &err, ESocket::BasePrivate *psocket);
+      Void errorHandler(EError &err, ESocket::BaseLockFree *psocket);
 
       const ESocket::Address &address()                                 { return address_; }
       CommunicationThread &setAddress(const ESocket::Address &address)  { address_ = address; return *this; }
@@ -2508,14 +3527,18 @@ Receiving a msg
          return lns_.insert(std::make_pair(ln->ipAddress(), ln)).second;
       }
 
+      // the TEID range values are shared by all of the shards, so they are
+      // managed by the first shard
       Bool assignTeidRangeValue(RemoteNodeSPtr &rn)
       {
-         return trm_.assign(rn);
+         EMutexLock lck(trmmtx_);
+         return Instance(0).trm_.assign(rn);
       }
 
       Void releaseTeidRangeValue(RemoteNodeSPtr &rn)
       {
-         trm_.release(rn);
+         EMutexLock lck(trmmtx_);
+         Instance(0).trm_.release(rn);
       }
 
       Void startLocalNode(LocalNodeSPtr &ln);
@@ -2549,12 +3572,18 @@ Receiving a msg
       Void onAddSession(EThreadMessage &msg);
       Void onDelSession(EThreadMessage &msg);
       Void onDelNxtRmtSession(EThreadMessage &msg);
+      Void onRcvdMsg(EThreadMessage &msg);
+      Void onRcvdReqDropped(EThreadMessage &msg);
 
       Void onHeartbeatReqTimtout(AppMsgReqPtr am);
 
       static Void cleanup()
       {
-         delete this_;
+         if (this_ == nullptr)
+            return;
+         for (Int i = 0; i < nshards_; i++)
+            delete this_[i];
+         delete [] this_;
          this_ = NULL;
       }
 
@@ -2562,16 +3591,20 @@ Receiving a msg
       static const Int rwOne_ = 1;
       static const Int rwTwo_ = 2;
       static const Int rwToggle_ = (rwOne_ ^ rwTwo_);
-      static CommunicationThread *this_;
+      static CommunicationThread **this_;
+      static Int nshards_;
+      static thread_local Int curshard_;
       
-      CommunicationThread();
+      CommunicationThread(Int shard);
       Void addSession(SessionBaseSPtr &s);
       Void delSession(SessionBaseSPtr &s);
 
       ESocket::Address address_;
+      static EMutexPrivate trmmtx_;
       TeidRangeManager trm_;
-      ERWLock lnslck_;
-      LocalNodeUMap lns_;
+      static ERWLock lnslck_;
+      static LocalNodeUMap lns_;
+      Int shard_;
       EThreadEventTimer atmr_;
       EThreadEventTimer rsptmr_;
       size_t caw_;
@@ -2609,7 +3642,8 @@ Receiving a msg
       }
       if (notify)
       {
-         auto s2 = new SessionBaseSPtr(s);
+         // the message carries a reference to the session
+         SessionBase *s2 = SessionBaseSPtr(s).detach();
          SEND_TO_COMMUNICATION(AddSession, s2);
       }
       return *this;
@@ -2617,13 +3651,13 @@ Receiving a msg
    
    inline Void SessionBase::destroy(SessionBaseSPtr &s)
    {
-      auto s2 = new SessionBaseSPtr(s);
+      SessionBase *s2 = SessionBaseSPtr(s).detach();
       SEND_TO_COMMUNICATION(DelSession, s2);
    }
 
-   inline InternalMsg::InternalMsg(const LocalNodeSPtr &ln, const RemoteNodeSPtr &rn, const TranslatorMsgInfo &tmi, cpUChar data, UShort len)
-      : ln_(ln),
-        rn_(rn),
+   inline InternalMsg::InternalMsg(LocalNodeSPtr ln, RemoteNodeSPtr rn, const TranslatorMsgInfo &tmi, cpUChar data, UShort len)
+      : ln_(std::move(ln)),
+        rn_(std::move(rn)),
         seq_(tmi.seqNbr()),
         mt_(tmi.msgType()),
         mc_(tmi.msgClass()),
@@ -2635,6 +3669,35 @@ Receiving a msg
       assign(data, len);
    }
 
+   inline InternalMsg::InternalMsg(LocalNodeSPtr ln, RemoteNodeSPtr rn, const TranslatorMsgInfo &tmi, const EMemory::Buffer &buf)
+      : ln_(std::move(ln)),
+        rn_(std::move(rn)),
+        seq_(tmi.seqNbr()),
+        mt_(tmi.msgType()),
+        mc_(tmi.msgClass()),
+        rqst_(tmi.isReq()),
+        ver_(tmi.version()),
+        data_(nullptr),
+        len_(0)
+   {
+      assign(buf);
+   }
+
+   inline TranslationThread &TranslationThread::Instance()
+   {
+      return Instance(CommunicationThread::currentShard());
+   }
+
+   inline LocalNode::Shard &LocalNode::shard()
+   {
+      return shards_[CommunicationThread::currentShard()];
+   }
+
+   inline const LocalNode::Shard &LocalNode::shard() const
+   {
+      return shards_[CommunicationThread::currentShard()];
+   }
+
    inline Void ReqOut::startT1()
    {
       stopT1();
@@ -2669,21 +3732,8 @@ Receiving a msg
 
    inline void* InternalMsg::operator new(size_t sz)
    {
-      if (pool_.allocSize() == 0)
-      {
-         size_t as = 0;
-         if (sizeof(RspOut) > as)   as = sizeof(RspOut);
-         if (sizeof(RspIn) > as)   as = sizeof(RspIn);
-         if (sizeof(ReqOut) > as)   as = sizeof(ReqOut);
-         if (sizeof(ReqIn) > as)   as = sizeof(ReqIn);
-
-         size_t ns = 32768 - sizeof(EMemory::Node);
-         size_t bs = as + sizeof(EMemory::Block);
-         bs += bs % sizeof(pVoid);
-         size_t bc = ns / bs;
-         ns = sizeof(EMemory::Node) + bc * bs;
-         pool_.setSize(as, ns);
-      }
+      if (!poolinit_.load(std::memory_order_acquire))
+         initPool();
       if (sz > pool_.allocSize())
       {
          EError ex;
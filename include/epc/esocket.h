@@ -18,6 +18,7 @@
 #ifndef __esocket_h_included
 #define __esocket_h_included
 
+#include <atomic>
 #include <csignal>
 #include <cstring>
 #include <unordered_map>
@@ -28,9 +29,13 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <sys/epoll.h>
+#include <sys/select.h>
+#include <linux/filter.h>
 
 #include "ebase.h"
 #include "ecbuf.h"
+#include "ememory.h"
 #include "eerror.h"
 #include "estatic.h"
 #include "estring.h"
@@ -139,6 +144,8 @@ namespace ESocket
    DECLARE_ERROR_ADVANCED(ThreadError_UnableToOpenPipe);
    DECLARE_ERROR_ADVANCED(ThreadError_UnableToReadPipe);
    DECLARE_ERROR_ADVANCED(ThreadError_UnableToWritePipe);
+   DECLARE_ERROR_ADVANCED(ThreadError_UnableToCreateDemultiplexer);
+   DECLARE_ERROR_ADVANCED4(ThreadError_UnableToRegisterSocket);
    /// @endcond
 
    /////////////////////////////////////////////////////////////////////////////
@@ -442,6 +449,120 @@ namespace ESocket
    /////////////////////////////////////////////////////////////////////////////
    /////////////////////////////////////////////////////////////////////////////
 
+   /// @brief Defines the available socket event demultiplexer implementations.
+   enum class DemuxType
+   {
+      /// select() based, limited to FD_SETSIZE file descriptors
+      Select,
+      /// edge triggered epoll() based
+      Epoll
+   };
+
+   /// @brief The socket event demultiplexer interface used by ESocket::Thread
+   ///   to wait for socket events.
+   class EventDemultiplexer
+   {
+   public:
+      /// @brief The event flags reported by wait().
+      enum : Int
+      {
+         /// the file descriptor is readable (or the peer hung up)
+         EventRead = 0x01,
+         /// the file descriptor is writable
+         EventWrite = 0x02,
+         /// an error is pending on the file descriptor
+         EventError = 0x04
+      };
+
+      /// @brief A file descriptor that has one or more pending events.
+      struct Event
+      {
+         Int fd;
+         Int events;
+      };
+
+      /// @brief Class destructor.
+      virtual ~EventDemultiplexer() {}
+
+      /// @brief Retrieves the demultiplexer type.
+      /// @return the demultiplexer type.
+      virtual DemuxType getType() const = 0;
+      /// @brief Retrieves the demultiplexer name.
+      /// @return the demultiplexer name.
+      virtual cpStr getName() const = 0;
+      /// @brief Adds a file descriptor with read interest.
+      /// @param fd the file descriptor to add.
+      /// @throws ThreadError_UnableToRegisterSocket unable to add the file descriptor.
+      virtual Void add(Int fd) = 0;
+      /// @brief Removes a file descriptor.
+      /// @param fd the file descriptor to remove.
+      virtual Void remove(Int fd) = 0;
+      /// @brief Enables or disables write interest for a previously added file descriptor.
+      /// @param fd the file descriptor.
+      /// @param enable True to report write events, False to stop reporting them.
+      /// @return True if the interest was updated, otherwise False.
+      virtual Bool setWriteInterest(Int fd, Bool enable) = 0;
+      /// @brief Waits for events.
+      /// @param events the array to populate with the pending events.
+      /// @param maxEvents the number of entries in the events array.
+      /// @param timeout the maximum time to wait in milliseconds, -1 waits indefinitely.
+      /// @return the number of entries populated or -1 with errno set if an error occurred.
+      virtual Int wait(Event *events, Int maxEvents, Int timeout) = 0;
+
+      /// @brief Creates a demultiplexer of the requested type.
+      /// @param type the requested demultiplexer type.
+      /// @return the new demultiplexer.  If an epoll instance cannot be
+      ///   created, a select() demultiplexer is returned instead.
+      static EventDemultiplexer *create(DemuxType type);
+   };
+
+   /// @brief A level triggered select() based event demultiplexer.
+   class SelectDemultiplexer : public EventDemultiplexer
+   {
+   public:
+      /// @brief Default constructor.
+      SelectDemultiplexer();
+
+      DemuxType getType() const { return DemuxType::Select; }
+      cpStr getName() const { return "select"; }
+      Void add(Int fd);
+      Void remove(Int fd);
+      Bool setWriteInterest(Int fd, Bool enable);
+      Int wait(Event *events, Int maxEvents, Int timeout);
+
+   private:
+      EMutexPrivate m_mutex;
+      fd_set m_read;
+      fd_set m_write;
+      Int m_maxfd;
+   };
+
+   /// @brief An edge triggered epoll() based event demultiplexer.
+   class EpollDemultiplexer : public EventDemultiplexer
+   {
+   public:
+      /// @brief Default constructor.
+      /// @throws ThreadError_UnableToCreateDemultiplexer unable to create the epoll instance.
+      EpollDemultiplexer();
+      /// @brief Class destructor.
+      ~EpollDemultiplexer();
+
+      DemuxType getType() const { return DemuxType::Epoll; }
+      cpStr getName() const { return "epoll"; }
+      Void add(Int fd);
+      Void remove(Int fd);
+      Bool setWriteInterest(Int fd, Bool enable);
+      Int wait(Event *events, Int maxEvents, Int timeout);
+
+   private:
+      enum { MaxEvents = 256 };
+      Int m_epfd;
+      struct epoll_event m_events[MaxEvents];
+   };
+
+   /////////////////////////////////////////////////////////////////////////////
+   /////////////////////////////////////////////////////////////////////////////
+
    /// @brief The base socket class.
    template <class TQueue, class TMessage>
    class Base
@@ -554,7 +675,8 @@ namespace ESocket
          m_type( type ),
          m_protocol( protocol ),
          m_error( 0 ),
-         m_handle( EPC_INVALID_SOCKET )
+         m_handle( EPC_INVALID_SOCKET ),
+         m_wrinterest( False )
       {
       }
       
@@ -584,6 +706,11 @@ namespace ESocket
          m_error = error;
       }
 
+      Void setWriteInterest(Bool enable)
+      {
+         getThread().setWriteInterest(this, enable);
+      }
+
       Void setHandle(Int handle)
       {
          disconnect();
@@ -660,6 +787,7 @@ namespace ESocket
       Int m_error;
 
       Int m_handle;
+      Bool m_wrinterest;
    };
 
    /////////////////////////////////////////////////////////////////////////////
@@ -791,7 +919,7 @@ namespace ESocket
 
                setState( SocketState::Connecting );
 
-               this->getThread().bump();
+               this->setWriteInterest(True);
             }
          }
          /// @brief Initiates an IP connection.
@@ -941,15 +1069,36 @@ namespace ESocket
 
          Void send(Bool override = False)
          {
-            UChar buf[2048];
-
+            // when processing a write event, wait for the lock instead of
+            //   returning if another thread is sending, since the edge
+            //   triggered event would otherwise be lost leaving the queued
+            //   data unsent
             EMutexLock lck(m_sendmtx, False);
-            if (!lck.acquire(False))
+            if (!lck.acquire(override))
                return;
 
             if (!override && m_sending)
                return;
 
+            // write interest is only armed while data remains queued
+            try
+            {
+               flush();
+            }
+            catch (...)
+            {
+               this->setWriteInterest(m_sending);
+               throw;
+            }
+            this->setWriteInterest(m_sending);
+         }
+         /// @endcond
+
+      private:
+         Void flush()
+         {
+            UChar buf[2048];
+
             if (m_wbuf.isEmpty())
             {
                m_sending = false;
@@ -1018,9 +1167,7 @@ namespace ESocket
                }
             }
          }
-         /// @endcond
 
-      private:
          Int send(pUChar pData, Int length)
          {
             Int result = ::send(this->getHandle(), (PSNDRCVBUFFER)pData, length, MSG_NOSIGNAL);
@@ -1233,7 +1380,10 @@ namespace ESocket
            m_rbuf(bufsize),
            m_wbuf(bufsize),
            m_rcvmsg(NULL),
-           m_sndmsg(NULL)
+           m_sndmsg(NULL),
+           m_batch(NULL),
+           m_reuseport(0),
+           m_sendDropped(0)
       {
          m_rcvmsg = reinterpret_cast<UDPMessage*>(new UChar[sizeof(UDPMessage) + UPD_MAX_MSG_LENGTH]);
          m_sndmsg = reinterpret_cast<UDPMessage*>(new UChar[sizeof(UDPMessage) + UPD_MAX_MSG_LENGTH]);
@@ -1248,7 +1398,10 @@ namespace ESocket
            m_rbuf(bufsize),
            m_wbuf(bufsize),
            m_rcvmsg(NULL),
-           m_sndmsg(NULL)
+           m_sndmsg(NULL),
+           m_batch(NULL),
+           m_reuseport(0),
+           m_sendDropped(0)
       {
          m_local = port;
          this->setFamily( m_local.getFamily() == Family::INET ? AF_INET : AF_INET6 );
@@ -1267,7 +1420,10 @@ namespace ESocket
            m_rbuf(bufsize),
            m_wbuf(bufsize),
            m_rcvmsg(NULL),
-           m_sndmsg(NULL)
+           m_sndmsg(NULL),
+           m_batch(NULL),
+           m_reuseport(0),
+           m_sendDropped(0)
       {
          m_local.setAddress( ipaddr, port );
          this->setFamily( m_local.getFamily() == Family::INET ? AF_INET : AF_INET6 );
@@ -1285,7 +1441,10 @@ namespace ESocket
            m_rbuf(bufsize),
            m_wbuf(bufsize),
            m_rcvmsg(NULL),
-           m_sndmsg(NULL)
+           m_sndmsg(NULL),
+           m_batch(NULL),
+           m_reuseport(0),
+           m_sendDropped(0)
       {
          m_local = addr;
          this->setFamily( m_local.getFamily() == Family::INET ? AF_INET : AF_INET6 );
@@ -1296,10 +1455,13 @@ namespace ESocket
       /// @brief Class destructor.
       virtual ~UDP()
       {
+         releaseBuffers();
          if (m_rcvmsg)
             delete [] reinterpret_cast<pUChar>(m_rcvmsg);
          if (m_sndmsg)
             delete [] reinterpret_cast<pUChar>(m_sndmsg);
+         if (m_batch)
+            delete m_batch;
       }
       /// @brief Retrieves the local address for this socket.
       /// @return the local address for this socket.
@@ -1356,6 +1518,8 @@ namespace ESocket
          msg.data_length = len;
          msg.local = from;
          msg.remote = to;
+         msg.buffer = NULL;
+         msg.external = NULL;
 
          {
             EMutexLock l(m_wbuf.getMutex());
@@ -1363,7 +1527,47 @@ namespace ESocket
             m_wbuf.writeData(src, 0, len, True);
          }
 
-         send();
+         startSending();
+      }
+      /// @brief Sends the contents of a pooled buffer to the specified
+      ///   recipient address without copying the data.
+      /// @details The socket holds a reference to the buffer until the
+      ///   datagram has been sent, so the same buffer can be written again,
+      ///   for example to retransmit a request, as long as it is not
+      ///   modified.
+      /// @param to the address to send the data to.
+      /// @param buf the buffer containing the data to send.
+      Void write(const Address &to, const EMemory::Buffer &buf)
+      {
+         write(Address(), to, buf);
+      }
+      /// @brief Sends the contents of a pooled buffer to the specified
+      ///   recipient address without copying the data.
+      /// @param from the address the data is sent from.
+      /// @param to the address to send the data to.
+      /// @param buf the buffer containing the data to send.
+      Void write(const Address &from, const Address &to, const EMemory::Buffer &buf)
+      {
+         UDPMessage msg;
+         msg.total_length = sizeof(msg);
+         msg.data_length = buf.length();
+         msg.local = from;
+         msg.remote = to;
+         msg.external = buf.data();
+         msg.buffer = EMemory::Buffer(buf).detach();
+
+         try
+         {
+            EMutexLock l(m_wbuf.getMutex());
+            m_wbuf.writeData(reinterpret_cast<cpUChar>(&msg), 0, sizeof(msg), True);
+         }
+         catch (...)
+         {
+            EMemory::Buffer::attach(msg.buffer);
+            throw;
+         }
+
+         startSending();
       }
       /// @brief Retrieves indication if this socket is in the process of sending data.
       /// @return True indicates that data is being sent, otherwise False.
@@ -1371,6 +1575,98 @@ namespace ESocket
       {
          return m_sending;
       }
+      /// @brief Enables batched I/O, where up to count datagrams are received
+      ///   with a single recvmmsg() and queued writes are flushed with
+      ///   sendmmsg().  Received datagrams are delivered to onReceive() straight
+      ///   from the batch buffers instead of being staged in the receive
+      ///   circular buffer.  This method should be called before any data is
+      ///   sent or received.
+      /// @param count the maximum number of datagrams per system call, a value
+      ///   less than 2 disables batched I/O unless a buffer pool is supplied.
+      /// @param slotSize the size of each receive buffer, larger datagrams are
+      ///   discarded.
+      /// @param pool optional buffer pool.  When supplied, datagrams are
+      ///   received directly into pooled buffers and delivered to
+      ///   onReceiveBuffer(), allowing the receiver to retain the buffer
+      ///   without copying the data.  The pool must outlive this socket.
+      /// @return a reference to this object.
+      UDP &setBatchSize(Int count, Int slotSize = UPD_MAX_MSG_LENGTH, EMemory::BufferPool *pool = NULL)
+      {
+         EMutexLock l(m_sendmtx);
+         if (m_batch)
+         {
+            delete m_batch;
+            m_batch = NULL;
+         }
+         slotSize = std::min(std::max(slotSize, 1), UPD_MAX_MSG_LENGTH);
+         if (pool)
+            slotSize = std::min(slotSize, (Int)pool->bufferSize());
+         if (count > 1 || pool)
+            m_batch = new Batch(std::max(count, 1), slotSize, pool);
+         return *this;
+      }
+      /// @brief Retrieves the maximum number of datagrams per system call.
+      /// @return the maximum number of datagrams per system call, 1 indicates
+      ///   that batched I/O is disabled.
+      Int getBatchSize()
+      {
+         return m_batch ? m_batch->count : 1;
+      }
+      /// @brief Indicates if datagrams are received with recvmmsg().
+      /// @return True if batched I/O is enabled, otherwise False.
+      Bool getBatched()
+      {
+         return m_batch != NULL;
+      }
+      /// @brief Enables SO_REUSEPORT so that several sockets can be bound to
+      ///   the same local address and port.  When groupSize is greater than
+      ///   1, a classic BPF program is attached that selects the socket in
+      ///   the group using reusePortIndex() on the sender's IP address, so
+      ///   datagrams from a given peer are always delivered to the same
+      ///   socket.  The sockets in the group must be bound in index order.
+      ///   This method must be called before the socket is bound.
+      /// @param groupSize the number of sockets in the group, a value less
+      ///   than 1 disables SO_REUSEPORT.
+      /// @return a reference to this object.
+      UDP &setReusePort(Int groupSize)
+      {
+         if (this->getHandle() != EPC_INVALID_SOCKET)
+            throw UdpError_AlreadyBound();
+         m_reuseport = groupSize > 0 ? groupSize : 0;
+         return *this;
+      }
+      /// @brief Retrieves the SO_REUSEPORT group size.
+      /// @return the SO_REUSEPORT group size, 0 indicates that SO_REUSEPORT
+      ///   is not enabled.
+      Int getReusePort()
+      {
+         return m_reuseport;
+      }
+      /// @brief Retrieves the number of queued datagrams that were discarded
+      ///   because they were larger than the socket allows (EMSGSIZE).
+      /// @return the number of discarded datagrams.
+      ULongLong getSendDropped()
+      {
+         return m_sendDropped.load(std::memory_order_relaxed);
+      }
+      /// @brief Calculates the index of the socket in a SO_REUSEPORT group
+      ///   that receives the datagrams sent from the specified address.  The
+      ///   index is the low order 32 bits of the IP address modulo the
+      ///   group size.
+      /// @param addr the address of the sender.
+      /// @param groupSize the number of sockets in the group.
+      /// @return the index of the socket.
+      static Int reusePortIndex(const Address &addr, Int groupSize)
+      {
+         if (groupSize <= 1)
+            return 0;
+         UInt low;
+         if (addr.getFamily() == Family::INET6)
+            std::memcpy(&low, &addr.getInet6().sin6_addr.s6_addr[12], sizeof(low));
+         else
+            low = addr.getInet().sin_addr.s_addr;
+         return static_cast<Int>(ntohl(low) % static_cast<UInt>(groupSize));
+      }
       /// @brief Binds this socket to a local port and IPADDR_ANY.
       /// @param port the port.
       Void bind(UShort port)
@@ -1416,6 +1712,18 @@ namespace ESocket
       virtual Void onReceive(const Address &from, const Address &to, cpUChar msg, Int len)
       {
       }
+      /// @brief Called for each message that is received into a pooled
+      ///   buffer (see setBatchSize()).  The default implementation calls
+      ///   onReceive().  An override may keep a copy of the buffer handle, in
+      ///   which case the socket replaces the buffer with a new one from the
+      ///   pool.
+      /// @param from the socket address that the data was received from.
+      /// @param to the socket address that the message was sent to.
+      /// @param buf the buffer containing the received data.
+      virtual Void onReceiveBuffer(const Address &from, const Address &to, EMemory::Buffer &buf)
+      {
+         onReceive(from, to, buf.data(), static_cast<Int>(buf.length()));
+      }
       /// @brief Called when an error is detected on this socket.
       virtual Void onError()
       {
@@ -1430,13 +1738,6 @@ namespace ESocket
 
       Int recv()
       {
-         union ControlData
-         {
-            struct cmsghdr header;
-            struct in_pktinfo pktinfo;
-            struct in6_pktinfo pktinfo6;
-         };
-
          Int totalReceived = 0;
          Address local;
          Address remote;
@@ -1465,36 +1766,10 @@ namespace ESocket
             {
                m_rcvmsg->total_length = sizeof(UDPMessage) + amtReceived;
                m_rcvmsg->data_length = amtReceived;
-               m_rcvmsg->local = getLocal();
+               m_rcvmsg->external = NULL;
+               m_rcvmsg->buffer = NULL;
                m_rcvmsg->remote = remote;
-
-               for (struct cmsghdr *cp = CMSG_FIRSTHDR(&mh); cp != NULL; cp = CMSG_NXTHDR(&mh,cp))
-               {
-                  if (cp->cmsg_level == IPPROTO_IP && cp->cmsg_type == IP_PKTINFO)
-                  {
-                     struct in_pktinfo *p = (struct in_pktinfo *)CMSG_DATA(cp);
-                     sockaddr_in ipv4;
-                     std::memset(&ipv4, 0, sizeof(ipv4));
-                     ipv4.sin_family = AF_INET;
-                     ipv4.sin_port = ((struct sockaddr_in&)getLocal().getStorage()).sin_port;
-                     ipv4.sin_addr.s_addr = p->ipi_spec_dst.s_addr;
-                     m_rcvmsg->local = ipv4;
-                     break;
-                  }
-                  if (cp->cmsg_level == IPPROTO_IPV6 && cp->cmsg_type == IPV6_PKTINFO)
-                  {
-                     struct in6_pktinfo *p = (struct in6_pktinfo *)CMSG_DATA(cp);
-                     sockaddr_in6 ipv6;
-                     std::memset(&ipv6, 0, sizeof(ipv6));
-                     ipv6.sin6_family = AF_INET6;
-                     ipv6.sin6_port = ((struct sockaddr_in6&)getLocal().getStorage()).sin6_port;
-                     ipv6.sin6_flowinfo = 0;
-                     ipv6.sin6_scope_id = 0;
-                     ipv6.sin6_addr = p->ipi6_addr;
-                     m_rcvmsg->local = ipv6;
-                     break;
-                  }
-               }
+               getPacketInfo(mh, m_rcvmsg->local);
 
                m_rbuf.writeData( reinterpret_cast<pUChar>(m_rcvmsg), 0, m_rcvmsg->total_length);
                totalReceived += amtReceived;
@@ -1511,21 +1786,88 @@ namespace ESocket
          return totalReceived;
       }
 
+      Int recvBatch()
+      {
+         Batch &b = *m_batch;
+
+         for (Int i = 0; i < b.count; i++)
+         {
+            b.rmsgs[i].msg_hdr.msg_namelen = sizeof(b.raddrs[i].getStorage());
+            b.rmsgs[i].msg_hdr.msg_controllen = Batch::ControlSize;
+            b.rmsgs[i].msg_hdr.msg_flags = 0;
+            b.rmsgs[i].msg_len = 0;
+         }
+
+         Int cnt = ::recvmmsg(this->getHandle(), b.rmsgs, b.count, 0, NULL);
+         if (cnt == -1)
+         {
+            this->setError();
+            if (this->getError() == EWOULDBLOCK)
+               return 0;
+            throw UdpError_UnableToRecvData();
+         }
+
+         return cnt;
+      }
+
       Void send(Bool override = False)
       {
+         // the socket thread waits for the lock when processing a write event,
+         //   a writer holding it in startSending() only arms write interest and
+         //   the edge triggered event would otherwise be lost leaving the
+         //   queued datagrams unsent
          EMutexLock lck(m_sendmtx, False);
-         if (!lck.acquire(False))
+         if (!lck.acquire(override))
             return;
 
          if (!override && m_sending)
             return;
 
+         // write interest is only armed while data remains queued
+         try
+         {
+            flush();
+         }
+         catch (...)
+         {
+            this->setWriteInterest(m_sending);
+            throw;
+         }
+         this->setWriteInterest(m_sending);
+      }
+
+      Void startSending()
+      {
+         if (m_batch)
+         {
+            // the queued datagrams are sent together with sendmmsg() when
+            // the socket thread processes the resulting write event
+            EMutexLock lck(m_sendmtx);
+            if (!m_sending)
+            {
+               m_sending = True;
+               this->setWriteInterest(True);
+            }
+            return;
+         }
+
+         send();
+      }
+
+      Void flush()
+      {
          if (m_wbuf.isEmpty())
          {
             m_sending = false;
             return;
          }
 
+         if (m_batch)
+         {
+            flushBatch();
+            return;
+         }
+
          m_sending = true;
          while (true)
          {
@@ -1552,13 +1894,109 @@ namespace ESocket
                throw UdpError_ReadingWritePacketLength(msg.c_str());
             }
 
-            if (send(m_sndmsg->local, m_sndmsg->remote, m_sndmsg->data, m_sndmsg->data_length) == -1)
+            if (send(m_sndmsg->local, m_sndmsg->remote, m_sndmsg->external ? const_cast<pUChar>(m_sndmsg->external) : m_sndmsg->data, m_sndmsg->data_length) == -1)
             {
+               // the message can never be sent, discard it so that it does
+               //   not block the messages queued behind it
+               if (this->getError() == EMSGSIZE)
+               {
+                  m_sendDropped.fetch_add(1, std::memory_order_relaxed);
+                  m_wbuf.readData(NULL, 0, m_sndmsg->total_length);
+                  releaseBuffer(m_sndmsg->buffer);
+                  continue;
+               }
                // unable to send this message so get out, it will be sent when the socket is ready for writing
                break;
             }
 
             m_wbuf.readData(NULL, 0, m_sndmsg->total_length);
+            releaseBuffer(m_sndmsg->buffer);
+         }
+      }
+
+      Void flushBatch()
+      {
+         Batch &b = *m_batch;
+
+         m_sending = true;
+         while (true)
+         {
+            if (m_wbuf.isEmpty())
+            {
+               m_sending = false;
+               break;
+            }
+
+            // copy as many complete messages as will fit into the staging area
+            Int amtRead = m_wbuf.peekData(b.sdata, 0, b.sdatasize);
+            Int offset = 0;
+            Int cnt = 0;
+            while (cnt < b.count && amtRead - offset >= (Int)sizeof(UDPMessage))
+            {
+               UDPMessage *msg = reinterpret_cast<UDPMessage*>(&b.sdata[offset]);
+               if ((Int)msg->total_length > amtRead - offset)
+                  break;
+               b.siovs[cnt].iov_base = msg->external ? const_cast<pUChar>(msg->external) : msg->data;
+               b.siovs[cnt].iov_len = msg->data_length;
+               b.sbufs[cnt] = msg->buffer;
+               b.smsgs[cnt].msg_hdr.msg_name = msg->remote.getSockAddr();
+               b.smsgs[cnt].msg_hdr.msg_namelen = msg->remote.getSockAddrLen();
+               b.sizes[cnt] = msg->total_length;
+               offset += msg->total_length;
+               cnt++;
+            }
+
+            if (cnt == 0)
+            {
+               EString msg;
+               msg.format("unable to stage a complete message, read %d bytes", amtRead);
+               throw UdpError_ReadingWritePacketLength(msg.c_str());
+            }
+
+            Int sent = ::sendmmsg(this->getHandle(), b.smsgs, cnt, MSG_NOSIGNAL);
+            if (sent == -1)
+            {
+               this->setError();
+               if (this->getError() == EMSGSIZE)
+               {
+                  // the first message can never be sent, discard it so that
+                  //   it does not block the messages queued behind it
+                  m_sendDropped.fetch_add(1, std::memory_order_relaxed);
+                  m_wbuf.readData(NULL, 0, b.sizes[0]);
+                  releaseBuffer(b.sbufs[0]);
+                  continue;
+               }
+               if (this->getError() != EWOULDBLOCK)
+                  throw UdpError_SendingPacket();
+               // unable to send this message so get out, it will be sent when the socket is ready for writing
+               break;
+            }
+
+            Int consumed = 0;
+            for (Int i = 0; i < sent; i++)
+            {
+               consumed += b.sizes[i];
+               releaseBuffer(b.sbufs[i]);
+            }
+            m_wbuf.readData(NULL, 0, consumed);
+         }
+      }
+
+      Void releaseBuffer(pVoid buffer)
+      {
+         // the reference held while a pooled buffer was queued
+         if (buffer)
+            EMemory::Buffer::attach(buffer);
+      }
+
+      Void releaseBuffers()
+      {
+         // release the pooled buffers that were queued but never sent
+         UDPMessage msg;
+         while (m_wbuf.peekData(reinterpret_cast<pUChar>(&msg), 0, sizeof(msg)) == (Int)sizeof(msg))
+         {
+            m_wbuf.readData(NULL, 0, msg.total_length);
+            releaseBuffer(msg.buffer);
          }
       }
       /// @endcond
@@ -1571,10 +2009,98 @@ namespace ESocket
          size_t data_length;
          Address local;
          Address remote;
+         cpUChar external;
+         pVoid buffer;
          UChar data[0];
       };
       #pragma pack(pop)
 
+      union ControlData
+      {
+         struct cmsghdr header;
+         struct in_pktinfo pktinfo;
+         struct in6_pktinfo pktinfo6;
+      };
+
+      struct Batch
+      {
+         enum { ControlSize = CMSG_SPACE(sizeof(ControlData)) };
+
+         Batch(Int cnt, Int slot, EMemory::BufferPool *bp)
+            : count(cnt),
+              slotSize(slot),
+              sdatasize(std::max(cnt * (Int)(sizeof(UDPMessage) + slot), (Int)sizeof(UDPMessage) + UPD_MAX_MSG_LENGTH))
+         {
+            rmsgs = new struct mmsghdr[count];
+            riovs = new struct iovec[count];
+            raddrs = new Address[count];
+            rdata = bp ? NULL : new UChar[count * slotSize];
+            rbufs = bp ? new EMemory::Buffer[count] : NULL;
+            pool = bp;
+            rcontrol = new UChar[count * ControlSize];
+            smsgs = new struct mmsghdr[count];
+            siovs = new struct iovec[count];
+            sizes = new Int[count];
+            sbufs = new pVoid[count];
+            sdata = new UChar[sdatasize];
+
+            std::memset(rmsgs, 0, sizeof(struct mmsghdr) * count);
+            std::memset(smsgs, 0, sizeof(struct mmsghdr) * count);
+            for (Int i = 0; i < count; i++)
+            {
+               if (pool)
+               {
+                  rbufs[i] = pool->allocate();
+                  riovs[i].iov_base = rbufs[i].data();
+               }
+               else
+               {
+                  riovs[i].iov_base = &rdata[i * slotSize];
+               }
+               riovs[i].iov_len = slotSize;
+               rmsgs[i].msg_hdr.msg_iov = &riovs[i];
+               rmsgs[i].msg_hdr.msg_iovlen = 1;
+               rmsgs[i].msg_hdr.msg_name = (pVoid)&raddrs[i].getStorage();
+               rmsgs[i].msg_hdr.msg_control = &rcontrol[i * ControlSize];
+               smsgs[i].msg_hdr.msg_iov = &siovs[i];
+               smsgs[i].msg_hdr.msg_iovlen = 1;
+            }
+         }
+
+         ~Batch()
+         {
+            delete [] rmsgs;
+            delete [] riovs;
+            delete [] raddrs;
+            if (rdata)
+               delete [] rdata;
+            if (rbufs)
+               delete [] rbufs;
+            delete [] rcontrol;
+            delete [] smsgs;
+            delete [] siovs;
+            delete [] sizes;
+            delete [] sbufs;
+            delete [] sdata;
+         }
+
+         Int count;
+         Int slotSize;
+         Int sdatasize;
+         struct mmsghdr *rmsgs;
+         struct iovec *riovs;
+         Address *raddrs;
+         pUChar rdata;
+         EMemory::Buffer *rbufs;
+         EMemory::BufferPool *pool;
+         pUChar rcontrol;
+         struct mmsghdr *smsgs;
+         struct iovec *siovs;
+         Int *sizes;
+         pVoid *sbufs;
+         pUChar sdata;
+      };
+
       Void onConnect()
       {
       }
@@ -1591,6 +2117,67 @@ namespace ESocket
          }
       }
 
+      Void onReceiveBatch(Int cnt)
+      {
+         Batch &b = *m_batch;
+         Address local;
+
+         for (Int i = 0; i < cnt; i++)
+         {
+            if (b.rmsgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+               continue;
+            getPacketInfo(b.rmsgs[i].msg_hdr, local);
+            if (b.pool)
+            {
+               b.rbufs[i].setLength(b.rmsgs[i].msg_len);
+               onReceiveBuffer(b.raddrs[i], local, b.rbufs[i]);
+               // the receiver kept a reference, receive into a new buffer
+               if (!b.rbufs[i].unique())
+               {
+                  b.rbufs[i] = b.pool->allocate();
+                  b.riovs[i].iov_base = b.rbufs[i].data();
+               }
+            }
+            else
+            {
+               onReceive(b.raddrs[i], local, &b.rdata[i * b.slotSize], b.rmsgs[i].msg_len);
+            }
+         }
+      }
+
+      Void getPacketInfo(struct msghdr &mh, Address &local)
+      {
+         local = getLocal();
+
+         for (struct cmsghdr *cp = CMSG_FIRSTHDR(&mh); cp != NULL; cp = CMSG_NXTHDR(&mh,cp))
+         {
+            if (cp->cmsg_level == IPPROTO_IP && cp->cmsg_type == IP_PKTINFO)
+            {
+               struct in_pktinfo *p = (struct in_pktinfo *)CMSG_DATA(cp);
+               sockaddr_in ipv4;
+               std::memset(&ipv4, 0, sizeof(ipv4));
+               ipv4.sin_family = AF_INET;
+               ipv4.sin_port = ((struct sockaddr_in&)getLocal().getStorage()).sin_port;
+               ipv4.sin_addr.s_addr = p->ipi_spec_dst.s_addr;
+               local = ipv4;
+               break;
+            }
+            if (cp->cmsg_level == IPPROTO_IPV6 && cp->cmsg_type == IPV6_PKTINFO)
+            {
+               struct in6_pktinfo *p = (struct in6_pktinfo *)CMSG_DATA(cp);
+               sockaddr_in6 ipv6;
+               std::memset(&ipv6, 0, sizeof(ipv6));
+               ipv6.sin6_family = AF_INET6;
+               ipv6.sin6_port = ((struct sockaddr_in6&)getLocal().getStorage()).sin6_port;
+               ipv6.sin6_flowinfo = 0;
+               ipv6.sin6_scope_id = 0;
+               ipv6.sin6_addr = p->ipi6_addr;
+               local = ipv6;
+               break;
+            }
+         }
+      }
+
       Void bind()
       {
          if (this->getHandle() != EPC_INVALID_SOCKET)
@@ -1600,6 +2187,17 @@ namespace ESocket
 
          int result;
          int sockopt = 1;
+         if (m_reuseport > 0)
+         {
+            result = setsockopt(this->getHandle(), SOL_SOCKET, SO_REUSEPORT, &sockopt, sizeof(sockopt));
+            if (result == -1)
+            {
+               UdpError_UnableToBindSocket err;
+               err.appendTextf(" - SO_REUSEPORT %s:%u", getLocal().getAddress().c_str(), getLocal().getPort());
+               this->close();
+               throw err;
+            }
+         }
          result = setsockopt(this->getHandle(), IPPROTO_IP, IP_PKTINFO, &sockopt, sizeof(sockopt));
          if (result == -1)
          {
@@ -1628,6 +2226,35 @@ namespace ESocket
             this->close();
             throw err;
          }
+
+         // the steering program is attached after the bind, attaching it to
+         // an unbound socket prevents the socket from joining the group
+         if (m_reuseport > 1)
+         {
+            // select the socket using the low order 32 bits of the source
+            // address from the IPv4 or IPv6 header, see reusePortIndex()
+            struct sock_filter code[] =
+            {
+               { BPF_LD  | BPF_B   | BPF_ABS, 0, 0, static_cast<UInt>(SKF_NET_OFF) },
+               { BPF_ALU | BPF_RSH | BPF_K,   0, 0, 4 },
+               { BPF_JMP | BPF_JEQ | BPF_K,   0, 2, 4 },
+               { BPF_LD  | BPF_W   | BPF_ABS, 0, 0, static_cast<UInt>(SKF_NET_OFF + 12) },
+               { BPF_JMP | BPF_JA,            0, 0, 1 },
+               { BPF_LD  | BPF_W   | BPF_ABS, 0, 0, static_cast<UInt>(SKF_NET_OFF + 20) },
+               { BPF_ALU | BPF_MOD | BPF_K,   0, 0, static_cast<UInt>(m_reuseport) },
+               { BPF_RET | BPF_A,             0, 0, 0 }
+            };
+            struct sock_fprog prog = { sizeof(code) / sizeof(code[0]), code };
+
+            result = setsockopt(this->getHandle(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog));
+            if (result == -1)
+            {
+               UdpError_UnableToBindSocket err;
+               err.appendTextf(" - SO_ATTACH_REUSEPORT_CBPF %s:%u", getLocal().getAddress().c_str(), getLocal().getPort());
+               this->close();
+               throw err;
+            }
+         }
       }
 
       Bool readMessage(UDPMessage &msg)
@@ -1649,7 +2276,7 @@ namespace ESocket
          if (result == -1)
          {
             this->setError();
-            if (this->getError() != EMSGSIZE)
+            if (this->getError() != EMSGSIZE && this->getError() != EWOULDBLOCK)
                throw UdpError_SendingPacket();
          }
 
@@ -1664,6 +2291,9 @@ namespace ESocket
       ECircularBuffer m_wbuf;
       UDPMessage *m_rcvmsg;
       UDPMessage *m_sndmsg;
+      Batch *m_batch;
+      Int m_reuseport;
+      std::atomic<ULongLong> m_sendDropped;
    };
 
    /////////////////////////////////////////////////////////////////////////////
@@ -1678,8 +2308,10 @@ namespace ESocket
       friend class UDP<TQueue,TMessage>;
 
    public:
-      /// @brief Default constructor.
-      Thread()
+      /// @brief Class constructor.
+      /// @param demux the type of event demultiplexer used to wait for socket events.
+      Thread(DemuxType demux = DemuxType::Epoll)
+         : m_demux(NULL)
       {
          int *pipefd = this->getBumpPipe();
 
@@ -1690,9 +2322,8 @@ namespace ESocket
             throw ThreadError_UnableToOpenPipe();
          fcntl(pipefd[0], F_SETFL, O_NONBLOCK);
 
-         FD_ZERO(&m_master);
-
-         getMaxFileDescriptor(True);
+         m_demux = EventDemultiplexer::create(demux);
+         m_demux->add(pipefd[0]);
       }
       /// @brief Class destructor.
       virtual ~Thread()
@@ -1700,15 +2331,27 @@ namespace ESocket
          int *pipefd = this->getBumpPipe();
          close(pipefd[0]);
          close(pipefd[1]);
+         delete m_demux;
       }
       /// @brief Called by the framework to register a Base derived socket object with this thread.
       /// @param socket the socket to register.
       Void registerSocket(Base<TQueue,TMessage>* socket)
       {
-         m_socketmap.insert(std::make_pair(socket->getHandle(), socket));
-         FD_SET(socket->getHandle(), &m_master);
-         getMaxFileDescriptor(True);
-         bump();
+         if (m_socketmap.insert(std::make_pair(socket->getHandle(), socket)).second)
+         {
+            try
+            {
+               m_demux->add(socket->getHandle());
+            }
+            catch (...)
+            {
+               m_socketmap.erase(socket->getHandle());
+               throw;
+            }
+            socket->m_wrinterest = False;
+            if (m_demux->getType() == DemuxType::Select)
+               bump();
+         }
       }
       /// @brief Called by the framework to unregister a Base derived socket object with this thread.
       /// @param socket the socket to unregister.
@@ -1716,11 +2359,33 @@ namespace ESocket
       {
          if (m_socketmap.erase(socket->getHandle()))
          {
-            FD_CLR(socket->getHandle(), &m_master);
-            getMaxFileDescriptor(True);
-            bump();
+            m_demux->remove(socket->getHandle());
+            socket->m_wrinterest = False;
+            if (m_demux->getType() == DemuxType::Select)
+               bump();
+         }
+      }
+      /// @brief Called by the framework to arm or disarm write event notification for a socket.
+      /// @param socket the socket.
+      /// @param enable True to be notified when the socket is writable, otherwise False.
+      Void setWriteInterest(Base<TQueue,TMessage>* socket, Bool enable)
+      {
+         if (socket->m_wrinterest == enable || socket->getHandle() == EPC_INVALID_SOCKET)
+            return;
+         if (m_demux->setWriteInterest(socket->getHandle(), enable))
+         {
+            socket->m_wrinterest = enable;
+            // select() only picks up the new interest the next time around the loop
+            if (enable && m_demux->getType() == DemuxType::Select)
+               bump();
          }
       }
+      /// @brief Retrieves the type of event demultiplexer in use.
+      /// @return the type of event demultiplexer in use.
+      DemuxType getDemuxType() const { return m_demux->getType(); }
+      /// @brief Retrieves the name of the event demultiplexer in use.
+      /// @return the name of the event demultiplexer in use.
+      cpStr getDemuxName() const { return m_demux->getName(); }
       /// @brief Called when an error is detected.
       Int getError() { return m_error; }
 
@@ -1728,37 +2393,18 @@ namespace ESocket
       /// @cond DOXYGEN_EXCLUDE
       virtual Void pumpMessages()
       {
-         int maxfd, fd, fdcnt;
-         fd_set readworking, writeworking, errorworking;
+         EventDemultiplexer::Event events[MaxEvents];
+         Int evcnt, bumpfd = this->getBumpPipe()[0];
+         Bool keepGoing = True;
 
          onInit();
 
-         while (true)
+         while (keepGoing)
          {
-            {
-               memcpy(&readworking, &m_master, sizeof(m_master));
-               FD_SET(this->getBumpPipe()[0], &readworking);
-
-               FD_ZERO(&writeworking);
-               for (auto it = m_socketmap.begin(); it != m_socketmap.end(); it++)
-               {
-                  Base<TQueue,TMessage> *pSocket = it->second;
-                  if ((pSocket->getSocketType() == SocketType::TcpTalker &&
-                        ((static_cast<TCP::Talker<TQueue,TMessage>*>(pSocket))->getSending() ||
-                        (static_cast<TCP::Talker<TQueue,TMessage>*>(pSocket))->getState() == SocketState::Connecting)) ||
-                     (pSocket->getSocketType() == SocketType::Udp && (static_cast<UDP<TQueue,TMessage>*>(pSocket))->getSending()))
-                  {
-                     FD_SET(it->first, &writeworking);
-                  }
-               }
-
-               memcpy(&errorworking, &m_master, sizeof(m_master));
-
-               maxfd = getMaxFileDescriptor() + 1;
-            }
-
-            fdcnt = select(maxfd, &readworking, &writeworking, &errorworking, NULL);
-            if (fdcnt == -1)
+            // expire any event loop timers and wait no longer than the next one
+            LongLong timeout = this->dispatchTimers();
+            evcnt = m_demux->wait(events, MaxEvents, timeout < 0 ? -1 : static_cast<Int>((timeout + 999) / 1000));
+            if (evcnt == -1)
             {
                if (errno == EINTR || errno == 514 /*ERESTARTNOHAND*/)
                {
@@ -1772,22 +2418,28 @@ namespace ESocket
                continue;
             }
 
-            ////////////////////////////////////////////////////////////////////////
-            // Process any thread messages
-            ////////////////////////////////////////////////////////////////////////
-            if (FD_ISSET(this->getBumpPipe()[0], &readworking))
+            for (Int i = 0; i < evcnt && keepGoing; i++)
             {
-               --fdcnt;
-               if (!pumpMessagesInternal())
-                  break;
-            }
+               Int fd = events[i].fd;
+               Int ev = events[i].events;
 
-            ////////////////////////////////////////////////////////////////////////
-            // Process any socket messages
-            ////////////////////////////////////////////////////////////////////////
-            for (fd = 0; fd < maxfd && fdcnt > 0; fd++)
-            {
-               if (FD_ISSET(fd, &errorworking))
+               ////////////////////////////////////////////////////////////////////////
+               // Process any thread messages
+               ////////////////////////////////////////////////////////////////////////
+               if (fd == bumpfd)
+               {
+                  // drain the pipe first so that a message posted while the
+                  // queue is being processed will trigger another wakeup
+                  clearBump();
+                  keepGoing = pumpMessagesInternal();
+                  continue;
+               }
+
+               ////////////////////////////////////////////////////////////////////////
+               // Process any socket messages, the socket is looked up for each
+               //    event since a previous handler may have deleted it
+               ////////////////////////////////////////////////////////////////////////
+               if (ev & EventDemultiplexer::EventError)
                {
                   auto socket_it = m_socketmap.find(fd);
                   if (socket_it != m_socketmap.end())
@@ -1802,12 +2454,11 @@ namespace ESocket
                         processSelectError(pSocket);
                      }
                   }
-                  fdcnt--;
                }
 
                Bool result = True;
 
-               if (fdcnt > 0 && FD_ISSET(fd, &readworking))
+               if (ev & EventDemultiplexer::EventRead)
                {
                   auto socket_it = m_socketmap.find(fd);
                   if (socket_it != m_socketmap.end())
@@ -1816,10 +2467,9 @@ namespace ESocket
                      if (pSocket)
                         result = processSelectRead(pSocket);
                   }
-                  fdcnt--;
                }
 
-               if (fdcnt > 0 && FD_ISSET(fd, &writeworking))
+               if (ev & EventDemultiplexer::EventWrite)
                {
                   auto socket_it = m_socketmap.find(fd);
                   if (result && socket_it != m_socketmap.end())
@@ -1828,18 +2478,18 @@ namespace ESocket
                      if (pSocket)
                         processSelectWrite(pSocket);
                   }
-                  fdcnt--;
                }
             }
 
+            if (!keepGoing)
+               break;
+
             ////////////////////////////////////////////////////////////////////////
             // Process any thread messages that may have been posted while
             //   processing the socket events
             ////////////////////////////////////////////////////////////////////////
             if (!pumpMessagesInternal())
                break;
-
-            clearBump();
          }
 
          while (true)
@@ -1929,7 +2579,10 @@ namespace ESocket
          {
             while (True)
             {
-               if (!EThreadEvent<TQueue,TMessage>::pumpMessage(msg, false) || msg.getMessageId() == EM_QUIT)
+               Bool bMsg = this->messageBatchSize() > 1 ?
+                  EThreadEvent<TQueue,TMessage>::pumpMessageBatch(msg, false) > 0 :
+                  EThreadEvent<TQueue,TMessage>::pumpMessage(msg, false);
+               if (!bMsg || msg.getMessageId() == EM_QUIT)
                   break;
             }
          }
@@ -2030,11 +2683,13 @@ namespace ESocket
 
                      (static_cast<TCP::Talker<TQueue,TMessage>*>(psocket))->setState( SocketState::Connected );
                      (static_cast<TCP::Talker<TQueue,TMessage>*>(psocket))->setAddresses();
+                     psocket->setWriteInterest((static_cast<TCP::Talker<TQueue,TMessage>*>(psocket))->getSending());
                      (static_cast<TCP::Talker<TQueue,TMessage>*>(psocket))->onConnect();
                   }
                   catch (EError &ex)
                   {
                      (static_cast<TCP::Talker<TQueue,TMessage>*>(psocket))->setState( SocketState::Undefined );
+                     psocket->setWriteInterest(False);
                      processSelectError(psocket);
                      return False;
                   }
@@ -2076,22 +2731,53 @@ namespace ESocket
          }
          else if (psocket->getSocketType() == SocketType::Udp)
          {
-            while (true)
+            UDP<TQueue,TMessage> *pudp = static_cast<UDP<TQueue,TMessage>*>(psocket);
+
+            if (pudp->getBatched())
             {
-               try
+               // each batch is delivered as it is received, a short batch
+               // means the socket has been drained
+               while (true)
                {
-                  Int amtRead = (static_cast<UDP<TQueue,TMessage>*>(psocket))->recv();
-                  if (amtRead <= 0)
+                  Int cnt;
+                  try
+                  {
+                     cnt = pudp->recvBatch();
+                  }
+                  catch (EError &err)
+                  {
+                     errorHandler(err, psocket);
+                     continue;
+                  }
+
+                  if (cnt <= 0)
+                     break;
+
+                  pudp->onReceiveBatch(cnt);
+
+                  if (cnt < pudp->getBatchSize())
                      break;
                }
-               catch (EError &err)
+            }
+            else
+            {
+               while (true)
                {
-                  //printf("errorHandler() 2\n");
-                  errorHandler(err, psocket);
+                  try
+                  {
+                     Int amtRead = pudp->recv();
+                     if (amtRead <= 0)
+                        break;
+                  }
+                  catch (EError &err)
+                  {
+                     //printf("errorHandler() 2\n");
+                     errorHandler(err, psocket);
+                  }
                }
-            }
 
-            (reinterpret_cast<UDP<TQueue,TMessage>*>(psocket))->onReceive();
+               pudp->onReceive();
+            }
          }
 
          return True;
@@ -2123,11 +2809,13 @@ namespace ESocket
 
                      (static_cast<TCP::Talker<TQueue,TMessage>*>(psocket))->setState( SocketState::Connected );
                      (static_cast<TCP::Talker<TQueue,TMessage>*>(psocket))->setAddresses();
+                     psocket->setWriteInterest((static_cast<TCP::Talker<TQueue,TMessage>*>(psocket))->getSending());
                      (static_cast<TCP::Talker<TQueue,TMessage>*>(psocket))->onConnect();
                   }
                   catch (EError &ex)
                   {
                      (static_cast<TCP::Talker<TQueue,TMessage>*>(psocket))->setState( SocketState::Undefined );
+                     psocket->setWriteInterest(False);
                      processSelectError(psocket);
                      return;
                   }
@@ -2151,6 +2839,7 @@ namespace ESocket
                   // throw TcpTalkerError_InvalidWriteState(
                   //    (static_cast<TCP::Talker<TQueue,TMessage>*>(psocket))->getStateDescription());
                   (static_cast<TCP::Talker<TQueue,TMessage>*>(psocket))->setState( SocketState::Undefined );
+                  psocket->setWriteInterest(False);
                   processSelectError(psocket);
                   return;
                }
@@ -2182,39 +2871,31 @@ namespace ESocket
          onSocketClosed(psocket);
       }
 
-      int getMaxFileDescriptor(Bool calc=False)
-      {
-         if (calc)
-         {
-            m_maxfd = this->getBumpPipe()[0];
-            
-            for (auto entry : m_socketmap)
-               if (entry.second->getHandle() > m_maxfd)
-                  m_maxfd = entry.second->getHandle();
-         }
-         
-         return m_maxfd;
-      }
+      enum { MaxEvents = 256 };
 
       Int m_error;
       std::unordered_map<Int,Base<TQueue,TMessage>*> m_socketmap;
-      fd_set m_master;
-      Int m_maxfd;
+      EventDemultiplexer *m_demux;
    };
 
    typedef Base<EThreadQueuePublic<EThreadMessage>,EThreadMessage> BasePublic;
    typedef Base<EThreadQueuePrivate<EThreadMessage>,EThreadMessage> BasePrivate;
+   typedef Base<EThreadQueueLockFree<EThreadMessage>,EThreadMessage> BaseLockFree;
    typedef Thread<EThreadQueuePublic<EThreadMessage>,EThreadMessage> ThreadPublic;
    typedef Thread<EThreadQueuePrivate<EThreadMessage>,EThreadMessage> ThreadPrivate;
+   typedef Thread<EThreadQueueLockFree<EThreadMessage>,EThreadMessage> ThreadLockFree;
    namespace TCP
    {
       typedef Talker<EThreadQueuePublic<EThreadMessage>,EThreadMessage> TalkerPublic;
       typedef Talker<EThreadQueuePrivate<EThreadMessage>,EThreadMessage> TalkerPrivate;
+      typedef Talker<EThreadQueueLockFree<EThreadMessage>,EThreadMessage> TalkerLockFree;
       typedef Listener<EThreadQueuePublic<EThreadMessage>,EThreadMessage> ListenerPublic;
       typedef Listener<EThreadQueuePrivate<EThreadMessage>,EThreadMessage> ListenerPrivate;
+      typedef Listener<EThreadQueueLockFree<EThreadMessage>,EThreadMessage> ListenerLockFree;
    }
    typedef UDP<EThreadQueuePublic<EThreadMessage>,EThreadMessage> UdpPublic;
    typedef UDP<EThreadQueuePrivate<EThreadMessage>,EThreadMessage> UdpPrivate;
+   typedef UDP<EThreadQueueLockFree<EThreadMessage>,EThreadMessage> UdpLockFree;
 }
 
 namespace std
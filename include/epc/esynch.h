@@ -302,9 +302,23 @@ public:
    ///   decremented (when the current value is less than or equal to zeor).  
    /// @return True if the semaphore was successfully decremented, otherwise False.
    Bool Decrement(Bool wait = True);
+   /// @brief Decrements the semaphore, waiting no longer than the specified time.
+   /// @param timeout the maximum time to wait in microseconds.  A value less
+   ///   than or equal to zero does not wait.
+   /// @return True if the semaphore was successfully decremented, otherwise False.
+   Bool TimedDecrement(LongLong timeout);
+   /// @brief Decrements the semaphore by up to the specified count without
+   ///   waiting.
+   /// @param count the maximum amount to decrement the semaphore by.
+   /// @return the amount the semaphore was decremented by.
+   Long TryDecrement(Long count);
    /// @brief Increments teh semaphore.
    /// @return True indicates that the semaphore was successfully incremented, otherwise False.
    Bool Increment();
+   /// @brief Increments the semaphore by the specified count.
+   /// @param count the amount to increment the semaphore by.
+   /// @return True indicates that the semaphore was successfully incremented, otherwise False.
+   Bool Increment(Long count);
 
    /// @brief Retrieves the initialization status.
    /// @return True indicates the semahpore data has been initialized, otherwise False.
@@ -320,6 +334,8 @@ public:
    Long currCount() { return m_currCount; }
 
 private:
+   Bool withdraw();
+
    Bool m_initialized;
    Bool m_shared;
    Long m_initCount;
@@ -346,9 +362,21 @@ public:
    /// @param wait indicates if the this method will block until the semaphore value is greater than zero.
    /// @return True indicates that the semaphore value was successfully decremented, otherwise False.
    Bool Decrement(Bool wait = True) { return getData().Decrement(wait); }
+   /// @brief Decrements the semaphore value, waiting no longer than the specified time.
+   /// @param timeout the maximum time to wait in microseconds.
+   /// @return True indicates that the semaphore value was successfully decremented, otherwise False.
+   Bool TimedDecrement(LongLong timeout) { return getData().TimedDecrement(timeout); }
+   /// @brief Decrements the semaphore value by up to the specified count without waiting.
+   /// @param count the maximum amount to decrement the semaphore value by.
+   /// @return the amount the semaphore value was decremented by.
+   Long TryDecrement(Long count) { return getData().TryDecrement(count); }
    /// @brief Increments the semaphore value.
    /// @return True indicates that the semaphore value was successfully decremented, otherwise False.
    Bool Increment() { return getData().Increment(); }
+   /// @brief Increments the semaphore value by the specified count.
+   /// @param count the amount to increment the semaphore value by.
+   /// @return True indicates that the semaphore value was successfully incremented, otherwise False.
+   Bool Increment(Long count) { return getData().Increment(count); }
 
    /// @brief Indicates the initialization status for this object.
    /// @return True indicates the object is initialized, otherwise False.
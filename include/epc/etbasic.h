@@ -34,13 +34,134 @@ public:
    EThreadError_UnableToInitialize();
 };
 
+class EThreadError_InvalidCpuList : public EError
+{
+public:
+   EThreadError_InvalidCpuList(cpStr list);
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
 class EThreadBasic;
+class EGetOpt;
 
 typedef list<EThreadBasic *> EThreadPtrList;
 
+/// @brief The CPU affinity, NUMA memory node and scheduling policy that a
+///   thread applies to itself when it starts.
+///
+/// @details
+/// The default placement leaves the thread as it is created.  Errors
+/// applying the placement, such as insufficient privileges for a real time
+/// scheduling policy, do not prevent the thread from running and are
+/// included in EThreadBasic::getPlacementReport().
+///
+class EThreadPlacement
+{
+   friend class EThreadBasic;
+public:
+   /// @brief The scheduling policies.
+   enum class SchedPolicy
+   {
+      /// the default time sharing policy (SCHED_OTHER)
+      Default,
+      /// first in, first out real time policy (SCHED_FIFO)
+      Fifo,
+      /// round robin real time policy (SCHED_RR)
+      RoundRobin
+   };
+
+   /// @brief Default constructor.
+   EThreadPlacement();
+
+   /// @brief Returns the CPU's the thread is allowed to run on, empty if not assigned.
+   const std::vector<Int> &cpus() const { return m_cpus; }
+   /// @brief Assigns the CPU's the thread is allowed to run on.
+   /// @param cpus the CPU numbers.
+   /// @return a reference to this object.
+   EThreadPlacement &cpus(const std::vector<Int> &cpus) { m_cpus = cpus; return *this; }
+   /// @brief Assigns the CPU's the thread is allowed to run on.
+   /// @param list a CPU list such as "0-3,8", an empty list clears the CPU's.
+   /// @return a reference to this object.
+   /// @throws EThreadError_InvalidCpuList the CPU list is not valid.
+   EThreadPlacement &cpus(cpStr list) { m_cpus = parseCpuList(list); return *this; }
+
+   /// @brief Returns the NUMA node that memory is allocated from, -1 if not assigned.
+   Int numaNode() const { return m_numa; }
+   /// @brief Assigns the NUMA node that memory is preferably allocated from.
+   ///   When no CPU's are assigned the thread also runs on the CPU's of the
+   ///   NUMA node.
+   /// @param node the NUMA node, -1 to use the default memory policy.
+   /// @return a reference to this object.
+   EThreadPlacement &numaNode(Int node) { m_numa = node; return *this; }
+
+   /// @brief Returns the scheduling policy.
+   SchedPolicy policy() const { return m_policy; }
+   /// @brief Assigns the scheduling policy.
+   /// @param policy the scheduling policy.
+   /// @return a reference to this object.
+   EThreadPlacement &policy(SchedPolicy policy) { m_policy = policy; return *this; }
+
+   /// @brief Returns the real time scheduling priority.
+   Int priority() const { return m_priority; }
+   /// @brief Assigns the real time scheduling priority, it is limited to the
+   ///   range of the scheduling policy.
+   /// @param priority the scheduling priority.
+   /// @return a reference to this object.
+   EThreadPlacement &priority(Int priority) { m_priority = priority; return *this; }
+
+   /// @brief Indicates if the threads of a group are each placed on a single
+   ///   CPU of the group, see forIndex().
+   Bool spread() const { return m_spread; }
+   /// @brief Assigns if the threads of a group are each placed on a single
+   ///   CPU of the group.
+   /// @param spread True to place each thread on a single CPU.
+   /// @return a reference to this object.
+   EThreadPlacement &spread(Bool spread) { m_spread = spread; return *this; }
+
+   /// @brief Indicates if this placement leaves the thread as it is created.
+   Bool isDefault() const { return m_cpus.empty() && m_numa < 0 && m_policy == SchedPolicy::Default; }
+
+   /// @brief Returns the placement of a thread that is a member of a group,
+   ///   such as a work group worker or a communication shard.
+   /// @param idx the index of the thread in the group.
+   /// @return when spread() is set, this placement restricted to the
+   ///   CPU selected round robin by the index, otherwise this placement.
+   EThreadPlacement forIndex(Int idx) const;
+
+   /// @brief Loads the placement from the configuration.
+   /// @param opt the configuration.
+   /// @param path the path of the placement object.  The members are "cpus"
+   ///   (a CPU list), "numaNode", "policy" ("default", "fifo" or "rr"),
+   ///   "priority" and "spread".  Members that are not present are not changed.
+   /// @return a reference to this object.
+   EThreadPlacement &load(const EGetOpt &opt, cpStr path);
+
+   /// @brief Parses a CPU list such as "0-3,8".
+   /// @param list the CPU list.
+   /// @return the CPU numbers.
+   /// @throws EThreadError_InvalidCpuList the CPU list is not valid.
+   static std::vector<Int> parseCpuList(cpStr list);
+   /// @brief Formats CPU numbers as a CPU list such as "0-3,8".
+   /// @param cpus the CPU numbers.
+   /// @return the CPU list.
+   static EString formatCpuList(const std::vector<Int> &cpus);
+   /// @brief Returns the CPU's of a NUMA node.
+   /// @param node the NUMA node.
+   /// @return the CPU numbers, empty if the NUMA node does not exist.
+   static std::vector<Int> numaCpus(Int node);
+
+private:
+   EString apply() const;
+
+   std::vector<Int> m_cpus;
+   Int m_numa;
+   SchedPolicy m_policy;
+   Int m_priority;
+   Bool m_spread;
+};
+
 /// @brief An abstract class that represents contains the threadProc() that
 /// will be run in a separate thread.
 ///
@@ -182,6 +303,17 @@ public:
    /// @brief
    Void signal(Int sig) { pthread_kill(m_thread, sig); }
 
+   /// @brief Returns the placement applied when the thread starts.
+   const EThreadPlacement &getPlacement() const { return m_placement; }
+   /// @brief Assigns the placement applied when the thread starts.  This
+   ///   must be called before init().
+   /// @param placement the placement.
+   Void setPlacement(const EThreadPlacement &placement) { m_placement = placement; }
+   /// @brief Returns a description of the CPU affinity, scheduling policy
+   ///   and NUMA node of the thread once it has started, including any
+   ///   error applying the placement.
+   const EString &getPlacementReport() const { return m_placementReport; }
+
 protected:
    /// @brief performs internal initialization *** DO NOT CALL ***
    static Void Initialize();
@@ -202,6 +334,8 @@ private:
    RunState m_state;
    pVoid m_arg;
    Dword m_exitCode;
+   EThreadPlacement m_placement;
+   EString m_placementReport;
 };
 
 #endif // #ifndef __ETBASIC_H
\ No newline at end of file
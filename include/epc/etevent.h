@@ -17,8 +17,14 @@
 #ifndef __ETEVENT_H
 #define __ETEVENT_H
 
+#include <sched.h>
 #include <unistd.h>
 #include <sys/syscall.h>
+#include <linux/futex.h>
+#include <atomic>
+#include <climits>
+#include <deque>
+#include <vector>
 
 #include "ebase.h"
 #include "etbasic.h"
@@ -39,6 +45,9 @@ DECLARE_ERROR(EThreadQueueBaseError_NotOpenForWriting);
 DECLARE_ERROR(EThreadQueueBaseError_NotOpenForReading);
 DECLARE_ERROR(EThreadQueueBaseError_MultipleReadersNotAllowed);
 DECLARE_ERROR(EThreadQueuePublicError_UnInitialized);
+DECLARE_ERROR(EThreadQueueLockFreeError_AlreadyInitialized);
+DECLARE_ERROR(EThreadQueueIdError_WorkerQueueOutOfRange);
+DECLARE_ERROR(EThreadWorkGroupError_ScalingWithDispatchKeys);
 
 DECLARE_ERROR_ADVANCED(EThreadTimerError_UnableToInitialize);
 DECLARE_ERROR_ADVANCED(EThreadTimerError_NotInitialized);
@@ -351,6 +360,365 @@ enum class EThreadQueueMode
    ReadWrite
 };
 
+/// @brief Defines how messages are dequeued from a thread queue that has
+///   more than one priority.
+enum class EThreadQueuePolicy
+{
+   /// A message is only dequeued when no message of a higher priority is queued.
+   Strict,
+   /// A message of the default priority is dequeued after each run of higher
+   ///   priority messages, so the default priority is never starved.
+   Weighted
+};
+
+/// @brief Defines how an event thread waits for the next event message.
+enum class EThreadWaitMode
+{
+   /// The thread blocks in the kernel as soon as its event queue is empty.
+   Park,
+   /// The thread polls its event queue for a number of spins, then yields
+   ///   the processor a number of times and finally blocks in the kernel.
+   SpinThenPark,
+   /// The thread polls its event queue and never blocks.  This is intended
+   ///   for threads that are pinned to a dedicated core.
+   BusyPoll
+};
+
+/// @brief The policy an event thread uses to wait for the next event message.
+/// @details Polling before blocking avoids the futex sleep and wakeup when
+///   the next message arrives shortly after the queue becomes empty, at the
+///   cost of the processor time spent polling.  With
+///   EThreadWaitMode::SpinThenPark the number of spins is halved each time
+///   spinning does not find a message, down to a sixteenth of spins(), and
+///   is restored once spinning or yielding finds one, so a thread whose
+///   messages arrive far apart spends little time spinning but still adapts
+///   when its messages start arriving close together again.
+class EThreadWaitPolicy
+{
+public:
+   /// @brief Class constructor.
+   /// @param mode the wait mode.
+   /// @param spins the number of times the event queue is polled before yielding.
+   /// @param yields the number of times the processor is yielded before blocking.
+   EThreadWaitPolicy(EThreadWaitMode mode = EThreadWaitMode::Park, Int spins = 2000, Int yields = 10)
+      : m_mode(mode),
+        m_spins(spins),
+        m_yields(yields),
+        m_limit(spins)
+   {
+   }
+
+   /// @brief Retrieves the wait mode.
+   /// @return the wait mode.
+   EThreadWaitMode mode() const { return m_mode; }
+   /// @brief Assigns the wait mode.
+   /// @param mode the wait mode.
+   /// @return a reference to this object.
+   EThreadWaitPolicy &mode(EThreadWaitMode mode) { m_mode = mode; return *this; }
+   /// @brief Retrieves the number of times the event queue is polled before yielding.
+   /// @return the number of spins.
+   Int spins() const { return m_spins; }
+   /// @brief Assigns the number of times the event queue is polled before yielding.
+   /// @param spins the number of spins.
+   /// @return a reference to this object.
+   EThreadWaitPolicy &spins(Int spins) { m_spins = m_limit = spins; return *this; }
+   /// @brief Retrieves the number of times the processor is yielded before blocking.
+   /// @return the number of yields.
+   Int yields() const { return m_yields; }
+   /// @brief Assigns the number of times the processor is yielded before blocking.
+   /// @param yields the number of yields.
+   /// @return a reference to this object.
+   EThreadWaitPolicy &yields(Int yields) { m_yields = yields; return *this; }
+
+   /// @brief Polls according to the wait mode.
+   /// @param poll a callable that returns True when a message was retrieved.
+   /// @param idle a callable that is periodically called while busy polling.
+   /// @return True if poll() retrieved a message, False if the caller
+   ///   should block.
+   template <class TPoll, class TIdle>
+   Bool poll(TPoll poll, TIdle idle) const
+   {
+      if (m_mode == EThreadWaitMode::Park)
+         return False;
+
+      Int i = 0;
+      while (m_mode == EThreadWaitMode::BusyPoll || i < m_limit)
+      {
+         if (poll())
+         {
+            m_limit = m_spins;
+            return True;
+         }
+         if (++i == 1024 && m_mode == EThreadWaitMode::BusyPoll)
+         {
+            idle();
+            i = 0;
+         }
+         relax();
+      }
+      m_limit = std::max(m_limit / 2, minimumLimit());
+
+      for (i = 0; i < m_yields; i++)
+      {
+         if (poll())
+         {
+            // the message arrived just after spinning stopped
+            m_limit = m_spins;
+            return True;
+         }
+         sched_yield();
+      }
+
+      return False;
+   }
+
+   /// @brief Hints to the processor that the caller is spinning.
+   static Void relax()
+   {
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_ia32_pause();
+#elif defined(__aarch64__)
+      asm volatile("yield" ::: "memory");
+#endif
+   }
+
+private:
+   Int minimumLimit() const { return m_spins > 0 ? std::max(m_spins / 16, 1) : 0; }
+
+   EThreadWaitMode m_mode;
+   Int m_spins;
+   Int m_yields;
+   mutable Int m_limit;
+};
+
+/// @brief Identifies why the work group autoscaler changed the number of workers.
+enum class EThreadWorkGroupScaleReason
+{
+   /// The queue depth reached the scale up depth.
+   Backlog,
+   /// The estimated queueing delay reached the scale up latency.
+   Latency,
+   /// The percentage of time the workers were busy reached the scale up busy percentage.
+   Busy,
+   /// The workers were below the scale down busy percentage for the cool down period.
+   Idle
+};
+
+/// @brief Describes a change in the number of workers made by the work group autoscaler.
+struct EThreadWorkGroupScaleEvent
+{
+   /// the reason for the change
+   EThreadWorkGroupScaleReason reason;
+   /// the number of active workers before the change
+   Int before;
+   /// the number of active workers after the change
+   Int after;
+   /// the queue depth when the change was made
+   Int depth;
+   /// the percentage of time the workers were busy since the previous check
+   Int busy;
+   /// the estimated queueing delay in microseconds
+   LongLong latency;
+};
+
+/// @brief The work group autoscaler counters and the most recent samples.
+struct EThreadWorkGroupScalingStats
+{
+   /// the number of checks performed
+   ULongLong checks;
+   /// the number of times workers were added
+   ULongLong scaleUps;
+   /// the number of times a worker was retired
+   ULongLong scaleDowns;
+   /// the highest number of active workers
+   Int peakWorkers;
+   /// the queue depth at the most recent check
+   Int depth;
+   /// the busy percentage at the most recent check
+   Int busy;
+   /// the estimated queueing delay in microseconds at the most recent check
+   LongLong latency;
+};
+
+/// @brief The policy a work group uses to add and retire workers between the
+///   minimum and maximum number of workers.
+/// @details When enabled, the work group checks every interval() milliseconds
+///   the queue depth, the percentage of time the workers spent processing
+///   messages and the queueing delay estimated from the queue depth and the
+///   average message processing time.  If any of them reaches its scale up
+///   threshold, up to step() workers are added.  A worker above the minimum
+///   is retired once the busy percentage has been below scaleDownBusy() for
+///   coolDown() milliseconds and no workers were added or retired during the
+///   previous coolDown() milliseconds, so a burst grows the work group
+///   quickly while it shrinks one worker at a time.
+class EThreadWorkGroupScaling
+{
+public:
+   /// @brief Default class constructor.  Autoscaling is disabled.
+   EThreadWorkGroupScaling()
+      : m_enabled(False),
+        m_interval(100),
+        m_upDepth(1000),
+        m_upLatency(0),
+        m_upBusy(80),
+        m_downBusy(20),
+        m_coolDown(10000),
+        m_step(1)
+   {
+   }
+
+   /// @brief Retrieves the enabled setting.
+   /// @return True if autoscaling is enabled, otherwise False.
+   Bool enabled() const { return m_enabled; }
+   /// @brief Assigns the enabled setting.
+   /// @param enabled True to enable autoscaling.
+   /// @return a reference to this object.
+   EThreadWorkGroupScaling &enabled(Bool enabled) { m_enabled = enabled; return *this; }
+   /// @brief Retrieves the number of milliseconds between checks.
+   /// @return the number of milliseconds between checks.
+   Int interval() const { return m_interval; }
+   /// @brief Assigns the number of milliseconds between checks.  A value of
+   ///   zero does not start the autoscaler thread, instead the application
+   ///   is expected to periodically call EThreadEventWorkGroup::checkScaling().
+   ///   With per worker dispatch, a message posted to the queue of a retired
+   ///   worker is not forwarded to an active worker until the next call to
+   ///   checkScaling(), addWorker() or removeWorker().
+   /// @param ms the number of milliseconds between checks.
+   /// @return a reference to this object.
+   EThreadWorkGroupScaling &interval(Int ms) { m_interval = ms; return *this; }
+   /// @brief Retrieves the queue depth that adds workers.
+   /// @return the queue depth that adds workers, zero when disabled.
+   Int scaleUpDepth() const { return m_upDepth; }
+   /// @brief Assigns the queue depth that adds workers.
+   /// @param depth the queue depth, zero disables this threshold.
+   /// @return a reference to this object.
+   EThreadWorkGroupScaling &scaleUpDepth(Int depth) { m_upDepth = depth; return *this; }
+   /// @brief Retrieves the estimated queueing delay that adds workers.
+   /// @return the queueing delay in microseconds, zero when disabled.
+   LongLong scaleUpLatency() const { return m_upLatency; }
+   /// @brief Assigns the estimated queueing delay that adds workers.
+   /// @param usec the queueing delay in microseconds, zero disables this threshold.
+   /// @return a reference to this object.
+   EThreadWorkGroupScaling &scaleUpLatency(LongLong usec) { m_upLatency = usec; return *this; }
+   /// @brief Retrieves the busy percentage that adds workers.
+   /// @return the busy percentage, zero when disabled.
+   Int scaleUpBusy() const { return m_upBusy; }
+   /// @brief Assigns the busy percentage that adds workers.
+   /// @param pct the busy percentage, zero disables this threshold.
+   /// @return a reference to this object.
+   EThreadWorkGroupScaling &scaleUpBusy(Int pct) { m_upBusy = pct; return *this; }
+   /// @brief Retrieves the busy percentage below which workers are retired.
+   /// @return the busy percentage.
+   Int scaleDownBusy() const { return m_downBusy; }
+   /// @brief Assigns the busy percentage below which workers are retired.
+   /// @param pct the busy percentage.
+   /// @return a reference to this object.
+   EThreadWorkGroupScaling &scaleDownBusy(Int pct) { m_downBusy = pct; return *this; }
+   /// @brief Retrieves the cool down period.
+   /// @return the cool down period in milliseconds.
+   Int coolDown() const { return m_coolDown; }
+   /// @brief Assigns the cool down period.
+   /// @param ms the cool down period in milliseconds.
+   /// @return a reference to this object.
+   EThreadWorkGroupScaling &coolDown(Int ms) { m_coolDown = ms; return *this; }
+   /// @brief Retrieves the maximum number of workers added by a check.
+   /// @return the maximum number of workers added by a check.
+   Int step() const { return m_step; }
+   /// @brief Assigns the maximum number of workers added by a check.
+   /// @param workers the maximum number of workers added by a check.
+   /// @return a reference to this object.
+   EThreadWorkGroupScaling &step(Int workers) { m_step = workers < 1 ? 1 : workers; return *this; }
+
+   /// @brief Loads the autoscaling settings from the configuration.
+   /// @param opt the configuration options.
+   /// @param path the path to the autoscaling object, for example
+   ///   "/MyApp/applicationScaling".  The members are enabled, interval,
+   ///   scaleUpDepth, scaleUpLatency, scaleUpBusy, scaleDownBusy, coolDown
+   ///   and step.  Missing members retain their current value.
+   /// @return a reference to this object.
+   EThreadWorkGroupScaling &load(const EGetOpt &opt, cpStr path);
+
+   /// @brief Retrieves the CLOCK_MONOTONIC time used to measure busy time.
+   /// @return the current time in nanoseconds.
+   static ULongLong now()
+   {
+      struct timespec ts;
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return static_cast<ULongLong>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+   }
+
+private:
+   Bool m_enabled;
+   Int m_interval;
+   Int m_upDepth;
+   LongLong m_upLatency;
+   Int m_upBusy;
+   Int m_downBusy;
+   Int m_coolDown;
+   Int m_step;
+};
+
+/// @brief Defines the event queue IDs reserved by EThreadEvent and
+///   EThreadEventWorkGroup.
+/// @details A public event queue is identified in shared memory by its ID,
+///   so application defined public queues must not use these IDs.  Each
+///   application ID owns the block of AppBlock IDs starting at
+///   appId * AppBlock, which is divided as follows:
+///   - ThreadBase + threadId, the EThreadEvent queues (threadId < 10000).
+///   - WorkGroupBase + workGroupId, the work group queues (workGroupId < 10000).
+///   - WorkerBase + workGroupId * MaxWorkerQueues + worker, the per worker
+///     queues of a work group that uses EThreadWorkGroupDispatch::PerWorker
+///     (workGroupId < MaxWorkerQueueGroups, worker < MaxWorkerQueues).
+class EThreadQueueId
+{
+public:
+   enum
+   {
+      /// the number of IDs reserved for each application ID
+      AppBlock = 100000,
+      /// the offset of the EThreadEvent queue IDs
+      ThreadBase = 10000,
+      /// the offset of the work group queue IDs
+      WorkGroupBase = 20000,
+      /// the offset of the per worker queue IDs
+      WorkerBase = 30000,
+      /// the maximum number of per worker queues in a work group
+      MaxWorkerQueues = 64,
+      /// the maximum work group ID that can use per worker queues
+      MaxWorkerQueueGroups = 1000
+   };
+
+   /// @brief Returns the queue ID of an EThreadEvent.
+   /// @param appId the application ID.
+   /// @param threadId the thread ID.
+   /// @return the queue ID.
+   static long thread(Short appId, UShort threadId)
+   {
+      return static_cast<long>(appId) * AppBlock + ThreadBase + threadId;
+   }
+   /// @brief Returns the queue ID of a work group.
+   /// @param appId the application ID.
+   /// @param workGroupId the work group ID.
+   /// @return the queue ID.
+   static long workGroup(Short appId, UShort workGroupId)
+   {
+      return static_cast<long>(appId) * AppBlock + WorkGroupBase + workGroupId;
+   }
+   /// @brief Returns the queue ID of a per worker queue.
+   /// @param appId the application ID.
+   /// @param workGroupId the work group ID.
+   /// @param worker the zero based index of the worker.
+   /// @return the queue ID.
+   /// @throws EThreadQueueIdError_WorkerQueueOutOfRange if workGroupId or
+   ///   worker is outside of the reserved range.
+   static long worker(Short appId, UShort workGroupId, Int worker)
+   {
+      if (workGroupId >= MaxWorkerQueueGroups || worker < 0 || worker >= MaxWorkerQueues)
+         throw EThreadQueueIdError_WorkerQueueOutOfRange();
+      return static_cast<long>(appId) * AppBlock + WorkerBase + workGroupId * MaxWorkerQueues + worker;
+   }
+};
+
 /// @brief Defines the functionality for the thread queue.
 /// @details This is a templated class. The template parameter is the message
 ///   class.  This allows for a developer to provide a custom event message
@@ -362,6 +730,14 @@ public:
    /// @brief Returns the maximum number of events that can be present in the event queue.
    /// @return The maximum number of events that can be present in the event queue.
    Int queueSize() const { return msgCnt(); }
+   /// @brief Returns the number of messages in the event queue.
+   /// @return the number of messages in the event queue.  This is a snapshot
+   ///   that can be stale by the time it is used.
+   Int depth()
+   {
+      Long cnt = semMsgs().currCount();
+      return cnt > 0 ? static_cast<Int>(cnt) : 0;
+   }
 
    /// @brief Adds the specified message to the thread event queue.
    /// @param msg a reference to the message to add.
@@ -406,22 +782,50 @@ public:
       if (!semMsgs().Decrement(wait))
          return False;
 
-      {
-         EMutexLock l(mutex(),False);
+      dequeue(msg);
 
-         if (multipleReaders())
-            l.acquire();
-
-         msg = data()[msgTail()++];
+      return True;
+   }
+   /// @brief Removes the next message from the thread event queue, waiting
+   ///   no longer than the specified time for one to become available.
+   /// @param msg a reference to a message object that will be populated with the message.
+   /// @param timeout the maximum time to wait in microseconds.
+   /// @return True indicates that a message was successfully popped from the queue, otherwise False.
+   Bool timedPop(T &msg, LongLong timeout)
+   {
+      if (m_mode == EThreadQueueMode::WriteOnly)
+         throw EThreadQueueBaseError_NotOpenForReading();
 
-         if (msgTail() >= msgCnt())
-            msgTail() = 0;
+      if (!semMsgs().TimedDecrement(timeout))
+         return False;
 
-         semFree().Increment();
-      }
+      dequeue(msg);
 
       return True;
    }
+   /// @brief Removes up to the specified number of messages from the thread
+   ///   event queue.
+   /// @param msgs an array of message objects that will be populated with the messages.
+   /// @param max the maximum number of messages to remove, the size of msgs.
+   /// @param wait indicates whether this function should wait for a message to become
+   ///   available in the queue.
+   /// @return the number of messages removed from the queue.
+   /// @details The messages are claimed with a single semaphore operation
+   ///   and removed with a single acquisition of the queue mutex.
+   Int popBatch(T *msgs, Int max, Bool wait = True)
+   {
+      if (m_mode == EThreadQueueMode::WriteOnly)
+         throw EThreadQueueBaseError_NotOpenForReading();
+
+      if (max <= 0 || !semMsgs().Decrement(wait))
+         return 0;
+
+      Int cnt = 1 + static_cast<Int>(semMsgs().TryDecrement(max - 1));
+
+      dequeue(msgs, cnt);
+
+      return cnt;
+   }
 
    /// @brief Retrieves indication if this queue object has been initialized.
    /// @return True if initialized, otherwise False.
@@ -454,6 +858,39 @@ protected:
 
    virtual int *getBumpPipe() = 0;
 
+   Void dequeue(T &msg)
+   {
+      EMutexLock l(mutex(),False);
+
+      if (multipleReaders())
+         l.acquire();
+
+      msg = data()[msgTail()++];
+
+      if (msgTail() >= msgCnt())
+         msgTail() = 0;
+
+      semFree().Increment();
+   }
+
+   Void dequeue(T *msgs, Int cnt)
+   {
+      EMutexLock l(mutex(),False);
+
+      if (multipleReaders())
+         l.acquire();
+
+      for (Int i = 0; i < cnt; i++)
+      {
+         msgs[i] = data()[msgTail()++];
+
+         if (msgTail() >= msgCnt())
+            msgTail() = 0;
+      }
+
+      semFree().Increment(cnt);
+   }
+
    EThreadQueueBase()
    {
       m_initialized = False;
@@ -790,6 +1227,543 @@ private:
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+/// @brief Definition of a lock-free private event thread message queue.
+/// @details This queue is a drop in replacement for EThreadQueuePrivate.  It
+///   is a bounded ring where each slot carries a sequence number so that
+///   producers and consumers never share a lock.  Producers always claim
+///   slots with a compare and swap since every event queue can be written
+///   by other threads, timers and the thread itself.  When the queue has a
+///   single reader, the read side is a plain load/store (MPSC), otherwise
+///   slots are also claimed with a compare and swap.  A
+///   thread only makes a futex system call when it must block, either because
+///   the queue is empty or full, and the opposite side only makes a futex
+///   system call when it sees that a thread is actually parked.  A writer
+///   blocked on a full queue is not woken until a quarter of the queue is
+///   free so that a full queue does not turn into a wakeup per message.
+///
+///   The queue can be configured with additional priorities with
+///   setPriorities().  Each priority above the default (0) has a separate
+///   ring a quarter of the size of the queue, and a reader dequeues from the
+///   highest priority ring that has a message according to the
+///   EThreadQueuePolicy.
+/// @tparam T the event message class name.
+template <class T>
+class EThreadQueueLockFree
+{
+   template <class TQueue, class TMessage> friend class EThreadEvent;
+   template <class TQueue, class TMessage> friend class EThreadEventWorker;
+   template <class TQueue, class TMessage, class TWorker> friend class EThreadEventWorkGroup;
+public:
+   /// @brief Default constructor.
+   EThreadQueueLockFree()
+      : m_mutex()
+   {
+      m_initialized = False;
+      m_mode = EThreadQueueMode::ReadWrite;
+      m_numReaders = 0;
+      m_numWriters = 0;
+      m_multipleReaders = False;
+      m_msgCnt = 0;
+      m_lowWater = 0;
+      m_mask = 0;
+      m_slots = NULL;
+      m_head.store(0, std::memory_order_relaxed);
+      m_tail.store(0, std::memory_order_relaxed);
+      m_msgsEpoch.store(0, std::memory_order_relaxed);
+      m_msgsParked.store(0, std::memory_order_relaxed);
+      m_freeEpoch.store(0, std::memory_order_relaxed);
+      m_freeParked.store(0, std::memory_order_relaxed);
+      m_priorities = 1;
+      m_policy = EThreadQueuePolicy::Strict;
+      m_weight = 0;
+      m_burst.store(0, std::memory_order_relaxed);
+      m_lanes = NULL;
+   }
+   /// @brief Class destructor.
+   ~EThreadQueueLockFree()
+   {
+      if (m_lanes)
+      {
+         for (Int p = 1; p < m_priorities; p++)
+            delete m_lanes[p];
+         delete[] m_lanes;
+      }
+      m_lanes = NULL;
+      if (m_slots)
+         delete[] m_slots;
+      m_slots = NULL;
+   }
+
+   /// @brief Configures the number of message priorities.  This must be
+   ///   called before the queue is initialized.
+   /// @param priorities the number of priorities, messages can be pushed
+   ///   with a priority from 0 (the default) to priorities - 1 (the highest).
+   /// @param policy the policy used to select the priority to dequeue from.
+   /// @param weight for EThreadQueuePolicy::Weighted, the maximum number of
+   ///   consecutive higher priority messages that are dequeued while a
+   ///   default priority message is waiting.
+   Void setPriorities(Int priorities, EThreadQueuePolicy policy = EThreadQueuePolicy::Strict, Int weight = 16)
+   {
+      if (m_slots)
+         throw EThreadQueueLockFreeError_AlreadyInitialized();
+      m_priorities = std::max(priorities, 1);
+      m_policy = policy;
+      m_weight = std::max(weight, 1);
+   }
+   /// @brief Returns the number of message priorities.
+   /// @return the number of message priorities.
+   Int priorities() const { return m_priorities; }
+
+   /// @brief Returns the maximum number of events that can be present in the event queue.
+   /// @return The maximum number of events that can be present in the event queue.
+   Int queueSize() const { return m_msgCnt; }
+   /// @brief Returns the number of messages in the event queue, including
+   ///   the messages queued with a higher priority.
+   /// @return the number of messages in the event queue.  This is a snapshot
+   ///   that can be stale by the time it is used.
+   Int depth() const
+   {
+      size_t used = usedCount();
+      for (Int p = 1; p < m_priorities; p++)
+         used += m_lanes[p]->usedCount();
+      return static_cast<Int>(used);
+   }
+
+   /// @brief Adds the specified message to the thread event queue.
+   /// @param msg a reference to the message to add.
+   /// @param wait indicates whether this function should wait for space to become
+   ///   available in the queue.
+   /// @return True indicates that the message was successfully added to the queue, otherwise False.
+   ///   This function can only return False if wait is False.
+   Bool push(const T &msg, Bool wait = True)
+   {
+      if (m_mode == EThreadQueueMode::ReadOnly)
+         throw EThreadQueueBaseError_NotOpenForWriting();
+
+      while (!tryPush(msg))
+      {
+         if (!wait)
+            return False;
+         park(m_freeEpoch, m_freeParked, [this]() { return freeCount() >= m_lowWater; });
+      }
+
+      unpark(m_msgsEpoch, m_msgsParked, m_multipleReaders ? INT_MAX : 1);
+
+      return True;
+   }
+   /// @brief Adds the specified message to the thread event queue with a
+   ///   priority.
+   /// @param msg a reference to the message to add.
+   /// @param wait indicates whether this function should wait for space to become
+   ///   available in the queue for the priority.
+   /// @param priority the message priority, a value outside of the configured
+   ///   range is limited to the range.
+   /// @return True indicates that the message was successfully added to the queue, otherwise False.
+   ///   This function can only return False if wait is False.
+   Bool push(const T &msg, Bool wait, Int priority)
+   {
+      if (priority <= 0 || m_priorities == 1)
+         return push(msg, wait);
+
+      if (m_mode == EThreadQueueMode::ReadOnly)
+         throw EThreadQueueBaseError_NotOpenForWriting();
+
+      EThreadQueueLockFree *lane = m_lanes[std::min(priority, m_priorities - 1)];
+      while (!lane->tryPush(msg))
+      {
+         if (!wait)
+            return False;
+         park(lane->m_freeEpoch, lane->m_freeParked, [lane]() { return lane->freeCount() >= lane->m_lowWater; });
+      }
+
+      // the readers always park on the default priority
+      unpark(m_msgsEpoch, m_msgsParked, m_multipleReaders ? INT_MAX : 1);
+
+      return True;
+   }
+   /// @brief Removes the next message from the thread event queue.
+   /// @param msg a reference to a message object that will be populated with the message.
+   /// @param wait indicates whether this function should wait for a message to become
+   ///   available in the queue.
+   /// @return True indicates that a message was successfully popped from the queue, otherwise False.
+   Bool pop(T &msg, Bool wait = True)
+   {
+      if (m_mode == EThreadQueueMode::WriteOnly)
+         throw EThreadQueueBaseError_NotOpenForReading();
+
+      EThreadQueueLockFree *lane;
+      while (!tryPopLanes(msg, lane))
+      {
+         if (!wait)
+            return False;
+         park(m_msgsEpoch, m_msgsParked, [this]() { return !emptyLanes(); });
+      }
+
+      if (lane->freeCount() >= lane->m_lowWater)
+         unpark(lane->m_freeEpoch, lane->m_freeParked, INT_MAX);
+
+      return True;
+   }
+   /// @brief Removes the next message from the thread event queue, waiting
+   ///   no longer than the specified time for one to become available.
+   /// @param msg a reference to a message object that will be populated with the message.
+   /// @param timeout the maximum time to wait in microseconds.
+   /// @return True indicates that a message was successfully popped from the queue, otherwise False.
+   Bool timedPop(T &msg, LongLong timeout)
+   {
+      if (m_mode == EThreadQueueMode::WriteOnly)
+         throw EThreadQueueBaseError_NotOpenForReading();
+
+      EThreadQueueLockFree *lane;
+      if (!tryPopLanes(msg, lane))
+      {
+         if (timeout <= 0)
+            return False;
+
+         struct timespec ts;
+         ts.tv_sec = timeout / 1000000;
+         ts.tv_nsec = (timeout % 1000000) * 1000;
+         park(m_msgsEpoch, m_msgsParked, [this]() { return !emptyLanes(); }, &ts);
+
+         // a single wait, a spurious wakeup is reported as a timeout
+         if (!tryPopLanes(msg, lane))
+            return False;
+      }
+
+      if (lane->freeCount() >= lane->m_lowWater)
+         unpark(lane->m_freeEpoch, lane->m_freeParked, INT_MAX);
+
+      return True;
+   }
+   /// @brief Removes up to the specified number of messages from the thread
+   ///   event queue.
+   /// @param msgs an array of message objects that will be populated with the messages.
+   /// @param max the maximum number of messages to remove, the size of msgs.
+   /// @param wait indicates whether this function should wait for a message to become
+   ///   available in the queue.
+   /// @return the number of messages removed from the queue.
+   /// @details The messages are removed in priority order and the writers
+   ///   waiting for space are woken once for the batch.
+   Int popBatch(T *msgs, Int max, Bool wait = True)
+   {
+      if (m_mode == EThreadQueueMode::WriteOnly)
+         throw EThreadQueueBaseError_NotOpenForReading();
+
+      EThreadQueueLockFree *lane;
+      Int cnt = 0;
+      while (cnt < max)
+      {
+         if (tryPopLanes(msgs[cnt], lane))
+         {
+            cnt++;
+            continue;
+         }
+         if (cnt > 0 || !wait)
+            break;
+         park(m_msgsEpoch, m_msgsParked, [this]() { return !emptyLanes(); });
+      }
+
+      if (cnt > 0)
+      {
+         for (Int p = 0; p < m_priorities; p++)
+         {
+            lane = p == 0 ? this : m_lanes[p];
+            if (lane->freeCount() >= lane->m_lowWater)
+               unpark(lane->m_freeEpoch, lane->m_freeParked, INT_MAX);
+         }
+      }
+
+      return cnt;
+   }
+
+   /// @brief Retrieves indication if this queue object has been initialized.
+   /// @return True if initialized, otherwise False.
+   Bool isInitialized() { return m_initialized; }
+   /// @brief Retrieves the access mode associated with this queue object.
+   /// @return the access mode associated with this queue object.
+   EThreadQueueMode mode() { return m_mode; }
+
+   /// @brief Initializes this lock-free event thead message queue object.
+   /// @param nMsgCnt the maximum number of event messages that can exist
+   ///   in the queue at a time, rounded up to the next power of 2.
+   /// @param threadId the thread identifier (not used).
+   /// @param bMultipleWriters not used, the queue always supports multiple
+   ///   writers.
+   /// @param eMode indicates the desired access mode.
+   Void init(Int nMsgCnt, Int threadId, Bool bMultipleWriters,
+             EThreadQueueMode eMode)
+   {
+      init(nMsgCnt, threadId, bMultipleWriters, eMode, False);
+   }
+
+protected:
+   /// @cond DOXYGEN_EXCLUDE
+   Void init(Int nMsgCnt, Int threadId, Bool bMultipleWriters,
+             EThreadQueueMode eMode, Bool bMultipleReaders)
+   {
+      m_mode = eMode;
+
+      if (!m_slots)
+      {
+         allocate(nMsgCnt, bMultipleReaders);
+
+         if (m_priorities > 1)
+         {
+            m_lanes = new EThreadQueueLockFree*[m_priorities];
+            m_lanes[0] = this;
+            for (Int p = 1; p < m_priorities; p++)
+            {
+               m_lanes[p] = new EThreadQueueLockFree();
+               m_lanes[p]->allocate(std::max(nMsgCnt / 4, 64), bMultipleReaders);
+            }
+         }
+      }
+
+      attach(eMode);
+
+      m_initialized = True;
+   }
+
+   Void attach(EThreadQueueMode eMode)
+   {
+      EMutexLock l(m_mutex);
+
+      if (!m_multipleReaders && m_numReaders > 0 &&
+          (eMode == EThreadQueueMode::ReadOnly || eMode == EThreadQueueMode::ReadWrite))
+      {
+         throw EThreadQueueBaseError_MultipleReadersNotAllowed();
+      }
+
+      m_numReaders += (eMode == EThreadQueueMode::ReadOnly || eMode == EThreadQueueMode::ReadWrite) ? 1 : 0;
+      m_numWriters += (eMode == EThreadQueueMode::WriteOnly || eMode == EThreadQueueMode::ReadWrite) ? 1 : 0;
+   }
+
+   Bool isPublic() { return False; }
+   int *getBumpPipe() { return m_bumppipe; }
+   /// @endcond
+
+private:
+   struct Slot
+   {
+      std::atomic<size_t> seq;
+      T msg;
+   };
+
+   Void allocate(Int nMsgCnt, Bool bMultipleReaders)
+   {
+      size_t cnt = 2;
+      while (cnt < static_cast<size_t>(nMsgCnt))
+         cnt <<= 1;
+
+      m_slots = new Slot[cnt];
+      for (size_t i = 0; i < cnt; i++)
+         m_slots[i].seq.store(i, std::memory_order_relaxed);
+
+      m_msgCnt = static_cast<Int>(cnt);
+      m_lowWater = cnt / 4;
+      m_mask = cnt - 1;
+      m_multipleReaders = bMultipleReaders;
+      m_head.store(0, std::memory_order_relaxed);
+      m_tail.store(0, std::memory_order_release);
+   }
+
+   Bool tryPopHigher(T &msg, EThreadQueueLockFree *&lane)
+   {
+      for (Int p = m_priorities - 1; p > 0; p--)
+      {
+         if (m_lanes[p]->tryPop(msg))
+         {
+            lane = m_lanes[p];
+            return True;
+         }
+      }
+      return False;
+   }
+
+   Bool tryPopLanes(T &msg, EThreadQueueLockFree *&lane)
+   {
+      lane = this;
+      if (m_priorities == 1)
+         return tryPop(msg);
+
+      // with the weighted policy, the default priority gets a turn once
+      // a run of higher priority messages reaches the weight
+      Bool yield = m_policy == EThreadQueuePolicy::Weighted &&
+         m_burst.load(std::memory_order_relaxed) >= m_weight;
+
+      if (!yield && tryPopHigher(msg, lane))
+      {
+         m_burst.fetch_add(1, std::memory_order_relaxed);
+         return True;
+      }
+      if (tryPop(msg))
+      {
+         m_burst.store(0, std::memory_order_relaxed);
+         return True;
+      }
+      return yield && tryPopHigher(msg, lane);
+   }
+
+   Bool emptyLanes()
+   {
+      for (Int p = 1; p < m_priorities; p++)
+         if (!m_lanes[p]->empty())
+            return False;
+      return empty();
+   }
+
+   Bool tryPush(const T &msg)
+   {
+      size_t pos = m_head.load(std::memory_order_relaxed);
+      Slot *slot;
+
+      while (True)
+      {
+         slot = &m_slots[pos & m_mask];
+         intptr_t diff = static_cast<intptr_t>(slot->seq.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos);
+         if (diff == 0)
+         {
+            if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+               break;
+         }
+         else if (diff < 0)
+         {
+            // the slot still holds an unread message, the queue is full
+            return False;
+         }
+         else
+         {
+            pos = m_head.load(std::memory_order_relaxed);
+         }
+      }
+
+      slot->msg = msg;
+      slot->msg.data().getTimer().Start();
+      slot->seq.store(pos + 1, std::memory_order_release);
+
+      return True;
+   }
+
+   Bool tryPop(T &msg)
+   {
+      size_t pos = m_tail.load(std::memory_order_relaxed);
+      Slot *slot;
+
+      while (True)
+      {
+         slot = &m_slots[pos & m_mask];
+         intptr_t diff = static_cast<intptr_t>(slot->seq.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos + 1);
+         if (diff == 0)
+         {
+            if (!m_multipleReaders)
+            {
+               m_tail.store(pos + 1, std::memory_order_relaxed);
+               break;
+            }
+            if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+               break;
+         }
+         else if (diff < 0)
+         {
+            // the slot has not been published, the queue is empty
+            return False;
+         }
+         else
+         {
+            pos = m_tail.load(std::memory_order_relaxed);
+         }
+      }
+
+      msg = slot->msg;
+      slot->seq.store(pos + m_mask + 1, std::memory_order_release);
+
+      return True;
+   }
+
+   Bool empty()
+   {
+      size_t pos = m_tail.load(std::memory_order_relaxed);
+      return m_slots[pos & m_mask].seq.load(std::memory_order_acquire) != pos + 1;
+   }
+
+   size_t freeCount()
+   {
+      size_t used = m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_relaxed);
+      return used > m_mask ? 0 : m_mask + 1 - used;
+   }
+
+   size_t usedCount() const
+   {
+      if (!m_slots)
+         return 0;
+      // the tail is read first so a pop between the loads can't make it pass the head
+      size_t tail = m_tail.load(std::memory_order_relaxed);
+      size_t used = m_head.load(std::memory_order_relaxed) - tail;
+      return used > m_mask + 1 ? 0 : used;
+   }
+
+   // The parked flag is set before the condition is re-checked and the other
+   // side checks the flag after publishing its change, so one of the two
+   // always sees the other.  Only the first wakeup after a thread parks pays
+   // for the system call since the flag is cleared by the waker.  The epoch
+   // guards against a wakeup that arrives between the re-check and the wait.
+   template <class TPred>
+   Void park(std::atomic<Int> &epoch, std::atomic<Int> &parked, TPred ready, const struct timespec *timeout = NULL)
+   {
+      Int key = epoch.load(std::memory_order_acquire);
+      parked.store(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (!ready())
+         syscall(SYS_futex, reinterpret_cast<Int*>(&epoch), FUTEX_WAIT_PRIVATE, key, timeout, NULL, 0);
+   }
+
+   Void unpark(std::atomic<Int> &epoch, std::atomic<Int> &parked, Int count)
+   {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (parked.load(std::memory_order_relaxed) && parked.exchange(0, std::memory_order_relaxed))
+      {
+         epoch.fetch_add(1, std::memory_order_release);
+         syscall(SYS_futex, reinterpret_cast<Int*>(&epoch), FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+      }
+   }
+
+   // the producer and consumer indexes are kept on separate cache lines
+   std::atomic<size_t> m_head;
+   Char m_pad1[64];
+   std::atomic<size_t> m_tail;
+   Char m_pad2[64];
+   std::atomic<Int> m_msgsEpoch;
+   std::atomic<Int> m_msgsParked;
+   Char m_pad3[64];
+   std::atomic<Int> m_freeEpoch;
+   std::atomic<Int> m_freeParked;
+   Char m_pad4[64];
+
+   Bool m_initialized;
+   EThreadQueueMode m_mode;
+   Int m_numReaders;
+   Int m_numWriters;
+   Bool m_multipleReaders;
+   Int m_msgCnt;
+   size_t m_lowWater;
+   size_t m_mask;
+   Slot *m_slots;
+
+   // the rings for the priorities above the default, m_lanes[0] is this queue
+   Int m_priorities;
+   EThreadQueuePolicy m_policy;
+   Int m_weight;
+   std::atomic<Int> m_burst;
+   EThreadQueueLockFree **m_lanes;
+
+   EMutexPrivate m_mutex;
+
+   int m_bumppipe[2];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 /// thread initialization event
 #define EM_INIT 1
 /// thread quit event
@@ -806,12 +1780,98 @@ private:
 #define EM_SOCKETSELECT_ERROR 7
 /// socket exception event see ESocketThread
 #define EM_SOCKETSELECT_EXCEPTION 8
+/// thread and work group worker wakeup event (internal, never dispatched)
+#define EM_WAKEUP 9
+/// work group worker retire event, the worker calls onQuit() and exits
+#define EM_RETIRE 10
 /// beginning of user events
 #define EM_USER 10000
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+/// @brief A hierarchical timing wheel.
+/// @details The wheel has 4 levels of 256 slots each, covering 2^32 ticks.
+///   Timers are intrusive Node objects that are linked directly into a slot,
+///   so starting and stopping a timer is O(1) and does not allocate memory.
+///   The wheel does not keep time or lock; the owner converts time to ticks,
+///   serializes access and calls advance() from a timerfd, an event loop or
+///   any other periodic source.
+class ETimerWheel
+{
+public:
+   /// @brief A timer that can be linked into the timing wheel.
+   class Node
+   {
+      friend class ETimerWheel;
+   public:
+      /// @brief Default constructor.
+      Node() : m_next(nullptr), m_prev(nullptr), m_slot(nullptr), m_expires(0) {}
+      /// @brief Retrieves indication if this timer is in the wheel.
+      /// @return True if the timer is in the wheel, otherwise False.
+      Bool isActive() const { return m_slot != nullptr; }
+      /// @brief Retrieves the tick that this timer expires at.
+      /// @return the tick that this timer expires at.
+      ULongLong getExpires() const { return m_expires; }
+      /// @brief Retrieves the next node in the list returned by advance().
+      /// @return the next expired node or nullptr.
+      Node *getNext() const { return m_next; }
+   private:
+      Node *m_next;
+      Node *m_prev;
+      Node **m_slot;
+      ULongLong m_expires;
+   };
+
+   /// @brief Default constructor.
+   ETimerWheel();
+
+   /// @brief Sets the current tick.  The wheel must be empty.
+   /// @param tick the current tick.
+   Void reset(ULongLong tick);
+   /// @brief Retrieves the next tick that will be processed by advance().
+   /// @return the next tick that will be processed by advance().
+   ULongLong getCurrent() const { return m_current; }
+   /// @brief Retrieves the number of timers in the wheel.
+   /// @return the number of timers in the wheel.
+   size_t size() const { return m_count; }
+
+   /// @brief Adds a timer to the wheel.  If the timer is already in the wheel
+   ///   it is restarted.
+   /// @param node the timer.
+   /// @param expires the tick the timer expires at.  A tick that has already
+   ///   been processed expires on the next call to advance().
+   Void start(Node &node, ULongLong expires);
+   /// @brief Removes a timer from the wheel.  Has no effect if the timer is
+   ///   not in the wheel.
+   /// @param node the timer.
+   Void stop(Node &node);
+   /// @brief Processes all ticks up to and including the specified tick.
+   /// @param tick the tick to advance to.
+   /// @return a list of the expired timers, linked with Node::getNext().  The
+   ///   expired timers are no longer in the wheel.
+   Node *advance(ULongLong tick);
+   /// @brief Retrieves the tick that advance() should next be called for.
+   /// @param tick populated with the next tick of interest.  This is either
+   ///   the next expiration or the next cascade of a higher level, whichever
+   ///   comes first.
+   /// @return True if the wheel contains any timers, otherwise False.
+   Bool getNextExpiration(ULongLong &tick) const;
+
+private:
+   enum { LevelBits = 8, Levels = 4, Slots = 1 << LevelBits, SlotMask = Slots - 1 };
+
+   Void add(Node &node);
+   Void cascade(Int level, Int index);
+
+   ULongLong m_current;
+   size_t m_count;
+   Node *m_wheel[Levels][Slots];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 /// @cond DOXYGEN_EXCLUDE
 class _EThreadEventNotification
 {
@@ -821,6 +1881,56 @@ public:
 };
 /// @endcond
 
+/// @brief Defines how an EThreadEventTimer is driven.
+enum class EThreadEventTimerMode
+{
+   /// a CLOCK_REALTIME POSIX timer raises SIGRTMIN and the signal handler
+   ///   posts the EM_TIMER event to the thread's event queue
+   Signal,
+   /// the owning thread keeps the timer and expires it from its own wait
+   ///   (the event queue wait or the socket event demultiplexer) using
+   ///   CLOCK_MONOTONIC, no signals or event queue messages are involved
+   EventLoop
+};
+
+class EThreadEventTimer;
+
+/// @cond DOXYGEN_EXCLUDE
+class _EThreadEventTimerScheduler
+{
+public:
+   _EThreadEventTimerScheduler();
+   ~_EThreadEventTimerScheduler();
+
+   Void setWakeup(_EThreadEventNotification *notify, _EThreadEventMessageBase *msg);
+   Void setRunning(Bool running);
+   Bool empty() const { return m_timers.empty(); }
+
+   Void attach(EThreadEventTimer &t);
+   Void detach(EThreadEventTimer &t);
+   Void start(EThreadEventTimer &t);
+   Void stop(EThreadEventTimer &t);
+
+   Void expire();
+   EThreadEventTimer *nextExpired();
+   LongLong getTimeout();
+
+private:
+   static LongLong now();
+   Void removePending(EThreadEventTimer &t);
+
+   EMutexPrivate m_mutex;
+   ETimerWheel m_wheel;
+   ULongLong m_nextTick;
+   std::vector<EThreadEventTimer*> m_timers;
+   std::deque<EThreadEventTimer*> m_pending;
+   _EThreadEventNotification *m_notify;
+   _EThreadEventMessageBase *m_wakeup;
+   pthread_t m_owner;
+   Bool m_running;
+};
+/// @endcond
+
 /// @brief Thread timer class.
 /// @details EThreadBase::Timer represents an individual timer.  When the
 /// timer expires, the EM_TIMER event will be raised.  The application
@@ -828,11 +1938,12 @@ public:
 class EThreadEventTimer : public EStatic
 {
    friend class EThreadEventTimerHandler;
+   friend class _EThreadEventTimerScheduler;
    template <class TQueue, class TMessage> friend class EThreadEvent;
    template <class TQueue, class TMessage, class TWorker> friend class EThreadEventWorkGroup;
 /// @cond DOXYGEN_EXCLUDE
 protected:
-   Void init(_EThreadEventNotification *notify, _EThreadEventMessageBase *msg)
+   Void init(_EThreadEventNotification *notify, _EThreadEventMessageBase *msg, _EThreadEventTimerScheduler *scheduler = NULL)
    {
       if (isInitialized())
          throw EThreadTimerError_AlreadyInitialized();
@@ -840,12 +1951,20 @@ protected:
       m_notify = notify;
       m_msg = msg;
 
-      struct sigevent sev = {};
-      sev.sigev_notify = SIGEV_SIGNAL;
-      sev.sigev_signo = SIGRTMIN;
-      sev.sigev_value.sival_ptr = this;
-      if (timer_create(CLOCK_REALTIME, &sev, &m_timer) == -1)
-         throw EThreadTimerError_UnableToInitialize();
+      if (scheduler)
+      {
+         m_scheduler = scheduler;
+         m_scheduler->attach(*this);
+      }
+      else
+      {
+         struct sigevent sev = {};
+         sev.sigev_notify = SIGEV_SIGNAL;
+         sev.sigev_signo = SIGRTMIN;
+         sev.sigev_value.sival_ptr = this;
+         if (timer_create(CLOCK_REALTIME, &sev, &m_timer) == -1)
+            throw EThreadTimerError_UnableToInitialize();
+      }
       m_initialized = True;
    }
 /// @endcond
@@ -853,6 +1972,7 @@ protected:
 public:
    /// @brief Default class constructor.
    EThreadEventTimer()
+      : m_node(*this)
    {
       m_initialized = False;
       // assign the id
@@ -863,11 +1983,13 @@ public:
       m_interval = 0;
       m_oneshot = True;
       m_timer = NULL;
+      m_scheduler = NULL;
    }
    /// @brief Class constructor with configuration parameters.
    /// @param milliseconds the number of milliseconds before the timer expires
    /// @param oneshot True - one shot timer, False - periodic (recurring) timer
    EThreadEventTimer(Long milliseconds, Bool oneshot = False)
+      : m_node(*this)
    {
       m_initialized = False;
       // assign the id
@@ -878,6 +2000,7 @@ public:
       m_interval = milliseconds;
       m_oneshot = oneshot;
       m_timer = NULL;
+      m_scheduler = NULL;
    }      /// @brief Class destructor.
    ~EThreadEventTimer()
    {
@@ -891,8 +2014,16 @@ public:
       if (isInitialized())
       {
          stop();
-         timer_delete(m_timer);
-         m_timer = NULL;
+         if (m_scheduler)
+         {
+            m_scheduler->detach(*this);
+            m_scheduler = NULL;
+         }
+         else
+         {
+            timer_delete(m_timer);
+            m_timer = NULL;
+         }
          m_initialized = False;
       }
       if (m_msg)
@@ -910,6 +2041,12 @@ public:
       if (!isInitialized())
          throw EThreadTimerError_NotInitialized();
 
+      if (m_scheduler)
+      {
+         m_scheduler->start(*this);
+         return;
+      }
+
       struct itimerspec its;
       its.it_value.tv_sec = m_interval / 1000;              // seconds
       its.it_value.tv_nsec = (m_interval % 1000) * 1000000; // nano-seconds
@@ -923,6 +2060,12 @@ public:
    {
       if (isInitialized())
       {
+         if (m_scheduler)
+         {
+            m_scheduler->stop(*this);
+            return;
+         }
+
          struct itimerspec its;
          its.it_value.tv_sec = 0;  // seconds
          its.it_value.tv_nsec = 0; // nano-seconds
@@ -960,9 +2103,21 @@ public:
    /// The timer ID is created internally when the timer object is
    /// instantiated.
    Bool isInitialized() { return m_initialized; }
+   /// @brief Retrieves how this timer is driven.
+   /// @return EThreadEventTimerMode::EventLoop if the timer was initialized
+   ///   by a thread using the event loop timer mode, otherwise
+   ///   EThreadEventTimerMode::Signal.
+   EThreadEventTimerMode getMode() { return m_scheduler ? EThreadEventTimerMode::EventLoop : EThreadEventTimerMode::Signal; }
 
 protected:
    /// @cond DOXYGEN_EXCLUDE
+   struct SchedulerNode : public ETimerWheel::Node
+   {
+      SchedulerNode(EThreadEventTimer &t) : timer(t), pending(False) {}
+      EThreadEventTimer &timer;
+      Bool pending;
+   };
+
    static void _timerHandler(int signo, siginfo_t *pinfo, void *pcontext)
    {
       EThreadEventTimer *timer = (EThreadEventTimer*)pinfo->si_value.sival_ptr;
@@ -981,6 +2136,8 @@ private:
    Bool m_oneshot;
    LongLong m_interval;
    timer_t m_timer;
+   _EThreadEventTimerScheduler *m_scheduler;
+   SchedulerNode m_node;
 };
 
 /// @cond DOXYGEN_EXCLUDE
@@ -1010,6 +2167,124 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+/// @cond DOXYGEN_EXCLUDE
+/// @brief The message maps of a class and its base classes flattened into a
+///   single table keyed by the message ID.
+/// @details The table is built the first time a user event is dispatched.
+///   The handler in the most derived class wins when more than one map
+///   defines the same message ID.  Message ID's that span a small range are
+///   indexed directly, otherwise an open addressed hash table is used.
+template <class TMap, class TFn>
+class _EThreadEventDispatchTable
+{
+public:
+   _EThreadEventDispatchTable()
+      : m_built(False),
+        m_dense(True),
+        m_base(0),
+        m_mask(0)
+   {
+   }
+
+   Bool built() const
+   {
+      return m_built;
+   }
+
+   Void build(const TMap *pMap)
+   {
+      std::vector<std::pair<UInt,TFn>> entries;
+      UInt lo = UINT_MAX;
+      UInt hi = 0;
+
+      // interate through each map starting with the most derived class
+      for (; pMap && pMap->pfnGetBaseMap != NULL; pMap = (*pMap->pfnGetBaseMap)())
+      {
+         for (auto pEntries = pMap->lpEntries; pEntries->nMessage; pEntries++)
+         {
+            Bool found = False;
+            for (auto &e : entries)
+            {
+               if (e.first == pEntries->nMessage)
+               {
+                  found = True;
+                  break;
+               }
+            }
+            if (found)
+               continue;
+            entries.push_back(std::make_pair(pEntries->nMessage, pEntries->pFn));
+            lo = std::min(lo, pEntries->nMessage);
+            hi = std::max(hi, pEntries->nMessage);
+         }
+      }
+
+      m_handlers.clear();
+      m_slots.clear();
+
+      if (entries.empty() || hi - lo < DenseRange)
+      {
+         m_dense = True;
+         m_base = entries.empty() ? 0 : lo;
+         if (!entries.empty())
+            m_handlers.assign(hi - lo + 1, NULL);
+         for (auto &e : entries)
+            m_handlers[e.first - m_base] = e.second;
+      }
+      else
+      {
+         // keep the hash table at most half full
+         size_t size = 16;
+         while (size < entries.size() * 2)
+            size <<= 1;
+         m_dense = False;
+         m_mask = static_cast<UInt>(size - 1);
+         m_slots.assign(size, std::make_pair(0U, static_cast<TFn>(NULL)));
+         for (auto &e : entries)
+         {
+            UInt i = hash(e.first);
+            while (m_slots[i].first != 0)
+               i = (i + 1) & m_mask;
+            m_slots[i] = e;
+         }
+      }
+
+      m_built = True;
+   }
+
+   TFn find(UInt id) const
+   {
+      if (m_dense)
+      {
+         UInt idx = id - m_base;
+         return idx < m_handlers.size() ? m_handlers[idx] : NULL;
+      }
+
+      for (UInt i = hash(id); m_slots[i].first != 0; i = (i + 1) & m_mask)
+      {
+         if (m_slots[i].first == id)
+            return m_slots[i].second;
+      }
+      return NULL;
+   }
+
+private:
+   static const UInt DenseRange = 1024;
+
+   UInt hash(UInt id) const
+   {
+      return (id * 2654435761U) & m_mask;
+   }
+
+   Bool m_built;
+   Bool m_dense;
+   UInt m_base;
+   UInt m_mask;
+   std::vector<TFn> m_handlers;
+   std::vector<std::pair<UInt,TFn>> m_slots;
+};
+/// @endcond
+
 /// @brief Inserts message map declarations into the thread class.
 /// @details This macro should be used in the event thread class definition.
 #define DECLARE_MESSAGE_MAP()                                  \
@@ -1084,8 +2359,15 @@ public:
         m_arg(NULL),
         m_stacksize(0),
         m_suspendCnt(0),
-        m_suspendSem(0)
+        m_suspendSem(0),
+        m_timerMode(EThreadEventTimerMode::Signal),
+        m_timerWakeup(EM_WAKEUP),
+        m_batchSize(1),
+        m_batchCnt(0),
+        m_batchPos(0),
+        m_batch(1)
    {
+      m_timers.setWakeup(this, &m_timerWakeup);
    }
    /// @brief The class destructor.
    ~EThreadEvent()
@@ -1134,6 +2416,75 @@ public:
          onMessageQueued(msg);
       return result;
    }
+   /// @brief Sends event message to this thread with a priority.
+   /// @param msg the message thread message object to send.
+   /// @param priority the message priority, 0 is the default priority.
+   /// @param wait waits for the message to be sent
+   /// @details
+   /// Sends (posts) the supplied event message to this thread's event queue
+   /// ahead of the queued messages with a lower priority.  This requires a
+   /// queue that supports priorities, such as EThreadQueueLockFree, see
+   /// setQueuePriorities().
+   Bool sendPriorityMessage(const TMessage &msg, Int priority, Bool wait = True)
+   {
+      Bool result = m_queue.push(msg, wait, priority);
+      if (result)
+         onMessageQueued(msg);
+      return result;
+   }
+   /// @brief Configures the number of message priorities of the event queue.
+   ///   This must be called before init().
+   /// @param priorities the number of priorities.
+   /// @param policy the policy used to select the priority to dequeue from.
+   /// @param weight the maximum number of consecutive higher priority
+   ///   messages for EThreadQueuePolicy::Weighted.
+   Void setQueuePriorities(Int priorities, EThreadQueuePolicy policy = EThreadQueuePolicy::Strict, Int weight = 16)
+   {
+      m_queue.setPriorities(priorities, policy, weight);
+   }
+   /// @brief Returns the number of messages waiting in the event queue.
+   /// @return the number of messages waiting in the event queue.
+   Int queueDepth()
+   {
+      return m_queue.depth();
+   }
+   /// @brief Returns the maximum number of messages in the event queue.
+   /// @return the maximum number of messages in the event queue.
+   Int queueSize()
+   {
+      return m_queue.queueSize();
+   }
+   /// @brief Returns the maximum number of event messages removed from the
+   ///   event queue at a time.
+   /// @return the maximum number of event messages removed at a time.
+   Int messageBatchSize() const
+   {
+      return m_batchSize;
+   }
+   /// @brief Assigns the maximum number of event messages removed from the
+   ///   event queue at a time.  This must be called before init() or from
+   ///   onInit().
+   /// @param size the maximum number of event messages removed at a time.
+   ///   A value greater than 1 makes pumpMessages() dispatch the messages
+   ///   with pumpMessageBatch().
+   Void setMessageBatchSize(Int size)
+   {
+      m_batchSize = std::max(size, 1);
+      m_batch.resize(std::max(m_batchSize, m_batchCnt));
+   }
+   /// @brief Retrieves the policy used to wait for the next event message.
+   /// @return the wait policy.
+   const EThreadWaitPolicy &getWaitPolicy() const
+   {
+      return m_waitPolicy;
+   }
+   /// @brief Assigns the policy used to wait for the next event message.
+   ///   This must be called before init() or from onInit().
+   /// @param policy the wait policy.
+   Void setWaitPolicy(const EThreadWaitPolicy &policy)
+   {
+      m_waitPolicy = policy;
+   }
 
    /// @brief Initializes the thread object.
    /// @param appId identifies the application this thread is associated with.
@@ -1150,7 +2501,7 @@ public:
       m_queueSize = queueSize;
       m_stacksize = stackSize;
 
-      long id = m_appId * 100000 + 10000 + m_threadId;
+      long id = EThreadQueueId::thread(m_appId, m_threadId);
 
       m_queue.init(m_queueSize, id, True, EThreadQueueMode::ReadWrite);
 
@@ -1198,9 +2549,22 @@ public:
    virtual Void onSuspend()
    {
    }
-   /// @brief Called in the context of the thread when th EM_TIMER event is processed.
-   /// @param ptimer a pointer to the EThreadBase::Timer object that expired
-   virtual Void onTimer(EThreadEventTimer *ptimer)
+   /// @brief Called in the context of the thread when th EM_TIMER event is processed.
+   /// @param ptimer a pointer to the EThreadBase::Timer object that expired
+   virtual Void onTimer(EThreadEventTimer *ptimer)
+   {
+   }
+   /// @brief Called in the context of the thread before pumpMessageBatch()
+   ///   dispatches a batch of event messages.
+   /// @param count the number of event messages in the batch.
+   virtual Void onMessageBatchBegin(Int count)
+   {
+   }
+   /// @brief Called in the context of the thread after pumpMessageBatch()
+   ///   dispatches a batch of event messages.  Work that can be shared by
+   ///   the messages, such as flushing output, can be done once here.
+   /// @param count the number of event messages dispatched.
+   virtual Void onMessageBatchEnd(Int count)
    {
    }
    /// @brief Intializes an EThreadEvent::Timer object and associates with this thread.
@@ -1209,8 +2573,18 @@ public:
    {
       TMessage *msg = new TMessage(EM_TIMER);
       msg->setVoidPtr(&t);
-      t.init(this, msg);
-   }
+      t.init(this, msg, m_timerMode == EThreadEventTimerMode::EventLoop ? &m_timers : NULL);
+   }
+   /// @brief Retrieves the mode used by timers initialized with initTimer().
+   /// @return the timer mode.
+   EThreadEventTimerMode getTimerMode() { return m_timerMode; }
+   /// @brief Assigns the mode used by timers initialized with initTimer().
+   /// @param mode the timer mode.  Timers that have already been initialized
+   ///   are not affected.
+   /// @details In EThreadEventTimerMode::EventLoop mode the timers expire in
+   ///   the context of this thread while it waits for the next event, so a
+   ///   timer callback is never delayed behind the messages already queued.
+   Void setTimerMode(EThreadEventTimerMode mode) { m_timerMode = mode; }
    /// @brief Returns the semaphore associated with this thread's event queue.
    ESemaphoreData &getMsgSemaphore()
    {
@@ -1268,17 +2642,117 @@ protected:
    ///
    Bool pumpMessage(TMessage &msg, Bool wait = true)
    {
-      Bool bMsg = m_queue.pop(msg, wait);
+      Bool bMsg;
+
+      if (wait && !m_timers.empty())
+      {
+         // wait no longer than the next event loop timer expiration
+         LongLong timeout = dispatchTimers();
+         bMsg = pollQueue([this, &msg]() { return m_queue.pop(msg, False); }) ||
+            (timeout < 0 ? m_queue.pop(msg, True) : m_queue.timedPop(msg, timeout));
+      }
+      else
+      {
+         bMsg = (wait && pollQueue([this, &msg]() { return m_queue.pop(msg, False); })) ||
+            m_queue.pop(msg, wait);
+      }
+
       if (bMsg)
          dispatch(msg);
 
       return bMsg;
    }
+   /// @brief Dispatches up to messageBatchSize() event messages that are
+   ///   removed from the event queue at once.
+   /// @param msg populated with the last event message dispatched.
+   /// @param wait waits for the next EThreadMessage to be processed.
+   /// @return the number of event messages dispatched.
+   /// @details
+   /// onMessageBatchBegin() and onMessageBatchEnd() are called around the
+   /// batch.  The batch ends early after an EM_QUIT or EM_SUSPEND event so
+   /// the caller can act on it, the remaining messages are dispatched by
+   /// the next call.
+   ///
+   Int pumpMessageBatch(TMessage &msg, Bool wait = true)
+   {
+      if (m_batchPos >= m_batchCnt)
+      {
+         m_batchPos = 0;
+         m_batchCnt = 0;
+
+         auto poll = [this]() { return (m_batchCnt = m_queue.popBatch(m_batch.data(), m_batchSize, False)) > 0; };
+
+         if (wait && !m_timers.empty())
+         {
+            // wait no longer than the next event loop timer expiration
+            LongLong timeout = dispatchTimers();
+            if (!pollQueue(poll))
+            {
+               if (timeout < 0)
+                  m_batchCnt = m_queue.popBatch(m_batch.data(), m_batchSize, True);
+               else if (m_queue.timedPop(m_batch[0], timeout))
+                  m_batchCnt = 1 + m_queue.popBatch(m_batch.data() + 1, m_batchSize - 1, False);
+            }
+         }
+         else if (!wait || !pollQueue(poll))
+         {
+            m_batchCnt = m_queue.popBatch(m_batch.data(), m_batchSize, wait);
+         }
+
+         if (m_batchCnt == 0)
+            return 0;
+      }
+
+      Int cnt = 0;
+      onMessageBatchBegin(m_batchCnt - m_batchPos);
+      while (m_batchPos < m_batchCnt)
+      {
+         TMessage &m = m_batch[m_batchPos++];
+         dispatch(m);
+         cnt++;
+         if (m.getMessageId() == EM_QUIT || m.getMessageId() == EM_SUSPEND)
+         {
+            msg = m;
+            break;
+         }
+         if (m_batchPos == m_batchCnt)
+            msg = m;
+      }
+      onMessageBatchEnd(cnt);
+
+      return cnt;
+   }
+   /// @brief Raises EM_TIMER for each expired event loop timer.
+   /// @return the number of microseconds until the next event loop timer
+   ///   expires or -1 if there are no running event loop timers.
+   /// @details
+   /// This method is called by the thread's event loop before waiting for the
+   /// next event.  An overridden pumpMessages() that does not wait in
+   /// pumpMessage() must call it and limit its wait to the returned value.
+   ///
+   LongLong dispatchTimers()
+   {
+      if (m_timers.empty())
+         return -1;
+
+      m_timers.expire();
+
+      EThreadEventTimer *t;
+      while ((t = m_timers.nextExpired()) != NULL)
+      {
+         // the timer may be destroyed by the handler, so dispatch a copy
+         TMessage msg(*static_cast<TMessage*>(t->m_msg));
+         dispatch(msg);
+      }
+
+      return m_timers.getTimeout();
+   }
    /// @brief Process event messages.
    /// @throws EError catches and re-throws any exception raised by pumpMessage
    /// @details
    /// Any overridden version of pumpMessages() must call pumpMessage() to
-   /// process each individual message.
+   /// process each individual message.  When messageBatchSize() is greater
+   /// than 1 the messages are processed with pumpMessageBatch().
    ///
    virtual Void pumpMessages()
    {
@@ -1290,7 +2764,7 @@ protected:
       {
          while (True)
          {
-            if (pumpMessage(msg))
+            if (m_batchSize > 1 ? pumpMessageBatch(msg) > 0 : pumpMessage(msg))
             {
                if (msg.getMessageId() == EM_QUIT)
                   break;
@@ -1328,35 +2802,38 @@ protected:
 private:
    Dword threadProc(pVoid arg)
    {
+      m_timers.setRunning(True);
       pumpMessages();
+      m_timers.setRunning(False);
       return 0;
    }
 
+   template <class TPoll>
+   Bool pollQueue(TPoll poll)
+   {
+      // a busy polling thread raises the event loop timers itself
+      return m_waitPolicy.poll(poll, [this]() { dispatchTimers(); });
+   }
+
    Bool dispatch(TMessage &msg)
    {
       Bool keepgoing = True;
-      const msgmap_t *pMap;
-      const msgentry_t *pEntries;
 
       if (msg.getMessageId() >= EM_USER)
       {
-         // interate through each map
-         for (pMap = GetMessageMap(); keepgoing && pMap && pMap->pfnGetBaseMap != NULL; pMap = (*pMap->pfnGetBaseMap)())
+         if (!m_dispatch.built())
+            m_dispatch.build(GetMessageMap());
+
+         msgfxn_t pFn = m_dispatch.find(msg.getMessageId());
+         if (pFn)
          {
-            // interate through each entry for the map
-            for (pEntries = pMap->lpEntries; pEntries->nMessage; pEntries++)
-            {
-               if (pEntries->nMessage == msg.getMessageId())
-               {
-                  (this->*pEntries->pFn)(msg);
-                  keepgoing = False;
-                  break;
-               }
-            }
+            (this->*pFn)(msg);
+            keepgoing = False;
          }
-
-         if (pMap == NULL)
+         else
+         {
             defaultMessageHandler(msg);
+         }
       }
       else
       {
@@ -1383,10 +2860,23 @@ private:
    UShort m_threadId;
    Int m_queueSize;
    TQueue m_queue;
+
+   EThreadEventTimerMode m_timerMode;
+   _EThreadEventTimerScheduler m_timers;
+   TMessage m_timerWakeup;
+   _EThreadEventDispatchTable<msgmap_t,msgfxn_t> m_dispatch;
+
+   Int m_batchSize;
+   Int m_batchCnt;
+   Int m_batchPos;
+   std::vector<TMessage> m_batch;
+
+   EThreadWaitPolicy m_waitPolicy;
 };
 
 typedef EThreadEvent<EThreadQueuePublic<EThreadMessage>,EThreadMessage> EThreadPublic;
 typedef EThreadEvent<EThreadQueuePrivate<EThreadMessage>,EThreadMessage> EThreadPrivate;
+typedef EThreadEvent<EThreadQueueLockFree<EThreadMessage>,EThreadMessage> EThreadLockFree;
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -1518,9 +3008,16 @@ protected:
       : EThreadBasic(),
         m_workerid(0),
         m_queue(nullptr),
+        m_ownqueue(nullptr),
+        m_steal(False),
+        m_idle(0),
         m_arg(nullptr),
         m_stacksize(0),
-        m_tid(-1)
+        m_tid(-1),
+        m_measure(False),
+        m_busy(0),
+        m_processed(0),
+        m_retired(False)
    {
    }
    /// @brief The class destructor.
@@ -1543,6 +3040,8 @@ protected:
    /// @param arg an argument that will be passed through to the internal thread procedure.
    ///   Currently not used.
    /// @param stackSize the stack size.
+   /// @details When the work group uses per worker dispatch, the worker's own
+   ///   queue is assigned by the work group before init() is called.
    virtual Void init(TQueue &queue, Int workerid, pVoid arg, Dword stackSize = 0)
    {
       m_queue = &queue;
@@ -1585,9 +3084,25 @@ protected:
    ///
    Bool pumpMessage(TMessage &msg, Bool wait = true)
    {
-      Bool bMsg = m_queue->pop(msg, wait);
+      Bool bMsg = wait && m_waitPolicy.poll(
+         [this, &msg]() { return m_ownqueue ? popOwn(msg, False) : m_queue->pop(msg, False); }, []() {});
+      if (!bMsg)
+         bMsg = m_ownqueue ? popOwn(msg, wait) : m_queue->pop(msg, wait);
       if (bMsg)
-         dispatch(msg);
+      {
+         if (m_measure)
+         {
+            // single writer, the work group autoscaler only reads the totals
+            ULongLong start = EThreadWorkGroupScaling::now();
+            dispatch(msg);
+            m_busy.store(m_busy.load(std::memory_order_relaxed) + EThreadWorkGroupScaling::now() - start, std::memory_order_relaxed);
+            m_processed.store(m_processed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+         }
+         else
+         {
+            dispatch(msg);
+         }
+      }
 
       return bMsg;
    }
@@ -1609,7 +3124,7 @@ protected:
          {
             if (pumpMessage(msg))
             {
-               if (msg.getMessageId() == EM_QUIT)
+               if (msg.getMessageId() == EM_QUIT || msg.getMessageId() == EM_RETIRE)
                   break;
             }
          }
@@ -1647,37 +3162,84 @@ private:
       return 0;
    }
 
+   // Retrieves the next message when the work group uses per worker queues.
+   //   Messages for this worker (keyed and quit) are processed first, followed
+   //   by any keyless messages in the work group queue when work stealing is
+   //   enabled.  The idle flag is raised before the final check of the work
+   //   group queue so that a sender posting a keyless message will either be
+   //   seen here or will see the flag and post an EM_WAKEUP to this worker.
+   Bool popOwn(TMessage &msg, Bool wait)
+   {
+      while (True)
+      {
+         if (m_ownqueue->pop(msg, False))
+         {
+            if (msg.getMessageId() == EM_WAKEUP)
+               continue;
+            return True;
+         }
+
+         if (m_steal && m_queue->pop(msg, False))
+            return True;
+
+         if (!wait)
+            return False;
+
+         if (m_steal)
+         {
+            m_idle.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_queue->pop(msg, False))
+            {
+               m_idle.store(0, std::memory_order_relaxed);
+               return True;
+            }
+         }
+
+         m_ownqueue->pop(msg, True);
+         m_idle.store(0, std::memory_order_relaxed);
+         if (msg.getMessageId() != EM_WAKEUP)
+            return True;
+      }
+   }
+
+   Bool wake()
+   {
+      if (m_idle.load(std::memory_order_relaxed) && m_idle.exchange(0, std::memory_order_relaxed))
+      {
+         TMessage msg(EM_WAKEUP);
+         m_ownqueue->push(msg, False);
+         return True;
+      }
+      return False;
+   }
+
    Bool dispatch(TMessage &msg)
    {
       Bool keepgoing = True;
-      const msgmap_t *pMap;
-      const msgentry_t *pEntries;
 
       if (msg.getMessageId() >= EM_USER)
       {
-         // interate through each map
-         for (pMap = (msgmap_t*)GetMessageMap(); keepgoing && pMap && pMap->pfnGetBaseMap != NULL; pMap = (msgmap_t*)(*pMap->pfnGetBaseMap)())
+         if (!m_dispatch.built())
+            m_dispatch.build((msgmap_t*)GetMessageMap());
+
+         msgfxnvoid_t pFn = m_dispatch.find(msg.getMessageId());
+         if (pFn)
          {
-            // interate through each entry for the map
-            for (pEntries = pMap->lpEntries; pEntries->nMessage; pEntries++)
-            {
-               if (pEntries->nMessage == msg.getMessageId())
-               {
-                  (this->*((void(EThreadEventWorkerBase::*)(TMessage&))pEntries->pFn))(msg);
-                  keepgoing = False;
-                  break;
-               }
-            }
+            (this->*((void(EThreadEventWorkerBase::*)(TMessage&))pFn))(msg);
+            keepgoing = False;
          }
-
-         if (pMap == NULL)
+         else
+         {
             defaultMessageHandler(msg);
+         }
       }
       else
       {
          switch (msg.getMessageId())
          {
             case EM_QUIT:     { onQuit(); break; }
+            case EM_RETIRE:   { retire(); break; }
             case EM_TIMER:    { onTimer( (EThreadEventTimer*)msg.getVoidPtr() ); break; }
             default:          { break; }
          }
@@ -1686,20 +3248,69 @@ private:
       return keepgoing;
    }
 
+   // Processes any messages that were posted to this worker's own queue while
+   //   the retire message was in flight before the worker exits.  The work
+   //   group reaps the worker once m_retired is set.
+   Void retire()
+   {
+      if (m_ownqueue)
+      {
+         TMessage msg;
+         while (m_ownqueue->pop(msg, False))
+         {
+            UInt id = msg.getMessageId();
+            if (id != EM_WAKEUP && id != EM_QUIT && id != EM_RETIRE)
+               dispatch(msg);
+         }
+      }
+      onQuit();
+      m_retired.store(True, std::memory_order_release);
+   }
+
    Int m_workerid;
    TQueue *m_queue;
+   TQueue *m_ownqueue;
+   Bool m_steal;
+   std::atomic<Int> m_idle;
    pVoid m_arg;
    size_t m_stacksize;
    pid_t m_tid;
+   _EThreadEventDispatchTable<msgmap_t,msgfxnvoid_t> m_dispatch;
+   EThreadWaitPolicy m_waitPolicy;
+   Bool m_measure;
+   std::atomic<ULongLong> m_busy;
+   std::atomic<ULongLong> m_processed;
+   std::atomic<Bool> m_retired;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+/// @brief Defines how a work group distributes event messages to its workers.
+enum class EThreadWorkGroupDispatch
+{
+   /// All workers pop from a single work group queue.
+   Shared,
+   /// Each worker has its own queue.  Messages with a dispatch key are always
+   ///   delivered to the same worker, keyless messages are distributed round
+   ///   robin or, when work stealing is enabled, are processed by the first
+   ///   idle worker.
+   PerWorker
+};
+
 /// @brief Work group template definition.  The work group contains the event
 ///   queue that all of the associated worker threads will process.  Worker
 ///   threads can be added and removed at runtime as more or lessing processing
 ///   capacity is requried.
+/// @details With EThreadWorkGroupDispatch::PerWorker, override dispatchKey()
+///   to identify the key (SEID, remote node, etc.) for a message.  All messages
+///   that share a key are processed in order by one worker.  Keys are hashed
+///   over the minimum number of workers so that adding a worker at runtime
+///   does not move a key to a different worker.
+///
+///   Workers above the minimum are added and retired with addWorker() and
+///   removeWorker(), or automatically by the autoscaler when an enabled
+///   EThreadWorkGroupScaling is assigned with setScaling().
 template <class TQueue, class TMessage, class TWorker>
 class EThreadEventWorkGroup : public _EThreadEventNotification
 {
@@ -1714,23 +3325,121 @@ public:
         m_queueSize(0),
         m_minWorkers(0),
         m_maxWorkers(0),
-        m_actvWorkers(0)
+        m_actvWorkers(0),
+        m_dispatch(EThreadWorkGroupDispatch::Shared),
+        m_stealing(False),
+        m_workerqueues(nullptr),
+        m_nextWorker(0),
+        m_scaler(nullptr),
+        m_scaleStats(),
+        m_lastCheck(0),
+        m_lastBusy(0),
+        m_lastProcessed(0),
+        m_retiredBusy(0),
+        m_retiredProcessed(0),
+        m_lastScale(0),
+        m_lowSince(0)
    {
    }
    /// @brief The class destructor.
    ~EThreadEventWorkGroup()
    {
-      for (int i=0; i<m_actvWorkers; i++)
+      stopScaling();
+      for (auto &worker : m_workers)
       {
-         delete m_workers[i];
-         m_workers[i] = nullptr;
+         delete worker;
+         worker = nullptr;
       }
+      if (m_workerqueues)
+         delete [] m_workerqueues;
+      m_workerqueues = nullptr;
+   }
+
+   /// @brief Retrieves the dispatch mode.
+   /// @return the dispatch mode.
+   EThreadWorkGroupDispatch getDispatchMode() const { return m_dispatch; }
+   /// @brief Assigns the dispatch mode.  Must be called before init().  With
+   ///   EThreadWorkGroupDispatch::PerWorker, the work group ID must be less
+   ///   than EThreadQueueId::MaxWorkerQueueGroups and the maximum number of
+   ///   workers must not exceed EThreadQueueId::MaxWorkerQueues.  Keyed
+   ///   messages are not compatible with autoscaling, see setScaling().
+   /// @param mode the dispatch mode.
+   /// @return a reference to this object.
+   EThreadEventWorkGroup &setDispatchMode(EThreadWorkGroupDispatch mode) { m_dispatch = mode; return *this; }
+   /// @brief Retrieves the work stealing setting.
+   /// @return True if idle workers process keyless messages, otherwise False.
+   Bool getWorkStealing() const { return m_stealing; }
+   /// @brief Assigns the work stealing setting for keyless messages when using
+   ///   per worker dispatch.  Must be called before init().
+   /// @param stealing if True, keyless messages are processed by the first idle
+   ///   worker, otherwise they are distributed round robin.
+   /// @return a reference to this object.
+   EThreadEventWorkGroup &setWorkStealing(Bool stealing) { m_stealing = stealing; return *this; }
+   /// @brief Retrieves the policy the workers use to wait for the next event message.
+   /// @return the wait policy.
+   const EThreadWaitPolicy &getWaitPolicy() const { return m_waitPolicy; }
+   /// @brief Assigns the policy the workers use to wait for the next event
+   ///   message.  Must be called before init().
+   /// @param policy the wait policy.
+   /// @return a reference to this object.
+   EThreadEventWorkGroup &setWaitPolicy(const EThreadWaitPolicy &policy) { m_waitPolicy = policy; return *this; }
+   /// @brief Retrieves the placement of the workers.
+   /// @return the placement of the workers.
+   const EThreadPlacement &getPlacement() const { return m_placement; }
+   /// @brief Assigns the placement of the workers.  Must be called before
+   ///   init().  When EThreadPlacement::spread() is set, each worker runs on
+   ///   a single CPU selected round robin by its worker index.
+   /// @param placement the placement of the workers.
+   /// @return a reference to this object.
+   EThreadEventWorkGroup &setPlacement(const EThreadPlacement &placement) { m_placement = placement; return *this; }
+   /// @brief Retrieves the autoscaling policy.
+   /// @return the autoscaling policy.
+   const EThreadWorkGroupScaling &getScaling() const { return m_scaling; }
+   /// @brief Assigns the autoscaling policy.  Must be called before init().
+   ///   Keyed messages are only dispatched to the minimum number of workers,
+   ///   so init() throws EThreadWorkGroupError_ScalingWithDispatchKeys when
+   ///   scaling is enabled with per worker dispatch and usesDispatchKeys().
+   /// @param scaling the autoscaling policy.
+   /// @return a reference to this object.
+   EThreadEventWorkGroup &setScaling(const EThreadWorkGroupScaling &scaling) { m_scaling = scaling; return *this; }
+   /// @brief Retrieves the autoscaler counters and most recent samples.
+   /// @return a copy of the autoscaler counters.
+   EThreadWorkGroupScalingStats getScalingStats()
+   {
+      EMutexLock l(m_mutex);
+      return m_scaleStats;
    }
+   /// @brief Retrieves the number of active workers, excluding any workers
+   ///   that are being retired.
+   /// @return the number of active workers.
+   Int activeWorkers() const { return m_actvWorkers; }
 
    /// @brief Retrieves indication if this work group object has been initialized.
    /// @return True if initialized, otherwise False.
    Bool isInitialized() { return m_initialized; }
 
+   /// @brief Returns the number of messages waiting in the work group event
+   ///   queue.  With per worker dispatch, this is the number of messages in
+   ///   the busiest queue, either a worker queue or the keyless queue.
+   /// @return the number of messages waiting.
+   Int queueDepth()
+   {
+      Int depth = m_queue.depth();
+      if (m_workerqueues)
+      {
+         for (Int i = 0; i < m_maxWorkers; i++)
+            depth = std::max(depth, m_workerqueues[i].depth());
+      }
+      return depth;
+   }
+   /// @brief Returns the maximum number of messages in the work group event
+   ///   queue, and in each worker queue with per worker dispatch.
+   /// @return the maximum number of messages in the event queue.
+   Int queueSize()
+   {
+      return m_queue.queueSize();
+   }
+
    /// @brief Sends event message to this work group.
    /// @param message the message ID
    /// @param wait waits for the message to be sent
@@ -1740,7 +3449,7 @@ public:
    Bool sendMessage(UInt message, Bool wait = True)
    {
       TMessage msg(message);
-      Bool result = m_queue.push(msg, wait);
+      Bool result = post(msg, wait);
       if (result)
          onMessageQueued(msg);
       return result;
@@ -1756,7 +3465,7 @@ public:
    {
       TMessage msg(message);
       msg.setVoidPtr(voidptr);
-      Bool result = m_queue.push(msg, wait);
+      Bool result = post(msg, wait);
       if (result)
          onMessageQueued(msg);
       return result;
@@ -1768,7 +3477,7 @@ public:
    /// Sends (posts) the supplied event message to the work groups' event queue.
    Bool sendMessage(const TMessage &msg, Bool wait = True)
    {
-      Bool result = m_queue.push(msg, wait);
+      Bool result = post(msg, wait);
       if (result)
          onMessageQueued(msg);
       return result;
@@ -1785,6 +3494,8 @@ public:
    ///   Currently not used.
    /// @param suspended if True, the thread is not initialized until start() is called.
    /// @param stackSize the stack size.
+   /// @throws EThreadWorkGroupError_ScalingWithDispatchKeys if autoscaling is
+   ///   enabled with per worker dispatch of keyed messages.
    virtual Void init(Short appId, UShort workGroupId, Int minWorkers, Int maxWorkers = -1,
       Int queueSize = 16384, pVoid arg = nullptr, Bool suspended = False, Dword stackSize = 0)
    {
@@ -1796,10 +3507,25 @@ public:
       m_minWorkers = minWorkers;
       m_maxWorkers = maxWorkers < minWorkers ? minWorkers : maxWorkers;
 
-      long id = m_appId * 100000 + 20000 + m_workGroupId;
+      // a keyed message must always reach the same worker, so the keys are
+      //   never remapped to the workers added by the autoscaler
+      if (m_dispatch == EThreadWorkGroupDispatch::PerWorker && m_scaling.enabled() &&
+          m_maxWorkers > m_minWorkers && usesDispatchKeys())
+         throw EThreadWorkGroupError_ScalingWithDispatchKeys();
+
+      long id = EThreadQueueId::workGroup(m_appId, m_workGroupId);
 
       m_queue.init(m_queueSize, id, True, EThreadQueueMode::ReadWrite, True);
 
+      if (m_dispatch == EThreadWorkGroupDispatch::PerWorker)
+      {
+         // throws before allocating if the IDs are outside the reserved range
+         EThreadQueueId::worker(m_appId, m_workGroupId, m_maxWorkers - 1);
+         m_workerqueues = new TQueue[m_maxWorkers];
+         for (Int i = 0; i < m_maxWorkers; i++)
+            m_workerqueues[i].init(m_queueSize, EThreadQueueId::worker(m_appId, m_workGroupId, i), True, EThreadQueueMode::ReadWrite);
+      }
+
       if (!suspended)
          start();
    }
@@ -1808,13 +3534,32 @@ public:
    Void join()
    {
       for (auto worker : m_workers)
-         worker->join();
+      {
+         if (worker)
+            worker->join();
+      }
    }
-   /// @brief Posts the quit message to all of the worker threads.
+   /// @brief Posts the quit message to all of the worker threads.  The
+   ///   autoscaler is stopped first so that no workers are added afterwards.
    Void quit()
    {
+      stopScaling();
+      EMutexLock l(m_mutex);
       for (int i=0; i<m_actvWorkers; i++)
-         sendMessage(EM_QUIT);
+      {
+         TMessage msg(EM_QUIT);
+         Bool result;
+         // with work stealing the quit messages follow any keyless messages
+         //   through the work group queue so that those are processed first
+         if (!m_workerqueues)
+            result = m_queue.push(msg);
+         else if (m_stealing)
+            result = postKeyless(msg, True);
+         else
+            result = m_workerqueues[i].push(msg);
+         if (result)
+            onMessageQueued(msg);
+      }
    }
    /// @brief Initializes the thread when it was suspended at init().
    Void start()
@@ -1828,18 +3573,135 @@ public:
             if (i < m_minWorkers)
                addWorker();
          }
+
+         if (m_scaling.enabled() && m_maxWorkers > m_minWorkers)
+         {
+            EMutexLock l(m_mutex);
+            m_lastCheck = m_lastScale = EThreadWorkGroupScaling::now();
+            if (m_scaling.interval() > 0 && !m_scaler)
+            {
+               m_scaler = new Scaler(*this);
+               m_scaler->init(nullptr);
+            }
+         }
       }
    }
 
    /// @brief Creates a new worker thread if the current number of workers
    ///   is less than the maximum configured.
+   /// @return True if a worker was added, otherwise False.
    Bool addWorker()
    {
       EMutexLock l(m_mutex);
-      if (m_actvWorkers >= m_maxWorkers)
-         return False;
-      addWorker(m_actvWorkers++);
-      return True;
+      return _addWorker();
+   }
+   /// @brief Retires the most recently added worker thread if the current
+   ///   number of workers is greater than the minimum configured.
+   /// @return True if a worker is being retired, otherwise False.
+   /// @details The worker processes the messages already in its queue, calls
+   ///   onQuit() and exits.  With shared dispatch, the worker that retires is
+   ///   the first one to retrieve the retire message.  The worker thread
+   ///   object is deleted by a later call to addWorker(), removeWorker() or
+   ///   checkScaling(), which also forwards any message that was posted to
+   ///   the retired worker's queue after it exited.
+   Bool removeWorker()
+   {
+      EMutexLock l(m_mutex);
+      return _removeWorker();
+   }
+
+   /// @brief Performs an autoscaler check.  This is called by the autoscaler
+   ///   thread every EThreadWorkGroupScaling::interval() milliseconds, an
+   ///   application that sets the interval to zero calls it periodically.
+   Void checkScaling()
+   {
+      EThreadWorkGroupScaleEvent evt;
+      Bool scaled = False;
+
+      {
+         EMutexLock l(m_mutex);
+         reapWorkers();
+
+         ULongLong now = EThreadWorkGroupScaling::now();
+         ULongLong busy = m_retiredBusy;
+         ULongLong processed = m_retiredProcessed;
+         for (auto worker : m_workers)
+         {
+            if (worker)
+            {
+               busy += worker->m_busy.load(std::memory_order_relaxed);
+               processed += worker->m_processed.load(std::memory_order_relaxed);
+            }
+         }
+
+         ULongLong elapsed = now - m_lastCheck;
+         ULongLong dBusy = busy - m_lastBusy;
+         ULongLong dProcessed = processed - m_lastProcessed;
+         m_lastCheck = now;
+         m_lastBusy = busy;
+         m_lastProcessed = processed;
+
+         Int workers = std::max(m_actvWorkers.load(std::memory_order_relaxed), 1);
+         Int depth = queueDepth();
+         Int busyPct = elapsed > 0 ? static_cast<Int>(std::min<ULongLong>(100, dBusy * 100 / (elapsed * workers))) : 0;
+         // the queued messages are processed at the average rate of the workers
+         LongLong latency = dProcessed > 0 ?
+            static_cast<LongLong>(static_cast<ULongLong>(depth) * (dBusy / dProcessed) / workers / 1000) : 0;
+
+         m_scaleStats.checks++;
+         m_scaleStats.depth = depth;
+         m_scaleStats.busy = busyPct;
+         m_scaleStats.latency = latency;
+
+         evt.before = m_actvWorkers;
+         evt.depth = depth;
+         evt.busy = busyPct;
+         evt.latency = latency;
+
+         Bool up = True;
+         if (m_scaling.scaleUpDepth() > 0 && depth >= m_scaling.scaleUpDepth())
+            evt.reason = EThreadWorkGroupScaleReason::Backlog;
+         else if (m_scaling.scaleUpLatency() > 0 && latency >= m_scaling.scaleUpLatency())
+            evt.reason = EThreadWorkGroupScaleReason::Latency;
+         else if (m_scaling.scaleUpBusy() > 0 && busyPct >= m_scaling.scaleUpBusy())
+            evt.reason = EThreadWorkGroupScaleReason::Busy;
+         else
+            up = False;
+
+         ULongLong coolDown = static_cast<ULongLong>(m_scaling.coolDown()) * 1000000;
+         if (up)
+         {
+            m_lowSince = 0;
+            for (Int i = 0; i < m_scaling.step() && _addWorker(); i++)
+               scaled = True;
+            if (scaled)
+               m_scaleStats.scaleUps++;
+         }
+         else if (busyPct < m_scaling.scaleDownBusy())
+         {
+            if (m_lowSince == 0)
+               m_lowSince = now;
+            if (now - m_lowSince >= coolDown && now - m_lastScale >= coolDown && _removeWorker())
+            {
+               evt.reason = EThreadWorkGroupScaleReason::Idle;
+               m_scaleStats.scaleDowns++;
+               scaled = True;
+            }
+         }
+         else
+         {
+            m_lowSince = 0;
+         }
+
+         if (scaled)
+         {
+            m_lastScale = now;
+            evt.after = m_actvWorkers;
+         }
+      }
+
+      if (scaled)
+         onScaleWorkers(evt);
    }
 
    /// @brief Intializes an EThreadEvent::Timer object and associates
@@ -1871,27 +3733,224 @@ protected:
    virtual Void onCreateWorker(TWorker &worker)
    {
    }
+   /// @brief Called in the context of the autoscaler after it has added or
+   ///   retired workers.
+   /// @param evt describes the change and the samples that caused it.
+   virtual Void onScaleWorkers(const EThreadWorkGroupScaleEvent &evt)
+   {
+   }
+   /// @brief Retrieves the dispatch key for a message when using per worker
+   ///   dispatch.  This method is called in the context of the thread where
+   ///   sendMessage() is called and must not modify the message.
+   /// @param msg the message being sent.
+   /// @param key populated with the dispatch key.
+   /// @return True if the message has a dispatch key, False if it is keyless.
+   virtual Bool dispatchKey(TMessage &msg, ULongLong &key)
+   {
+      return False;
+   }
+   /// @brief Indicates if dispatchKey() returns a key for any message.  A
+   ///   derived class that overrides dispatchKey() should also override this
+   ///   method so that init() can reject an autoscaling policy that would
+   ///   never dispatch keyed messages to the added workers.
+   /// @return True if messages may have a dispatch key, otherwise False.
+   virtual Bool usesDispatchKeys() const
+   {
+      return False;
+   }
+   /// @brief Maps a dispatch key to a worker.
+   /// @param key the dispatch key.
+   /// @param workers the number of workers to choose from.
+   /// @return the index of the worker, 0 through workers - 1.
+   virtual Int dispatchWorker(ULongLong key, Int workers)
+   {
+      // a multiplicative hash spreads sequentially allocated keys such as SEIDs
+      return static_cast<Int>(((key * 0x9E3779B97F4A7C15ULL) >> 32) % static_cast<ULongLong>(workers));
+   }
 
 private:
+   Bool postKeyless(const TMessage &msg, Bool wait)
+   {
+      if (!m_queue.push(msg, wait))
+         return False;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      for (Int i = 0; i < m_actvWorkers; i++)
+      {
+         TWorker *worker = m_workers[i];
+         if (worker && worker->wake())
+            break;
+      }
+      return True;
+   }
+
+   Bool post(const TMessage &msg, Bool wait)
+   {
+      if (!m_workerqueues)
+         return m_queue.push(msg, wait);
+
+      ULongLong key;
+      if (dispatchKey(const_cast<TMessage&>(msg), key))
+      {
+         Int workers = m_minWorkers > 0 ? m_minWorkers : m_actvWorkers.load(std::memory_order_acquire);
+         return m_workerqueues[dispatchWorker(key, workers)].push(msg, wait);
+      }
+
+      if (m_stealing)
+         return postKeyless(msg, wait);
+
+      // a sender that read the count before a worker was retired can still
+      //   post to the retired worker's queue, reapWorkers() forwards these
+      Int workers = m_actvWorkers.load(std::memory_order_acquire);
+      if (workers < 1)
+         workers = 1;
+      return m_workerqueues[m_nextWorker.fetch_add(1, std::memory_order_relaxed) % workers].push(msg, wait);
+   }
+
    Bool _sendTimerExpiration(const _EThreadEventMessageBase &msg, Bool wait = True)
    {
-      Bool result = m_queue.push(static_cast<const TMessage &>(msg), wait);
+      Bool result = post(static_cast<const TMessage &>(msg), wait);
       if (result)
          onMessageQueued(static_cast<const TMessage &>(msg));
       return result;
    }
    Bool _sendThreadMessage(const _EThreadEventMessageBase &msg, Bool wait = True)
    {
-      Bool result = m_queue.push(static_cast<const TMessage &>(msg), wait);
+      Bool result = post(static_cast<const TMessage &>(msg), wait);
       if (result)
          onMessageQueued(static_cast<const TMessage &>(msg));
       return result;
    }
 
+   class Scaler : public EThreadBasic
+   {
+   public:
+      Scaler(EThreadEventWorkGroup &group)
+         : m_group(group)
+      {
+      }
+      Void stop()
+      {
+         m_stop.set();
+      }
+   protected:
+      Dword threadProc(pVoid arg)
+      {
+         while (!m_stop.wait(m_group.m_scaling.interval()))
+            m_group.checkScaling();
+         return 0;
+      }
+   private:
+      EThreadEventWorkGroup &m_group;
+      EEvent m_stop;
+   };
+
+   Void stopScaling()
+   {
+      if (m_scaler)
+      {
+         m_scaler->stop();
+         m_scaler->join();
+         delete m_scaler;
+         m_scaler = nullptr;
+      }
+   }
+
+   // Deletes the worker thread objects of the workers that have retired.
+   //   With per worker dispatch, any message that was posted to the queue of
+   //   a retired worker after it drained its queue is forwarded to one of the
+   //   active workers, or to the work group queue when work stealing is
+   //   enabled.  The message was already counted by onMessageQueued().
+   Void reapWorkers()
+   {
+      for (auto &worker : m_workers)
+      {
+         if (worker && worker->m_retired.load(std::memory_order_acquire))
+         {
+            worker->join();
+            m_retiredBusy += worker->m_busy.load(std::memory_order_relaxed);
+            m_retiredProcessed += worker->m_processed.load(std::memory_order_relaxed);
+            delete worker;
+            worker = nullptr;
+         }
+      }
+
+      Int actvWorkers = m_actvWorkers.load(std::memory_order_relaxed);
+      if (!m_workerqueues || actvWorkers < 1)
+         return;
+      for (Int idx = actvWorkers; idx < m_maxWorkers; idx++)
+      {
+         if (m_workers[idx])
+            continue;
+         TMessage msg;
+         while (m_workerqueues[idx].pop(msg, False))
+         {
+            UInt id = msg.getMessageId();
+            if (id != EM_WAKEUP && id != EM_QUIT && id != EM_RETIRE)
+               post(msg, True);
+         }
+      }
+   }
+
+   Bool _addWorker()
+   {
+      if (m_actvWorkers >= m_maxWorkers)
+         return False;
+
+      reapWorkers();
+
+      // per worker dispatch distributes keyless messages over the first
+      //   m_actvWorkers queues, so the workers are kept contiguous
+      Int idx = m_actvWorkers.load(std::memory_order_relaxed);
+      if (!m_workerqueues)
+      {
+         for (idx = 0; idx < m_maxWorkers && m_workers[idx]; idx++);
+         if (idx == m_maxWorkers)
+            return False;
+      }
+      else if (m_workers[idx])
+      {
+         // the retiring worker in this slot has not exited yet
+         return False;
+      }
+
+      addWorker(idx);
+      Int actvWorkers = ++m_actvWorkers;
+      m_scaleStats.peakWorkers = std::max(m_scaleStats.peakWorkers, actvWorkers);
+      return True;
+   }
+
+   Bool _removeWorker()
+   {
+      if (m_actvWorkers <= m_minWorkers)
+         return False;
+
+      reapWorkers();
+
+      TMessage msg(EM_RETIRE);
+      Int idx = --m_actvWorkers;
+      // keyed messages are never dispatched to a worker above the minimum
+      if (m_workerqueues ? m_workerqueues[idx].push(msg) : m_queue.push(msg))
+      {
+         onMessageQueued(msg);
+         return True;
+      }
+
+      m_actvWorkers++;
+      return False;
+   }
+
    Void addWorker(Int idx)
    {
       TWorker *worker = new TWorker();
       // worker->setGroup(*this);
+      if (m_workerqueues)
+      {
+         worker->m_ownqueue = &m_workerqueues[idx];
+         worker->m_steal = m_stealing;
+      }
+      worker->m_waitPolicy = m_waitPolicy;
+      worker->m_measure = m_scaling.enabled();
+      worker->setPlacement(m_placement.forIndex(idx));
       m_workers[idx] = worker;
       worker->init(m_queue, idx + 1, m_arg, m_stacksize);
       onCreateWorker(*worker);
@@ -1909,8 +3968,27 @@ private:
 
    Int m_minWorkers;
    Int m_maxWorkers;
-   Int m_actvWorkers;
+   // read without the lock by the senders
+   std::atomic<Int> m_actvWorkers;
    std::vector<TWorker*> m_workers;
+
+   EThreadWorkGroupDispatch m_dispatch;
+   Bool m_stealing;
+   TQueue *m_workerqueues;
+   std::atomic<UInt> m_nextWorker;
+   EThreadWaitPolicy m_waitPolicy;
+   EThreadPlacement m_placement;
+
+   EThreadWorkGroupScaling m_scaling;
+   Scaler *m_scaler;
+   EThreadWorkGroupScalingStats m_scaleStats;
+   ULongLong m_lastCheck;
+   ULongLong m_lastBusy;
+   ULongLong m_lastProcessed;
+   ULongLong m_retiredBusy;
+   ULongLong m_retiredProcessed;
+   ULongLong m_lastScale;
+   ULongLong m_lowSince;
 };
 
 using EThreadWorkerPublic = EThreadEventWorker<EThreadQueuePublic<EThreadMessage>,EThreadMessage>;
@@ -1919,6 +3997,9 @@ template <class TWorker> using EThreadWorkGroupPublic = EThreadEventWorkGroup<ET
 using EThreadWorkerPrivate = EThreadEventWorker<EThreadQueuePrivate<EThreadMessage>,EThreadMessage>;
 template <class TWorker> using EThreadWorkGroupPrivate = EThreadEventWorkGroup<EThreadQueuePrivate<EThreadMessage>,EThreadMessage,TWorker>;
 
+using EThreadWorkerLockFree = EThreadEventWorker<EThreadQueueLockFree<EThreadMessage>,EThreadMessage>;
+template <class TWorker> using EThreadWorkGroupLockFree = EThreadEventWorkGroup<EThreadQueueLockFree<EThreadMessage>,EThreadMessage,TWorker>;
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
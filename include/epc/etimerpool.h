@@ -18,7 +18,7 @@
 #define __ETIMERPOOL_H
 
 #include <atomic>
-#include <unordered_map>
+#include <vector>
 
 #include <sys/time.h>
 #include <pthread.h>
@@ -30,31 +30,27 @@
 
 DECLARE_ERROR_ADVANCED(ETimerPoolError_CreatingTimer);
 DECLARE_ERROR_ADVANCED(ETimerPoolError_TimerSetTimeFailed);
+DECLARE_ERROR_ADVANCED(ETimerPoolError_TooManyTimers);
 
 /// @brief Defines the timer expiration callback function.
 typedef Void (*ETimerPoolExpirationCallback)(ULong timerid, pVoid data);
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief A pool of expiration timers that post a thread message or call a
+///   callback function when they expire.
+/// @details The timers are kept in an ETimerWheel that is driven by a single
+///   CLOCK_MONOTONIC timerfd serviced by the timer pool thread.  Registering
+///   and unregistering a timer is O(1) and only makes a system call when the
+///   new timer expires before the timerfd is currently armed for.
 class ETimerPool
 {
 protected:
    // forward declarations
-   class Timer;
-   typedef std::shared_ptr<Timer> TimerPtr;
-   typedef std::list<TimerPtr> TimerPtrList;
-
    class Entry;
-   typedef std::shared_ptr<Entry> EntryPtr;
-   typedef std::unordered_map<ULong,EntryPtr> EntryMap;
-
-   class ExpirationTime;
-   class ExpirationTimeEntry;
-   typedef std::shared_ptr<ExpirationTimeEntry> ExpirationTimeEntryPtr;
-   typedef std::unordered_map<LongLong,ExpirationTimeEntryPtr> ExpirationTimeEntryMap;
-   typedef std::unordered_map<ULong,ExpirationTimeEntryPtr> ExpirationTimeEntryIdMap;
-
    class Thread;
 
-   friend ExpirationTime;
 public:
    /// @brief Defines how rounding will be performed.
    enum class Rounding
@@ -87,13 +83,29 @@ public:
    /// @return the current rounding value.
    Rounding getRounding()                 { return m_rounding; }
    /// @brief Retrieves the current timer signal value.
+   /// @details Retained for compatibility, the timer pool no longer uses signals.
    /// @return the current timer signal value.
    Int getTimerSignal()                   { return m_sigtimer; }
    /// @brief Retrieves the current quit signal value.
+   /// @details Retained for compatibility, the timer pool no longer uses signals.
    /// @return the current quit signal value.
    Int getQuitSignal()                    { return m_sigquit; }
 
-   /// @brief Assigns the timer resolution value.
+   /// @brief Retrieves the placement of the timer pool thread.
+   /// @return the placement of the timer pool thread.
+   const EThreadPlacement &getPlacement() const { return m_thread.getPlacement(); }
+   /// @brief Retrieves a description of the placement of the timer pool
+   ///   thread once it has started.
+   /// @return the placement report.
+   const EString &getPlacementReport() const { return m_thread.getPlacementReport(); }
+
+   /// @brief Assigns the placement of the timer pool thread.  This must be
+   ///   called before init().
+   /// @param placement the placement.
+   /// @return a reference to the ETimerPool object.
+   ETimerPool &setPlacement(const EThreadPlacement &placement) { m_thread.setPlacement(placement); return *this; }
+   /// @brief Assigns the timer resolution value.  The resolution is the
+   ///   length of a timing wheel tick and must be set before init().
    /// @param ms the resolution in milliseconds.
    /// @return a reference to the ETimerPool object.
    ETimerPool &setResolution(LongLong ms) { m_resolution = ms * 1000;   return *this; }
@@ -102,10 +114,12 @@ public:
    /// @return a reference to the ETimerPool object.
    ETimerPool &setRounding(Rounding r)    { m_rounding = r;             return *this; }
    /// @brief Assigns the timer signal value.
+   /// @details Retained for compatibility, the timer pool no longer uses signals.
    /// @param sig the timer signal value.
    /// @return a reference to the ETimerPool object.
    ETimerPool &setTimerSignal(Int sig)    { m_sigtimer = sig;           return *this; }
    /// @brief Assigns the quit signal value.
+   /// @details Retained for compatibility, the timer pool no longer uses signals.
    /// @param sig the quit signal value.
    /// @return a reference to the ETimerPool object.
    ETimerPool &setQuitSignal(Int sig)     { m_sigquit = sig;            return *this; }
@@ -123,6 +137,14 @@ public:
    /// @return the ID for this timer.
    ULong registerTimer(LongLong ms, ETimerPoolExpirationCallback func, pVoid data);
    /// @brief Unregisters an expiration timer.
+   /// @details If the expiration callback for the timer is in progress,
+   ///   this method waits for it to complete, so the data associated with
+   ///   the timer can be released once this method returns.  When called
+   ///   from the callback itself, this method does not wait.  This method
+   ///   never waits for a timer that posts a thread message, since the
+   ///   caller may be the thread that the message is being posted to, so
+   ///   that thread must ignore an expiration message that is received after
+   ///   the timer was unregistered.
    /// @param timerid the ID of the timer to unregister (returned by registerTimer).
    /// @return a reference to the ETimerPool object.
    ETimerPool &unregisterTimer(ULong timerid);
@@ -137,89 +159,6 @@ public:
 protected:
    /// @cond DOXYGEN_EXCLUDE
    /////////////////////////////////////////////////////////////////////////////
-   
-   class Timer
-   {
-      friend class ETimerPool;
-
-   public:
-      Timer();
-      ~Timer();
-
-      Bool create(pid_t tid, int sig);
-
-      Timer &setExpirationTimeEntry(ExpirationTimeEntryPtr &etep) { m_etep = etep; return *this; }
-      ExpirationTimeEntryPtr &getExpirationTimeEntry() { return m_etep; }
-      Timer & clearExpirationTimeEntry() { m_etep.reset(); return *this; }
-
-      Void start();
-      Void stop();
-
-      timer_t getHandle() { return m_timer; }
-
-   private:
-      timer_t m_timer;
-      ExpirationTimeEntryPtr m_etep;
-   };
-
-   /////////////////////////////////////////////////////////////////////////////
-   
-   class ExpirationTime
-   {
-   public:
-      ExpirationTime()
-         : m_duration(0),
-           m_expiretime(0)
-      {
-      }
-      ExpirationTime(LongLong ms, Rounding rounding = Instance().m_rounding)
-         : m_duration(0),
-           m_expiretime(0)
-      {
-         setDuration( ms, rounding );
-      }
-      ExpirationTime(const ExpirationTime &exptm)
-         : m_duration(0),
-           m_expiretime(0)
-      {
-         m_duration = exptm.m_duration;
-         m_expiretime = exptm.m_expiretime;
-      }
-
-      ExpirationTime &operator=(const ExpirationTime et)
-      {
-         m_duration = et.m_duration;
-         m_expiretime = et.m_expiretime;
-         return *this;
-      }
-
-      LongLong getDuration() { return m_duration; }
-      ExpirationTime &setDuration(LongLong ms, Rounding rounding = Instance().m_rounding)
-      {
-         LongLong resolution = Instance().getResolution(True);
-
-         m_duration = ms;
-
-         ETime et = ETime() + ETime(m_duration);
-
-         m_expiretime =
-            ((et.getTimeVal().tv_sec * 1000000 + et.getTimeVal().tv_usec % 1000000) / resolution +
-            (rounding == Rounding::down ? 0 : 1)) * resolution;
-
-         return *this;
-      }
-
-      LongLong getExpireTime()
-      {
-         return m_expiretime;
-      }
-
-   private:
-      LongLong m_duration; // in milliseconds
-      LongLong m_expiretime; // m_expiretime = tv_sec * 1000000 + tv_usec % 1000000;
-   };
-   
-   /////////////////////////////////////////////////////////////////////////////
 
    enum class ExpirationInfoType
    {
@@ -313,101 +252,47 @@ protected:
          } cb;         
       } u;
    };
-   
-   class Entry
+
+   /////////////////////////////////////////////////////////////////////////////
+
+   // The timer ID is the index of the entry in the entry table combined with
+   //   a generation number that changes each time the entry is reused.  Free
+   //   entries are reused in FIFO order so that a stale ID is unlikely to
+   //   match a reused entry.
+   class Entry : public ETimerWheel::Node
    {
    public:
-      Entry(ULong id, ExpirationTime &exptm, const ExpirationInfo &info)
-         : m_id( id ),
-           m_exptm( exptm ),
-           m_info( info )
-      {
-      }
-      Entry(const Entry &e)
-         : m_id( e.m_id ),
-           m_exptm( e.m_exptm ),
-           m_info( e.m_info )
+      enum { IndexBits = 20, MaxEntries = 1 << IndexBits, GenerationMask = (1 << (32 - IndexBits)) - 1 };
+
+      Entry(UInt index)
+         : m_index(index),
+           m_generation(1),
+           m_duration(0),
+           m_firing(False),
+           m_cancelled(False),
+           m_nextfree(nullptr)
       {
       }
 
-      ULong getId()                       { return m_id; }
+      ULong getId()                       { return (m_generation << IndexBits) | m_index; }
       ExpirationInfo &getExpirationInfo() { return m_info; }
-      ExpirationTime &getExpirationTime() { return m_exptm; }
+      LongLong getDuration()              { return m_duration; }
 
       Void notify();
 
    private:
+      friend class ETimerPool;
       Entry();
 
-      ULong m_id;
-      ExpirationTime m_exptm;
+      UInt m_index;
+      UInt m_generation;
+      LongLong m_duration; // in milliseconds
+      Bool m_firing;
+      Bool m_cancelled;
+      Entry *m_nextfree;
       ExpirationInfo m_info;
    };
 
-   class ExpirationTimeEntry
-   {
-   public:
-      ExpirationTimeEntry(LongLong expiretime)
-         : m_expiretime( expiretime )
-      {
-      }
-
-      LongLong getExpireTime() { return m_expiretime; }
-      ExpirationTimeEntry &setExpireTime(LongLong exp) { m_expiretime = exp; return *this; }
-
-      ExpirationTimeEntry &addEntry(EntryPtr &ep)
-      {
-         m_map[ep->getId()] = ep;
-         return *this;
-      }
-
-      Void removeEntry(ULong id)
-      {
-         m_map.erase( id );
-      }
-
-      Bool isEntryMapEmpty()
-      {
-         return m_map.empty();
-      }
-
-      ExpirationTimeEntry &setTimer(TimerPtr &tp)
-      {
-         m_timer = tp;
-         return *this;
-      }
-
-      TimerPtr &getTimer()
-      {
-         return m_timer;
-      }
-
-      EntryMap &getEntryMap()
-      {
-         return m_map;
-      }
-
-      ExpirationTimeEntry &notify()
-      {
-         for (auto it = m_map.begin(); it != m_map.end();)
-         {
-            // send the notificaiton for the entry
-            it->second->notify();
-
-            // remove the entry
-            it = m_map.erase( it );
-         }
-
-	 return *this;
-      }
-
-   private:
-      ExpirationTimeEntry();
-      LongLong m_expiretime;
-      TimerPtr m_timer;
-      EntryMap m_map;
-   };
-
    /////////////////////////////////////////////////////////////////////////////
    
    class Thread : public EThreadBasic
@@ -432,7 +317,7 @@ protected:
 
    /////////////////////////////////////////////////////////////////////////////
 
-   Void sendNotifications(ExpirationTimeEntryPtr &etep);
+   Void sendNotifications();
 
    /// @endcond
 
@@ -440,18 +325,27 @@ private:
    static ETimerPool *m_instance;
 
    ULong _registerTimer(LongLong ms, const ETimerPool::ExpirationInfo &info);
-   ULong assignNextId();
-   ETimerPool &removeExpirationTimeEntry(ETimerPool::ExpirationTimeEntryPtr &etep);
+   Entry *allocEntry();
+   Void freeEntry(Entry *entry);
+   Entry *findEntry(ULong timerid);
+   ULongLong currentTick();
+   Void arm(ULongLong tick);
 
    EMutexPrivate m_mutex;
-   std::atomic<ULong> m_nextid;
    Int m_sigtimer;
    Int m_sigquit;
    Rounding m_rounding;
    LongLong m_resolution; // in microseconds
-   ExpirationTimeEntryMap m_etmap;
-   ExpirationTimeEntryIdMap m_etidmap;
-   TimerPtrList m_freetimers;
+   ETimerWheel m_wheel;
+   std::vector<Entry*> m_entries;
+   Entry *m_freehead;
+   Entry *m_freetail;
+   Int m_timerfd;
+   Int m_quitfd;
+   ULongLong m_armed;
+   Entry *m_notifying;
+   Int m_notifyWaiters;
+   ESemaphorePrivate m_notifyDone;
    Thread m_thread;
 };
 
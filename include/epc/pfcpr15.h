@@ -66,24 +66,58 @@ class LengthCalculator
 {
 public:
    LengthCalculator(LengthCalculator *parent)
-      : parent_(parent)
+      : parent_(parent),
+        grouped_(False)
    {
+      if (parent_)
+         parent_->grouped_ = True;
    }
 
    virtual Void setLength()
    {
-      if (parent_)
+      if (parent_ && !deferred_)
          parent_->setLength();
    }
 
    virtual uint16_t length() const = 0;
    virtual uint16_t packedLength() const = 0;
 
+   /// @brief Indicates if the lengths of grouped IEs are deferred until the
+   ///   message is encoded for messages built by the calling thread.
+   static Bool deferLengths()                   { return deferred_; }
+   /// @brief Assigns whether the lengths of grouped IEs are deferred until
+   ///   the message is encoded for messages built by the calling thread.
+   /// @details By default, setting an IE recalculates the length of every
+   ///   grouped IE that contains it, so building a message with many grouped
+   ///   IEs is roughly quadratic.  When deferred, only the length of the IE
+   ///   being set is calculated and the lengths of the grouped IEs are
+   ///   calculated once, bottom up, by encode().  Until then, length() and
+   ///   present() of a grouped IE are not valid.
+   /// @param defer True to defer the grouped IE length calculations.
+   /// @return the assigned value.
+   static Bool setDeferLengths(Bool defer)      { return deferred_ = defer; }
+
+   /// @brief Calculates the lengths of grouped IEs while in scope.
+   class Finalizer
+   {
+   public:
+      Finalizer() : prev_(finalizing_) { finalizing_ = True; }
+      ~Finalizer() { finalizing_ = prev_; }
+   private:
+      Bool prev_;
+   };
+
 protected:
    virtual uint16_t calculateLength() = 0;
 
+   Bool grouped() const                         { return grouped_; }
+   static Bool finalizing()                     { return finalizing_; }
+
 private:
    LengthCalculator *parent_;
+   Bool grouped_;
+   static thread_local Bool deferred_;
+   static thread_local Bool finalizing_;
 };
 
 class IEHeader : public LengthCalculator
@@ -93,7 +127,13 @@ public:
    IEHeader &type(uint16_t type)       { hdr_.type = type; return *this; }
 
    uint16_t length() const             { return hdr_.len; }
-   uint16_t packedLength() const       { return hdr_.len > 0 ? hdr_.len + sizeof(hdr_) : 0; }
+   uint16_t packedLength() const
+   {
+      // a grouped IE sums the lengths of its members, calculated first
+      if (grouped() && finalizing())
+         hdr_.len = const_cast<IEHeader*>(this)->calculateLength();
+      return hdr_.len > 0 ? hdr_.len + sizeof(hdr_) : 0;
+   }
    Void setLength()                    { hdr_.len = calculateLength(); LengthCalculator::setLength(); }
    Bool present() const                { return hdr_.len != 0; }
 
@@ -971,6 +1011,7 @@ class PfcpSmReqFlagsIE : public IEHeader
 {
    friend class UpdateForwardingParametersIE;
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    Bool drobu() const;
    Bool sndem() const;
@@ -1067,6 +1108,7 @@ public:
    uint8_t timer_value() const;
    TimerIE &timer_unit(TimerTimerUnitEnum val);
    TimerIE &timer_unit(uint8_t val);
+   TimerIE &timer_value(uint8_t val);
    pfcp_timer_ie_t &data();
 
 protected:
@@ -1108,6 +1150,7 @@ class FSeidIE : public IEHeader
    friend class SessionEstablishmentReq;
    friend class SessionEstablishmentRsp;
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    Bool v4() const;
    Bool v6() const;
@@ -1161,6 +1204,7 @@ class NodeIdIE : public IEHeader
    friend class NodeReportRsp;
    friend class SessionSetDeletionReq;
    friend class SessionSetDeletionRsp;
+   friend class MessageView;
 public:
    NodeIdTypeEnum node_id_type() const;
    const in_addr &node_id_value_ipv4_address() const;
@@ -1354,6 +1398,7 @@ class FqCsidIE : public IEHeader
    friend class SessionEstablishmentReq;
    friend class SessionEstablishmentRsp;
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    FqCsidNodeIdTypeEnum fqcsid_node_id_type() const;
    uint8_t number_of_csids() const;
@@ -2273,6 +2318,7 @@ enum class PdnTypeEnum : uint8_t
 class PdnTypeIE : public IEHeader
 {
    friend class SessionEstablishmentReq;
+   friend class MessageView;
 public:
    PdnTypeEnum pdn_type() const;
    PdnTypeIE &pdn_type(PdnTypeEnum val);
@@ -2387,6 +2433,7 @@ class UserPlaneInactivityTimerIE : public IEHeader
 {
    friend class SessionEstablishmentReq;
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    uint32_t user_plane_inact_timer() const;
    UserPlaneInactivityTimerIE &user_plane_inact_timer(uint32_t val);
@@ -2535,6 +2582,7 @@ class QueryUrrReferenceIE : public IEHeader
    friend class SessionModificationReq;
    friend class UsageReportSessionModificationRspIE;
    friend class UsageReportSessionReportReqIE;
+   friend class MessageView;
 public:
    uint32_t query_urr_ref_val() const;
    QueryUrrReferenceIE &query_urr_ref_val(uint32_t val);
@@ -2791,6 +2839,7 @@ private:
 class UserIdIE : public IEHeader
 {
    friend class SessionEstablishmentReq;
+   friend class MessageView;
 public:
    Bool imsif() const;
    Bool imeif() const;
@@ -2947,6 +2996,7 @@ class TraceInformationIE : public IEHeader
 {
    friend class SessionEstablishmentReq;
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    uint8_t mcc_digit_1() const;
    uint8_t mcc_digit_2() const;
@@ -3161,6 +3211,7 @@ private:
 class ApnDnnIE : public IEHeader
 {
    friend class SessionEstablishmentReq;
+   friend class MessageView;
 public:
    uint16_t apn_dnn_len() const;
    const uint8_t *apn_dnn() const;
@@ -3292,6 +3343,7 @@ class CreateTrafficEndpointIE : public IEHeader
 {
    friend class SessionEstablishmentReq;
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    TrafficEndpointIdIE &traffic_endpt_id();
    FTeidIE &local_fteid();
@@ -3328,6 +3380,7 @@ class CreateBarIE : public IEHeader
 {
    friend class SessionEstablishmentReq;
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    BarIdIE &bar_id();
    DownlinkDataNotificationDelayIE &dnlnk_data_notif_delay();
@@ -3352,6 +3405,7 @@ class CreateQerIE : public IEHeader
 {
    friend class SessionEstablishmentReq;
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    QerIdIE &qer_id();
    QerCorrelationIdIE &qer_corr_id();
@@ -3446,6 +3500,7 @@ class CreateUrrIE : public IEHeader
 {
    friend class SessionEstablishmentReq;
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    UrrIdIE &urr_id();
    MeasurementMethodIE &meas_mthd();
@@ -3583,6 +3638,7 @@ class CreateFarIE : public IEHeader
 {
    friend class SessionEstablishmentReq;
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    FarIdIE &far_id();
    ApplyActionIE &apply_action();
@@ -3694,6 +3750,7 @@ class CreatePdrIE : public IEHeader
 {
    friend class SessionEstablishmentReq;
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    PdrIdIE &pdr_id();
    PrecedenceIE &precedence();
@@ -3847,6 +3904,7 @@ private:
 class RemoveTrafficEndpointIE : public IEHeader
 {
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    TrafficEndpointIdIE &traffic_endpt_id();
    pfcp_rmv_traffic_endpt_ie_t &data();
@@ -3866,6 +3924,7 @@ private:
 class UpdateTrafficEndpointIE : public IEHeader
 {
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    TrafficEndpointIdIE &traffic_endpt_id();
    FTeidIE &local_fteid();
@@ -3899,6 +3958,7 @@ private:
 class RemoveBarIE : public IEHeader
 {
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    BarIdIE &bar_id();
    pfcp_remove_bar_ie_t &data();
@@ -3918,6 +3978,7 @@ private:
 class UpdateBarSessionModificationReqIE : public IEHeader
 {
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    BarIdIE &bar_id();
    DownlinkDataNotificationDelayIE &dnlnk_data_notif_delay();
@@ -3941,6 +4002,7 @@ private:
 class QueryUrrIE : public IEHeader
 {
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    UrrIdIE &urr_id();    
    pfcp_query_urr_ie_t &data();
@@ -3960,6 +4022,7 @@ private:
 class RemoveQerIE : public IEHeader
 {
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    QerIdIE qer_id();
    pfcp_remove_qer_ie_t &data();
@@ -3979,6 +4042,7 @@ private:
 class RemoveUrrIE : public IEHeader
 {
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    UrrIdIE &urr_id();
    pfcp_remove_urr_ie_t &data();
@@ -3998,6 +4062,7 @@ private:
 class RemoveFarIE : public IEHeader
 {
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    FarIdIE &far_id();
    pfcp_remove_far_ie_t &data();
@@ -4017,6 +4082,7 @@ private:
 class RemovePdrIE : public IEHeader
 {
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    PdrIdIE &pdr_id();
    pfcp_remove_pdr_ie_t &data();
@@ -4036,6 +4102,7 @@ private:
 class UpdateQerIE : public IEHeader
 {
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    QerIdIE &qer_id();
    QerCorrelationIdIE &qer_corr_id();
@@ -4075,6 +4142,7 @@ private:
 class UpdateUrrIE : public IEHeader
 {
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    UrrIdIE &urr_id();
    MeasurementMethodIE &meas_mthd();
@@ -4210,6 +4278,7 @@ private:
 class UpdateFarIE : public IEHeader
 {
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    FarIdIE &far_id();
    ApplyActionIE &apply_action();
@@ -4238,6 +4307,7 @@ private:
 class UpdatePdrIE : public IEHeader
 {
    friend class SessionModificationReq;
+   friend class MessageView;
 public:
    PdrIdIE &pdr_id();
    OuterHeaderRemovalIE &outer_hdr_removal();
@@ -4637,6 +4707,7 @@ public:
    OVERLOADED_NEW_DELETE
 protected:
    Void postDecode();
+   Void finalizeLengths();
 private:
    pfcp_pfd_mgmt_req_t data_;
    std::vector<ApplicationIdsPfdsIE> appids_;
@@ -4890,6 +4961,7 @@ public:
    OVERLOADED_NEW_DELETE
 protected:
    Void postDecode();
+   Void finalizeLengths();
 private:
    pfcp_node_rpt_req_t data_;
    UChar iebuffer_[sizeof(_NodeReportReq)];
@@ -5042,6 +5114,7 @@ public:
    OVERLOADED_NEW_DELETE
 protected:
    Void postDecode();
+   Void finalizeLengths();
 private:
    pfcp_sess_estab_req_t data_;
    UChar iebuffer_[sizeof(_SessionEstablishmentReq)];
@@ -5089,6 +5162,7 @@ public:
    OVERLOADED_NEW_DELETE
 protected:
    Void postDecode();
+   Void finalizeLengths();
 private:
    pfcp_sess_estab_rsp_t data_;
    UChar iebuffer_[sizeof(_SessionEstablishmentRsp)];
@@ -5171,6 +5245,7 @@ public:
    OVERLOADED_NEW_DELETE
 protected:
    Void postDecode();
+   Void finalizeLengths();
 private:
    pfcp_sess_mod_req_t data_;
    UChar iebuffer_[sizeof(_SessionModificationReq)];
@@ -5224,6 +5299,7 @@ public:
    OVERLOADED_NEW_DELETE
 protected:
    Void postDecode();
+   Void finalizeLengths();
 private:
    pfcp_sess_mod_rsp_t data_;
    UChar iebuffer_[sizeof(_SessionModificationRsp)];
@@ -5272,6 +5348,7 @@ public:
    OVERLOADED_NEW_DELETE
 protected:
    Void postDecode();
+   Void finalizeLengths();
 private:
    pfcp_sess_del_rsp_t data_;
    UChar iebuffer_[sizeof(_SessionDeletionRsp)];
@@ -5309,6 +5386,7 @@ public:
    OVERLOADED_NEW_DELETE
 protected:
    Void postDecode();
+   Void finalizeLengths();
 private:
    pfcp_sess_rpt_req_t data_;
    UChar iebuffer_[sizeof(_SessionReportReq)];
@@ -5340,6 +5418,7 @@ public:
    OVERLOADED_NEW_DELETE
 protected:
    Void postDecode();
+   Void finalizeLengths();
 private:
    pfcp_sess_rpt_rsp_t data_;
    UChar iebuffer_[sizeof(_SessionReportRsp)];
@@ -5348,6 +5427,204 @@ private:
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+/// @brief An information element that is decoded by a MessageView the first
+///   time it is accessed.
+template<class TIE, class TData>
+class LazyIE
+{
+   friend class MessageView;
+public:
+   LazyIE() : data_(nullptr), ie_(nullptr) {}
+   LazyIE(LazyIE &&l) : data_(l.data_), ie_(l.ie_) { l.data_ = nullptr; l.ie_ = nullptr; }
+   ~LazyIE() { delete ie_; delete data_; }
+
+   Bool decoded() const { return ie_ != nullptr; }
+
+private:
+   LazyIE(const LazyIE &);
+   LazyIE &operator=(const LazyIE &);
+
+   TData *data_;
+   TIE *ie_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Locates the information elements of a received message without
+///   decoding them.
+/// @details The offset of each top level information element is indexed
+///   with a single pass over the received data.  An information element is
+///   decoded, using the libpfcp decoder for that information element, the
+///   first time it is accessed.  The received data is referenced, when it is
+///   held in a pooled buffer, otherwise it is copied.
+class MessageView
+{
+public:
+   MessageView();
+   ~MessageView();
+
+   Void assign(cpUChar data, UShort len, const EMemory::Buffer *buf = nullptr);
+   UShort count(uint16_t type) const;
+   cpUChar find(uint16_t type, UShort occurrence = 0) const;
+   UShort length() const;
+
+   template<class TIE, class TData, class TDecoder>
+   TIE &decode(LazyIE<TIE,TData> &lazy, uint16_t type, UShort occurrence, TDecoder decoder);
+
+private:
+   MessageView(const MessageView &);
+   MessageView &operator=(const MessageView &);
+
+   struct Entry
+   {
+      uint16_t type;
+      uint16_t offset;
+   };
+
+   EMemory::Buffer buf_;
+   pUChar data_;
+   UShort len_;
+   std::vector<Entry> entries_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief A read-only session establishment request that decodes each
+///   information element the first time it is accessed.
+/// @details The FQ-CSID information elements are accessed by occurrence
+///   since the node that each one describes is not encoded in the message.
+class SessionEstablishmentReqView : public PFCP::AppMsgSessionReq
+{
+public:
+   SessionEstablishmentReqView(PFCP::SessionBaseSPtr &ses, cpUChar data, UShort len, const EMemory::Buffer *buf = nullptr);
+   Bool isView() const override;
+   uint16_t length() const;
+   NodeIdIE &node_id();
+   FSeidIE &cp_fseid();
+   CreateBarIE &create_bar();
+   PdnTypeIE &pdn_type();
+   UserPlaneInactivityTimerIE &user_plane_inact_timer();
+   UserIdIE &user_id();
+   TraceInformationIE &trc_info();
+   ApnDnnIE &apn_dnn();
+   FqCsidIE &fqcsid(uint8_t idx);
+   CreatePdrIE &create_pdr(uint8_t idx);
+   CreateFarIE &create_far(uint8_t idx);
+   CreateUrrIE &create_urr(uint8_t idx);
+   CreateQerIE &create_qer(uint8_t idx);
+   CreateTrafficEndpointIE &create_traffic_endpt(uint8_t idx);
+   int fqcsid_count() const;
+   int create_pdr_count() const;
+   int create_far_count() const;
+   int create_urr_count() const;
+   int create_qer_count() const;
+   int create_traffic_endpt_count() const;
+   CLASS_NAME
+   OVERLOADED_NEW_DELETE
+private:
+   MessageView view_;
+   LazyIE<NodeIdIE,pfcp_node_id_ie_t> node_id_;
+   LazyIE<FSeidIE,pfcp_fseid_ie_t> cp_fseid_;
+   LazyIE<CreateBarIE,pfcp_create_bar_ie_t> create_bar_;
+   LazyIE<PdnTypeIE,pfcp_pdn_type_ie_t> pdn_type_;
+   LazyIE<UserPlaneInactivityTimerIE,pfcp_user_plane_inact_timer_ie_t> user_plane_inact_timer_;
+   LazyIE<UserIdIE,pfcp_user_id_ie_t> user_id_;
+   LazyIE<TraceInformationIE,pfcp_trc_info_ie_t> trc_info_;
+   LazyIE<ApnDnnIE,pfcp_apn_dnn_ie_t> apn_dnn_;
+   std::vector<LazyIE<FqCsidIE,pfcp_fqcsid_ie_t>> fqcsid_;
+   std::vector<LazyIE<CreatePdrIE,pfcp_create_pdr_ie_t>> create_pdr_;
+   std::vector<LazyIE<CreateFarIE,pfcp_create_far_ie_t>> create_far_;
+   std::vector<LazyIE<CreateUrrIE,pfcp_create_urr_ie_t>> create_urr_;
+   std::vector<LazyIE<CreateQerIE,pfcp_create_qer_ie_t>> create_qer_;
+   std::vector<LazyIE<CreateTrafficEndpointIE,pfcp_create_traffic_endpt_ie_t>> create_traffic_endpt_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief A read-only session modification request that decodes each
+///   information element the first time it is accessed.
+/// @details The FQ-CSID information elements are accessed by occurrence
+///   since the node that each one describes is not encoded in the message.
+class SessionModificationReqView : public PFCP::AppMsgSessionReq
+{
+public:
+   SessionModificationReqView(PFCP::SessionBaseSPtr &ses, cpUChar data, UShort len, const EMemory::Buffer *buf = nullptr);
+   Bool isView() const override;
+   uint16_t length() const;
+   FSeidIE &cp_fseid();
+   RemoveBarIE &remove_bar();
+   RemoveTrafficEndpointIE &rmv_traffic_endpt();
+   CreateBarIE &create_bar();
+   CreateTrafficEndpointIE &create_traffic_endpt();
+   UpdateBarSessionModificationReqIE &update_bar();
+   UpdateTrafficEndpointIE &upd_traffic_endpt();
+   PfcpSmReqFlagsIE &pfcpsmreq_flags();
+   UserPlaneInactivityTimerIE &user_plane_inact_timer();
+   QueryUrrReferenceIE &query_urr_ref();
+   TraceInformationIE &trc_info();
+   FqCsidIE &fqcsid(uint8_t idx);
+   RemovePdrIE &remove_pdr(uint8_t idx);
+   RemoveFarIE &remove_far(uint8_t idx);
+   RemoveUrrIE &remove_urr(uint8_t idx);
+   RemoveQerIE &remove_qer(uint8_t idx);
+   CreatePdrIE &create_pdr(uint8_t idx);
+   CreateFarIE &create_far(uint8_t idx);
+   CreateUrrIE &create_urr(uint8_t idx);
+   CreateQerIE &create_qer(uint8_t idx);
+   UpdatePdrIE &update_pdr(uint8_t idx);
+   UpdateFarIE &update_far(uint8_t idx);
+   UpdateUrrIE &update_urr(uint8_t idx);
+   UpdateQerIE &update_qer(uint8_t idx);
+   QueryUrrIE &query_urr(uint8_t idx);
+   int fqcsid_count() const;
+   int remove_pdr_count() const;
+   int remove_far_count() const;
+   int remove_urr_count() const;
+   int remove_qer_count() const;
+   int create_pdr_count() const;
+   int create_far_count() const;
+   int create_urr_count() const;
+   int create_qer_count() const;
+   int update_pdr_count() const;
+   int update_far_count() const;
+   int update_urr_count() const;
+   int update_qer_count() const;
+   int query_urr_count() const;
+   CLASS_NAME
+   OVERLOADED_NEW_DELETE
+private:
+   MessageView view_;
+   LazyIE<FSeidIE,pfcp_fseid_ie_t> cp_fseid_;
+   LazyIE<RemoveBarIE,pfcp_remove_bar_ie_t> remove_bar_;
+   LazyIE<RemoveTrafficEndpointIE,pfcp_rmv_traffic_endpt_ie_t> rmv_traffic_endpt_;
+   LazyIE<CreateBarIE,pfcp_create_bar_ie_t> create_bar_;
+   LazyIE<CreateTrafficEndpointIE,pfcp_create_traffic_endpt_ie_t> create_traffic_endpt_;
+   LazyIE<UpdateBarSessionModificationReqIE,pfcp_upd_bar_sess_mod_req_ie_t> update_bar_;
+   LazyIE<UpdateTrafficEndpointIE,pfcp_upd_traffic_endpt_ie_t> upd_traffic_endpt_;
+   LazyIE<PfcpSmReqFlagsIE,pfcp_pfcpsmreq_flags_ie_t> pfcpsmreq_flags_;
+   LazyIE<UserPlaneInactivityTimerIE,pfcp_user_plane_inact_timer_ie_t> user_plane_inact_timer_;
+   LazyIE<QueryUrrReferenceIE,pfcp_query_urr_ref_ie_t> query_urr_ref_;
+   LazyIE<TraceInformationIE,pfcp_trc_info_ie_t> trc_info_;
+   std::vector<LazyIE<FqCsidIE,pfcp_fqcsid_ie_t>> fqcsid_;
+   std::vector<LazyIE<RemovePdrIE,pfcp_remove_pdr_ie_t>> remove_pdr_;
+   std::vector<LazyIE<RemoveFarIE,pfcp_remove_far_ie_t>> remove_far_;
+   std::vector<LazyIE<RemoveUrrIE,pfcp_remove_urr_ie_t>> remove_urr_;
+   std::vector<LazyIE<RemoveQerIE,pfcp_remove_qer_ie_t>> remove_qer_;
+   std::vector<LazyIE<CreatePdrIE,pfcp_create_pdr_ie_t>> create_pdr_;
+   std::vector<LazyIE<CreateFarIE,pfcp_create_far_ie_t>> create_far_;
+   std::vector<LazyIE<CreateUrrIE,pfcp_create_urr_ie_t>> create_urr_;
+   std::vector<LazyIE<CreateQerIE,pfcp_create_qer_ie_t>> create_qer_;
+   std::vector<LazyIE<UpdatePdrIE,pfcp_update_pdr_ie_t>> update_pdr_;
+   std::vector<LazyIE<UpdateFarIE,pfcp_update_far_ie_t>> update_far_;
+   std::vector<LazyIE<UpdateUrrIE,pfcp_update_urr_ie_t>> update_urr_;
+   std::vector<LazyIE<UpdateQerIE,pfcp_update_qer_ie_t>> update_qer_;
+   std::vector<LazyIE<QueryUrrIE,pfcp_query_urr_ie_t>> query_urr_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 class Translator : public PFCP::Translator
 {
 public:
@@ -5357,6 +5634,10 @@ public:
    PFCP::ReqOutPtr encodeHeartbeatReq(PFCP::SndHeartbeatReqData &hb);
    PFCP::RspOutPtr encodeHeartbeatRsp(PFCP::SndHeartbeatRspData &hb);
    PFCP::RspOutPtr encodeVersionNotSupportedRsp(PFCP::ReqInPtr msg);
+   PFCP::RspOutPtr encodeOverloadRsp(PFCP::ReqInPtr msg, UChar cause);
+   Bool parseHeartbeatReq(cpUChar msg, Int len, ETime &startTime);
+   UShort encodeHeartbeatRspTemplate(PFCP::LocalNode &ln, pUChar dest, UShort len);
+   Void assignRspSeqNbr(pUChar rsp, ULong seqNbr);
 
    PFCP::ReqOutPtr encodeReq(PFCP::AppMsgReqPtr msg);
    PFCP::RspOutPtr encodeRsp(PFCP::AppMsgRspPtr msg);
@@ -5375,8 +5656,22 @@ public:
    PFCP::MsgType pfcpSessionEstablishmentRsp();
    PFCP::MsgType pfcpAssociationSetupReq();
    PFCP::MsgType pfcpAssociationSetupRsp();
+
+   /// @brief Indicates if received session establishment and session
+   ///   modification requests are decoded as views.
+   Bool decodeViews() const               { return views_; }
+   /// @brief Assigns whether received session establishment and session
+   ///   modification requests are decoded as views.
+   /// @details When True, decodeReq() returns a SessionEstablishmentReqView
+   ///   or a SessionModificationReqView instead of a fully decoded
+   ///   SessionEstablishmentReq or SessionModificationReq.  Use
+   ///   PFCP::AppMsg::isView() to determine which was returned.
+   /// @param views True to decode the session requests as views.
+   /// @return a reference to this object.
+   Translator &setDecodeViews(Bool views) { views_ = views; return *this; }
 private:
    EMemory::Pool *mp_[10];
+   Bool views_;
 };
 
 }
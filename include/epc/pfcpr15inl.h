@@ -2002,6 +2002,13 @@ inline TimerIE &TimerIE::timer_unit(uint8_t val)
    return *this;
 }
 
+inline TimerIE &TimerIE::timer_value(uint8_t val)
+{
+   ie_.timer_value = val;
+   setLength();
+   return *this;
+}
+
 inline pfcp_timer_ie_t &TimerIE::data()
 {
    return ie_;
@@ -9746,8 +9753,17 @@ inline int PfdMgmtReq::next_app_ids_pfds()
       data_.app_ids_pfds_count++ : -1;
 }
 
+inline Void PfdMgmtReq::finalizeLengths()
+{
+   LengthCalculator::Finalizer f;
+
+   for (auto &ie : appids_)
+      ie.packedLength();
+}
+
 inline PfdMgmtReq &PfdMgmtReq::encode(uint8_t *dest)
 {
+   finalizeLengths();
    data_.header.seid_seqno.no_seid.seq_no = seqNbr();
    UShort len = encode_pfcp_pfd_mgmt_req_t(&data_, dest);
    data_.header.message_len = len;
@@ -10319,8 +10335,17 @@ inline UserPlanePathFailureReportIE &NodeReportReq::user_plane_path_fail_rpt(Boo
    return (reinterpret_cast<_NodeReportReq*>(iebuffer_))->uprfr_;
 }
 
+inline Void NodeReportReq::finalizeLengths()
+{
+   LengthCalculator::Finalizer f;
+   _NodeReportReq *ies = reinterpret_cast<_NodeReportReq*>(iebuffer_);
+
+   if (data_.user_plane_path_fail_rpt.header.type != 0) ies->uprfr_.packedLength();
+}
+
 inline NodeReportReq &NodeReportReq::encode(uint8_t *dest)
 {
+   finalizeLengths();
    data_.header.seid_seqno.no_seid.seq_no = seqNbr();
    uint16_t len = encode_pfcp_node_rpt_req_t(&data_, dest);
    data_.header.message_len = len;
@@ -10732,8 +10757,28 @@ inline int SessionEstablishmentReq::next_create_traffic_endpt()
       data_.create_traffic_endpt_count++ : -1;
 }
 
+inline Void SessionEstablishmentReq::finalizeLengths()
+{
+   LengthCalculator::Finalizer f;
+   _SessionEstablishmentReq *ies = reinterpret_cast<_SessionEstablishmentReq*>(iebuffer_);
+
+   if (data_.create_bar.header.type != 0)           ies->cb_.packedLength();
+
+   for (auto &ie : cp_)
+      ie.packedLength();
+   for (auto &ie : cf_)
+      ie.packedLength();
+   for (auto &ie : cu_)
+      ie.packedLength();
+   for (auto &ie : cq_)
+      ie.packedLength();
+   for (auto &ie : cte_)
+      ie.packedLength();
+}
+
 inline SessionEstablishmentReq &SessionEstablishmentReq::encode(uint8_t *dest)
 {
+   finalizeLengths();
    data_.header.seid_seqno.has_seid.seq_no = seqNbr();
    data_.header.seid_seqno.has_seid.seid = session()->remoteSeid();
    UShort len = encode_pfcp_sess_estab_req_t(&data_, dest);
@@ -10877,8 +10922,23 @@ inline int SessionEstablishmentRsp::next_created_traffic_endpt()
       data_.created_traffic_endpt_count++ : -1;
 }
 
+inline Void SessionEstablishmentRsp::finalizeLengths()
+{
+   LengthCalculator::Finalizer f;
+   _SessionEstablishmentRsp *ies = reinterpret_cast<_SessionEstablishmentRsp*>(iebuffer_);
+
+   if (data_.load_ctl_info.header.type != 0)  ies->lci_.packedLength();
+   if (data_.ovrld_ctl_info.header.type != 0) ies->oci_.packedLength();
+
+   for (auto &ie : cp_)
+      ie.packedLength();
+   for (auto &ie : cte_)
+      ie.packedLength();
+}
+
 inline SessionEstablishmentRsp &SessionEstablishmentRsp::encode(uint8_t *dest)
 {
+   finalizeLengths();
    data_.header.seid_seqno.has_seid.seq_no = req()->seqNbr();
    data_.header.seid_seqno.has_seid.seid = req()->session()->remoteSeid();
    uint16_t len = encode_pfcp_sess_estab_rsp_t(&data_, dest);
@@ -11247,8 +11307,49 @@ inline int SessionModificationReq::next_query_urr()
       data_.query_urr_count++ : -1;
 }
 
+inline Void SessionModificationReq::finalizeLengths()
+{
+   LengthCalculator::Finalizer f;
+   _SessionModificationReq *ies = reinterpret_cast<_SessionModificationReq*>(iebuffer_);
+
+   if (data_.remove_bar.header.type != 0)           ies->rb_.packedLength();
+   if (data_.rmv_traffic_endpt.header.type != 0)    ies->rte_.packedLength();
+   if (data_.create_traffic_endpt.header.type != 0) ies->cte_.packedLength();
+   if (data_.create_bar.header.type != 0)           ies->cb_.packedLength();
+   if (data_.update_bar.header.type != 0)           ies->ub_.packedLength();
+   if (data_.upd_traffic_endpt.header.type != 0)    ies->ute_.packedLength();
+
+   for (auto &ie : rp_)
+      ie.packedLength();
+   for (auto &ie : rf_)
+      ie.packedLength();
+   for (auto &ie : ru_)
+      ie.packedLength();
+   for (auto &ie : rq_)
+      ie.packedLength();
+   for (auto &ie : cp_)
+      ie.packedLength();
+   for (auto &ie : cf_)
+      ie.packedLength();
+   for (auto &ie : cu_)
+      ie.packedLength();
+   for (auto &ie : cq_)
+      ie.packedLength();
+   for (auto &ie : up_)
+      ie.packedLength();
+   for (auto &ie : uf_)
+      ie.packedLength();
+   for (auto &ie : uu_)
+      ie.packedLength();
+   for (auto &ie : uq_)
+      ie.packedLength();
+   for (auto &ie : qu_)
+      ie.packedLength();
+}
+
 inline SessionModificationReq &SessionModificationReq::encode(uint8_t *dest)
 {
+   finalizeLengths();
    data_.header.seid_seqno.has_seid.seq_no = seqNbr();
    data_.header.seid_seqno.has_seid.seid = session()->remoteSeid();
    uint16_t len = encode_pfcp_sess_mod_req_t(&data_, dest);
@@ -11387,8 +11488,23 @@ inline int SessionModificationRsp::next_usage_report()
       data_.usage_report_count++ : -1;
 }
 
+inline Void SessionModificationRsp::finalizeLengths()
+{
+   LengthCalculator::Finalizer f;
+   _SessionModificationRsp *ies = reinterpret_cast<_SessionModificationRsp*>(iebuffer_);
+
+   if (data_.created_pdr.header.type != 0)                  ies->cp_.packedLength();
+   if (data_.load_ctl_info.header.type != 0)                ies->lci_.packedLength();
+   if (data_.ovrld_ctl_info.header.type != 0)               ies->oci_.packedLength();
+   if (data_.createdupdated_traffic_endpt.header.type != 0) ies->cute_.packedLength();
+
+   for (auto &ie : ur_)
+      ie.packedLength();
+}
+
 inline SessionModificationRsp &SessionModificationRsp::encode(uint8_t *dest)
 {
+   finalizeLengths();
    data_.header.seid_seqno.has_seid.seq_no = req()->seqNbr();
    data_.header.seid_seqno.has_seid.seid = req()->session()->remoteSeid();
    uint16_t len = encode_pfcp_sess_mod_rsp_t(&data_, dest);
@@ -11506,8 +11622,21 @@ inline int SessionDeletionRsp::next_usage_report()
       data_.usage_report_count++ : -1;
 }
 
+inline Void SessionDeletionRsp::finalizeLengths()
+{
+   LengthCalculator::Finalizer f;
+   _SessionDeletionRsp *ies = reinterpret_cast<_SessionDeletionRsp*>(iebuffer_);
+
+   if (data_.load_ctl_info.header.type != 0)  ies->lci_.packedLength();
+   if (data_.ovrld_ctl_info.header.type != 0) ies->oci_.packedLength();
+
+   for (auto &ie : ur_)
+      ie.packedLength();
+}
+
 inline SessionDeletionRsp &SessionDeletionRsp::encode(uint8_t *dest)
 {
+   finalizeLengths();
    data_.header.seid_seqno.has_seid.seq_no = req()->seqNbr();
    data_.header.seid_seqno.has_seid.seid = req()->session()->remoteSeid();
    uint16_t len = encode_pfcp_sess_del_rsp_t(&data_, dest);
@@ -11609,8 +11738,23 @@ inline int SessionReportReq::next_usage_report()
       data_.usage_report_count++ : -1;
 }
 
+inline Void SessionReportReq::finalizeLengths()
+{
+   LengthCalculator::Finalizer f;
+   _SessionReportReq *ies = reinterpret_cast<_SessionReportReq*>(iebuffer_);
+
+   if (data_.dnlnk_data_rpt.header.type != 0) ies->ddr_.packedLength();
+   if (data_.err_indctn_rpt.header.type != 0) ies->eir_.packedLength();
+   if (data_.load_ctl_info.header.type != 0)  ies->lci_.packedLength();
+   if (data_.ovrld_ctl_info.header.type != 0) ies->oci_.packedLength();
+
+   for (auto &ie : ur_)
+      ie.packedLength();
+}
+
 inline SessionReportReq &SessionReportReq::encode(uint8_t *dest)
 {
+   finalizeLengths();
    data_.header.seid_seqno.has_seid.seq_no = seqNbr();
    data_.header.seid_seqno.has_seid.seid = session()->remoteSeid();
    uint16_t len = encode_pfcp_sess_rpt_req_t(&data_, dest);
@@ -11683,8 +11827,17 @@ inline PfcpSrRspFlagsIE &SessionReportRsp::sxsrrsp_flags(Bool forceInit)
    return (reinterpret_cast<_SessionReportRsp*>(iebuffer_))->flags_;
 }
 
+inline Void SessionReportRsp::finalizeLengths()
+{
+   LengthCalculator::Finalizer f;
+   _SessionReportRsp *ies = reinterpret_cast<_SessionReportRsp*>(iebuffer_);
+
+   if (data_.update_bar.header.type != 0) ies->ub_.packedLength();
+}
+
 inline SessionReportRsp &SessionReportRsp::encode(uint8_t *dest)
 {
+   finalizeLengths();
    data_.header.seid_seqno.has_seid.seq_no = req()->seqNbr();
    data_.header.seid_seqno.has_seid.seid = req()->session()->remoteSeid();
    uint16_t len = encode_pfcp_sess_rpt_rsp_t(&data_, dest);
@@ -11706,6 +11859,402 @@ inline Void SessionReportRsp::postDecode()
    if (data_.sxsrrsp_flags.header.len > 0)            sxsrrsp_flags(True);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+template<class TIE, class TData, class TDecoder>
+inline TIE &MessageView::decode(LazyIE<TIE,TData> &lazy, uint16_t type, UShort occurrence, TDecoder decoder)
+{
+   if (lazy.ie_ == nullptr)
+   {
+      // an information element that is not present is left zeroed
+      lazy.data_ = new TData();
+      cpUChar ie = find(type, occurrence);
+      if (ie != nullptr)
+         decoder(const_cast<pUChar>(ie), lazy.data_);
+      lazy.ie_ = new TIE(*lazy.data_, nullptr);
+   }
+   return *lazy.ie_;
+}
+
+inline UShort MessageView::length() const
+{
+   return len_;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+inline SessionEstablishmentReqView::SessionEstablishmentReqView(PFCP::SessionBaseSPtr &ses, cpUChar data, UShort len, const EMemory::Buffer *buf)
+   : PFCP::AppMsgSessionReq(ses,False)
+{
+   setMsgType(PFCP_SESS_ESTAB_REQ);
+   view_.assign(data, len, buf);
+}
+
+inline Bool SessionEstablishmentReqView::isView() const
+{
+   return True;
+}
+
+inline uint16_t SessionEstablishmentReqView::length() const
+{
+   return view_.length();
+}
+
+inline NodeIdIE &SessionEstablishmentReqView::node_id()
+{
+   return view_.decode(node_id_, PFCP_IE_NODE_ID, 0, decode_pfcp_node_id_ie_t);
+}
+
+inline FSeidIE &SessionEstablishmentReqView::cp_fseid()
+{
+   return view_.decode(cp_fseid_, PFCP_IE_FSEID, 0, decode_pfcp_fseid_ie_t);
+}
+
+inline CreateBarIE &SessionEstablishmentReqView::create_bar()
+{
+   return view_.decode(create_bar_, IE_CREATE_BAR, 0, decode_pfcp_create_bar_ie_t);
+}
+
+inline PdnTypeIE &SessionEstablishmentReqView::pdn_type()
+{
+   return view_.decode(pdn_type_, PFCP_IE_PDN_TYPE, 0, decode_pfcp_pdn_type_ie_t);
+}
+
+inline UserPlaneInactivityTimerIE &SessionEstablishmentReqView::user_plane_inact_timer()
+{
+   return view_.decode(user_plane_inact_timer_, PFCP_IE_USER_PLANE_INACT_TIMER, 0, decode_pfcp_user_plane_inact_timer_ie_t);
+}
+
+inline UserIdIE &SessionEstablishmentReqView::user_id()
+{
+   return view_.decode(user_id_, PFCP_IE_USER_ID, 0, decode_pfcp_user_id_ie_t);
+}
+
+inline TraceInformationIE &SessionEstablishmentReqView::trc_info()
+{
+   return view_.decode(trc_info_, PFCP_IE_TRC_INFO, 0, decode_pfcp_trc_info_ie_t);
+}
+
+inline ApnDnnIE &SessionEstablishmentReqView::apn_dnn()
+{
+   return view_.decode(apn_dnn_, PFCP_IE_APN_DNN, 0, decode_pfcp_apn_dnn_ie_t);
+}
+
+inline FqCsidIE &SessionEstablishmentReqView::fqcsid(uint8_t idx)
+{
+   while (fqcsid_.size() <= idx)
+      fqcsid_.emplace_back();
+   return view_.decode(fqcsid_[idx], PFCP_IE_FQCSID, idx, decode_pfcp_fqcsid_ie_t);
+}
+
+inline CreatePdrIE &SessionEstablishmentReqView::create_pdr(uint8_t idx)
+{
+   while (create_pdr_.size() <= idx)
+      create_pdr_.emplace_back();
+   return view_.decode(create_pdr_[idx], IE_CREATE_PDR, idx, decode_pfcp_create_pdr_ie_t);
+}
+
+inline CreateFarIE &SessionEstablishmentReqView::create_far(uint8_t idx)
+{
+   while (create_far_.size() <= idx)
+      create_far_.emplace_back();
+   return view_.decode(create_far_[idx], IE_CREATE_FAR, idx, decode_pfcp_create_far_ie_t);
+}
+
+inline CreateUrrIE &SessionEstablishmentReqView::create_urr(uint8_t idx)
+{
+   while (create_urr_.size() <= idx)
+      create_urr_.emplace_back();
+   return view_.decode(create_urr_[idx], IE_CREATE_URR, idx, decode_pfcp_create_urr_ie_t);
+}
+
+inline CreateQerIE &SessionEstablishmentReqView::create_qer(uint8_t idx)
+{
+   while (create_qer_.size() <= idx)
+      create_qer_.emplace_back();
+   return view_.decode(create_qer_[idx], IE_CREATE_QER, idx, decode_pfcp_create_qer_ie_t);
+}
+
+inline CreateTrafficEndpointIE &SessionEstablishmentReqView::create_traffic_endpt(uint8_t idx)
+{
+   while (create_traffic_endpt_.size() <= idx)
+      create_traffic_endpt_.emplace_back();
+   return view_.decode(create_traffic_endpt_[idx], IE_CREATE_TRAFFIC_ENDPT, idx, decode_pfcp_create_traffic_endpt_ie_t);
+}
+
+inline int SessionEstablishmentReqView::fqcsid_count() const
+{
+   return view_.count(PFCP_IE_FQCSID);
+}
+
+inline int SessionEstablishmentReqView::create_pdr_count() const
+{
+   return view_.count(IE_CREATE_PDR);
+}
+
+inline int SessionEstablishmentReqView::create_far_count() const
+{
+   return view_.count(IE_CREATE_FAR);
+}
+
+inline int SessionEstablishmentReqView::create_urr_count() const
+{
+   return view_.count(IE_CREATE_URR);
+}
+
+inline int SessionEstablishmentReqView::create_qer_count() const
+{
+   return view_.count(IE_CREATE_QER);
+}
+
+inline int SessionEstablishmentReqView::create_traffic_endpt_count() const
+{
+   return view_.count(IE_CREATE_TRAFFIC_ENDPT);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+inline SessionModificationReqView::SessionModificationReqView(PFCP::SessionBaseSPtr &ses, cpUChar data, UShort len, const EMemory::Buffer *buf)
+   : PFCP::AppMsgSessionReq(ses,False)
+{
+   setMsgType(PFCP_SESS_MOD_REQ);
+   view_.assign(data, len, buf);
+}
+
+inline Bool SessionModificationReqView::isView() const
+{
+   return True;
+}
+
+inline uint16_t SessionModificationReqView::length() const
+{
+   return view_.length();
+}
+
+inline FSeidIE &SessionModificationReqView::cp_fseid()
+{
+   return view_.decode(cp_fseid_, PFCP_IE_FSEID, 0, decode_pfcp_fseid_ie_t);
+}
+
+inline RemoveBarIE &SessionModificationReqView::remove_bar()
+{
+   return view_.decode(remove_bar_, IE_REMOVE_BAR, 0, decode_pfcp_remove_bar_ie_t);
+}
+
+inline RemoveTrafficEndpointIE &SessionModificationReqView::rmv_traffic_endpt()
+{
+   return view_.decode(rmv_traffic_endpt_, IE_RMV_TRAFFIC_ENDPT, 0, decode_pfcp_rmv_traffic_endpt_ie_t);
+}
+
+inline CreateBarIE &SessionModificationReqView::create_bar()
+{
+   return view_.decode(create_bar_, IE_CREATE_BAR, 0, decode_pfcp_create_bar_ie_t);
+}
+
+inline CreateTrafficEndpointIE &SessionModificationReqView::create_traffic_endpt()
+{
+   return view_.decode(create_traffic_endpt_, IE_CREATE_TRAFFIC_ENDPT, 0, decode_pfcp_create_traffic_endpt_ie_t);
+}
+
+inline UpdateBarSessionModificationReqIE &SessionModificationReqView::update_bar()
+{
+   return view_.decode(update_bar_, IE_UPD_BAR_SESS_MOD_REQ, 0, decode_pfcp_upd_bar_sess_mod_req_ie_t);
+}
+
+inline UpdateTrafficEndpointIE &SessionModificationReqView::upd_traffic_endpt()
+{
+   return view_.decode(upd_traffic_endpt_, IE_UPD_TRAFFIC_ENDPT, 0, decode_pfcp_upd_traffic_endpt_ie_t);
+}
+
+inline PfcpSmReqFlagsIE &SessionModificationReqView::pfcpsmreq_flags()
+{
+   return view_.decode(pfcpsmreq_flags_, PFCP_IE_PFCPSMREQ_FLAGS, 0, decode_pfcp_pfcpsmreq_flags_ie_t);
+}
+
+inline UserPlaneInactivityTimerIE &SessionModificationReqView::user_plane_inact_timer()
+{
+   return view_.decode(user_plane_inact_timer_, PFCP_IE_USER_PLANE_INACT_TIMER, 0, decode_pfcp_user_plane_inact_timer_ie_t);
+}
+
+inline QueryUrrReferenceIE &SessionModificationReqView::query_urr_ref()
+{
+   return view_.decode(query_urr_ref_, PFCP_IE_QUERY_URR_REF, 0, decode_pfcp_query_urr_ref_ie_t);
+}
+
+inline TraceInformationIE &SessionModificationReqView::trc_info()
+{
+   return view_.decode(trc_info_, PFCP_IE_TRC_INFO, 0, decode_pfcp_trc_info_ie_t);
+}
+
+inline FqCsidIE &SessionModificationReqView::fqcsid(uint8_t idx)
+{
+   while (fqcsid_.size() <= idx)
+      fqcsid_.emplace_back();
+   return view_.decode(fqcsid_[idx], PFCP_IE_FQCSID, idx, decode_pfcp_fqcsid_ie_t);
+}
+
+inline RemovePdrIE &SessionModificationReqView::remove_pdr(uint8_t idx)
+{
+   while (remove_pdr_.size() <= idx)
+      remove_pdr_.emplace_back();
+   return view_.decode(remove_pdr_[idx], IE_REMOVE_PDR, idx, decode_pfcp_remove_pdr_ie_t);
+}
+
+inline RemoveFarIE &SessionModificationReqView::remove_far(uint8_t idx)
+{
+   while (remove_far_.size() <= idx)
+      remove_far_.emplace_back();
+   return view_.decode(remove_far_[idx], IE_REMOVE_FAR, idx, decode_pfcp_remove_far_ie_t);
+}
+
+inline RemoveUrrIE &SessionModificationReqView::remove_urr(uint8_t idx)
+{
+   while (remove_urr_.size() <= idx)
+      remove_urr_.emplace_back();
+   return view_.decode(remove_urr_[idx], IE_REMOVE_URR, idx, decode_pfcp_remove_urr_ie_t);
+}
+
+inline RemoveQerIE &SessionModificationReqView::remove_qer(uint8_t idx)
+{
+   while (remove_qer_.size() <= idx)
+      remove_qer_.emplace_back();
+   return view_.decode(remove_qer_[idx], IE_REMOVE_QER, idx, decode_pfcp_remove_qer_ie_t);
+}
+
+inline CreatePdrIE &SessionModificationReqView::create_pdr(uint8_t idx)
+{
+   while (create_pdr_.size() <= idx)
+      create_pdr_.emplace_back();
+   return view_.decode(create_pdr_[idx], IE_CREATE_PDR, idx, decode_pfcp_create_pdr_ie_t);
+}
+
+inline CreateFarIE &SessionModificationReqView::create_far(uint8_t idx)
+{
+   while (create_far_.size() <= idx)
+      create_far_.emplace_back();
+   return view_.decode(create_far_[idx], IE_CREATE_FAR, idx, decode_pfcp_create_far_ie_t);
+}
+
+inline CreateUrrIE &SessionModificationReqView::create_urr(uint8_t idx)
+{
+   while (create_urr_.size() <= idx)
+      create_urr_.emplace_back();
+   return view_.decode(create_urr_[idx], IE_CREATE_URR, idx, decode_pfcp_create_urr_ie_t);
+}
+
+inline CreateQerIE &SessionModificationReqView::create_qer(uint8_t idx)
+{
+   while (create_qer_.size() <= idx)
+      create_qer_.emplace_back();
+   return view_.decode(create_qer_[idx], IE_CREATE_QER, idx, decode_pfcp_create_qer_ie_t);
+}
+
+inline UpdatePdrIE &SessionModificationReqView::update_pdr(uint8_t idx)
+{
+   while (update_pdr_.size() <= idx)
+      update_pdr_.emplace_back();
+   return view_.decode(update_pdr_[idx], IE_UPDATE_PDR, idx, decode_pfcp_update_pdr_ie_t);
+}
+
+inline UpdateFarIE &SessionModificationReqView::update_far(uint8_t idx)
+{
+   while (update_far_.size() <= idx)
+      update_far_.emplace_back();
+   return view_.decode(update_far_[idx], IE_UPDATE_FAR, idx, decode_pfcp_update_far_ie_t);
+}
+
+inline UpdateUrrIE &SessionModificationReqView::update_urr(uint8_t idx)
+{
+   while (update_urr_.size() <= idx)
+      update_urr_.emplace_back();
+   return view_.decode(update_urr_[idx], IE_UPDATE_URR, idx, decode_pfcp_update_urr_ie_t);
+}
+
+inline UpdateQerIE &SessionModificationReqView::update_qer(uint8_t idx)
+{
+   while (update_qer_.size() <= idx)
+      update_qer_.emplace_back();
+   return view_.decode(update_qer_[idx], IE_UPDATE_QER, idx, decode_pfcp_update_qer_ie_t);
+}
+
+inline QueryUrrIE &SessionModificationReqView::query_urr(uint8_t idx)
+{
+   while (query_urr_.size() <= idx)
+      query_urr_.emplace_back();
+   return view_.decode(query_urr_[idx], IE_QUERY_URR, idx, decode_pfcp_query_urr_ie_t);
+}
+
+inline int SessionModificationReqView::fqcsid_count() const
+{
+   return view_.count(PFCP_IE_FQCSID);
+}
+
+inline int SessionModificationReqView::remove_pdr_count() const
+{
+   return view_.count(IE_REMOVE_PDR);
+}
+
+inline int SessionModificationReqView::remove_far_count() const
+{
+   return view_.count(IE_REMOVE_FAR);
+}
+
+inline int SessionModificationReqView::remove_urr_count() const
+{
+   return view_.count(IE_REMOVE_URR);
+}
+
+inline int SessionModificationReqView::remove_qer_count() const
+{
+   return view_.count(IE_REMOVE_QER);
+}
+
+inline int SessionModificationReqView::create_pdr_count() const
+{
+   return view_.count(IE_CREATE_PDR);
+}
+
+inline int SessionModificationReqView::create_far_count() const
+{
+   return view_.count(IE_CREATE_FAR);
+}
+
+inline int SessionModificationReqView::create_urr_count() const
+{
+   return view_.count(IE_CREATE_URR);
+}
+
+inline int SessionModificationReqView::create_qer_count() const
+{
+   return view_.count(IE_CREATE_QER);
+}
+
+inline int SessionModificationReqView::update_pdr_count() const
+{
+   return view_.count(IE_UPDATE_PDR);
+}
+
+inline int SessionModificationReqView::update_far_count() const
+{
+   return view_.count(IE_UPDATE_FAR);
+}
+
+inline int SessionModificationReqView::update_urr_count() const
+{
+   return view_.count(IE_UPDATE_URR);
+}
+
+inline int SessionModificationReqView::update_qer_count() const
+{
+   return view_.count(IE_UPDATE_QER);
+}
+
+inline int SessionModificationReqView::query_urr_count() const
+{
+   return view_.count(IE_QUERY_URR);
+}
+
 } // namespace PFCP_R15
 /// @endcond
 
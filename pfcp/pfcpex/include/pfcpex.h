@@ -95,6 +95,7 @@ public:
    Void startup(EGetOpt &opt);
 
    Void startProcessing();
+   Void encodeBenchmark(Int iterations);
 
    Void addSession();
    Void delSession();
@@ -107,18 +108,19 @@ public:
    Void sendAssnReleaseReq();
    Void sendAssnReleaseRsp(PFCP_R15::AssnReleaseReq *req);
    Void sendSessionEstablishmentReq(PFCP::SessionBaseSPtr &session);
-   Void sendSessionEstablishmentRsp(PFCP_R15::SessionEstablishmentReq *req);
+   Void sendSessionEstablishmentRsp(PFCP::AppMsgSessionReqPtr req);
    Void sendSessionDeletionReq(PFCP::SessionBaseSPtr &session);
    Void sendSessionDeletionRsp(PFCP_R15::SessionDeletionReq *req);
 
    Void onCreateWorker(ExamplePfcpApplicationWorker &worker);
+   Void onScaleWorkers(const EThreadWorkGroupScaleEvent &evt);
 
    PFCP::LocalNodeSPtr _createLocalNode() override
-      { return std::make_shared<PFCP::LocalNode>(); }
+      { return EMemory::makeRef<PFCP::LocalNode>(); }
    PFCP::RemoteNodeSPtr _createRemoteNode() override
-      { return std::make_shared<PFCP::RemoteNode>(); }
+      { return EMemory::makeRef<PFCP::RemoteNode>(); }
    PFCP::SessionBaseSPtr _createSession(PFCP::LocalNodeSPtr &ln, PFCP::RemoteNodeSPtr &rn) override
-      { return std::make_shared<PFCP::SessionBase>(ln, rn); }
+      { return EMemory::makeRef<PFCP::SessionBase>(ln, rn); }
 
 private:
    static ExamplePfcpApplicationWorkGroup *this_;
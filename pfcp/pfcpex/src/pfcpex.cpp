@@ -135,6 +135,27 @@ Void ExamplePfcpApplicationWorkGroup::startup(EGetOpt &opt)
 
    PFCP::Configuration::setPort(opt.get("/PfcpExample/PFCP/pfcpPort", 8805));
    PFCP::Configuration::setSocketBufferSize(opt.get("/PfcpExample/PFCP/socketBufferSize", 2097152));
+   PFCP::Configuration::setSocketBatchSize(opt.get("/PfcpExample/PFCP/socketBatchSize", 32));
+   PFCP::Configuration::setPooledReceiveBufferSize(opt.get("/PfcpExample/PFCP/pooledReceiveBufferSize", 0));
+   PFCP::Configuration::setPooledSendBufferSize(opt.get("/PfcpExample/PFCP/pooledSendBufferSize", 0));
+   PFCP::Configuration::setResponseCache(opt.get("/PfcpExample/PFCP/responseCache", True));
+   PFCP::Configuration::setSequenceWindowSize(opt.get("/PfcpExample/PFCP/sequenceWindowSize", 0));
+   PFCP::Configuration::setNodeMessagePriority(opt.get("/PfcpExample/PFCP/nodeMessagePriority", True));
+   PFCP::Configuration::setNodeMessageWeight(opt.get("/PfcpExample/PFCP/nodeMessageWeight", 0));
+   PFCP::Configuration::setHeartbeatFastPath(opt.get("/PfcpExample/PFCP/heartbeatFastPath", True));
+   PFCP::Configuration::setOverloadHighWatermark(opt.get("/PfcpExample/PFCP/overloadHighWatermark", 0));
+   PFCP::Configuration::setOverloadLowWatermark(opt.get("/PfcpExample/PFCP/overloadLowWatermark", 0));
+   PFCP::Configuration::setOverloadAction(EString(opt.get("/PfcpExample/PFCP/overloadAction", "reject")) == "drop" ?
+      PFCP::OverloadAction::Drop : PFCP::OverloadAction::Reject);
+   PFCP::Configuration::setOverloadCause(opt.get("/PfcpExample/PFCP/overloadCause", 74));
+   PFCP::Configuration::setOverloadControlValidity(opt.get("/PfcpExample/PFCP/overloadControlValidity", 0));
+   PFCP::Configuration::setSessionHugePages(opt.get("/PfcpExample/PFCP/sessionHugePages", False));
+   PFCP::Configuration::setCommunicationShards(opt.get("/PfcpExample/PFCP/communicationShards", 1));
+   PFCP::Configuration::setCommunicationPlacement(EThreadPlacement().load(opt, "/PfcpExample/PFCP/communicationPlacement"));
+   PFCP::Configuration::setTranslationPlacement(EThreadPlacement().load(opt, "/PfcpExample/PFCP/translationPlacement"));
+   PFCP::Configuration::setTimerPlacement(EThreadPlacement().load(opt, "/PfcpExample/PFCP/timerPlacement"));
+   PFCP::Configuration::setShardMode(EString(opt.get("/PfcpExample/PFCP/shardMode", "reuseport")) == "steering" ?
+      PFCP::ShardMode::Steering : PFCP::ShardMode::ReusePort);
    PFCP::Configuration::setT1(opt.get("/PfcpExample/PFCP/T1",3000));
    PFCP::Configuration::setN1(opt.get("/PfcpExample/PFCP/N1",2));
    PFCP::Configuration::setHeartbeatT1(opt.get("/PfcpExample/PFCP/heartbeatT1",5000));
@@ -147,6 +168,7 @@ Void ExamplePfcpApplicationWorkGroup::startup(EGetOpt &opt)
    PFCP::Configuration::setLogger(ELogger::log(LOG_PFCP));
    PFCP::Configuration::setApplication(*this);
    PFCP::Configuration::setTranslator(xlator_);
+   xlator_.setDecodeViews(opt.get("/PfcpExample/decodeViews", False));
 
    PFCP::Configuration::messageStatsTemplate().emplace(xlator_.pfcpAssociationSetupReq(),     PFCP::MessageStats(xlator_.pfcpAssociationSetupReq(),     "pfcp_assn_setup_req"));
    PFCP::Configuration::messageStatsTemplate().emplace(xlator_.pfcpAssociationSetupRsp(),     PFCP::MessageStats(xlator_.pfcpAssociationSetupRsp(),     "pfcp_assn_setup_rsp"));
@@ -170,9 +192,27 @@ Void ExamplePfcpApplicationWorkGroup::startup(EGetOpt &opt)
 
    PFCP_ANALYSIS_ALLOC(sesCreateCnt_);
 
+   if (EString(opt.get("/PfcpExample/applicationDispatch", "shared")) == "perworker")
+      setDispatchMode(EThreadWorkGroupDispatch::PerWorker);
+   setWorkStealing(opt.get("/PfcpExample/applicationWorkStealing", False));
+   setPlacement(EThreadPlacement().load(opt, "/PfcpExample/applicationPlacement"));
+   setScaling(EThreadWorkGroupScaling().load(opt, "/PfcpExample/applicationScaling"));
+   if (getDispatchMode() == EThreadWorkGroupDispatch::PerWorker && getScaling().enabled() && maxWorkers > minWorkers)
+   {
+      // session messages are keyed and would never reach the added workers
+      ELogger::log(LOG_SYSTEM).minor("{} - autoscaling is not supported with per worker dispatch, starting {} workers",
+         __method__, maxWorkers);
+      setScaling(EThreadWorkGroupScaling(getScaling()).enabled(False));
+      minWorkers = maxWorkers;
+   }
+
    init(1, 1, minWorkers, maxWorkers, 100000);
 
    ln_ = ExamplePfcpApplicationWorkGroup::createLocalNode(lnip_.c_str(), port_);
+
+   Int benchIterations = opt.get("/PfcpExample/encodeBenchmark", 0);
+   if (benchIterations > 0)
+      encodeBenchmark(benchIterations);
    
    if (sndAssnSetup_)
    {
@@ -219,6 +259,95 @@ Void ExamplePfcpApplicationWorkGroup::startProcessing()
       addSession();
 }
 
+static Void buildLargeSessionEstablishmentReq(PFCP_R15::SessionEstablishmentReq &req, const EIpAddress &ip)
+{
+   static UChar apn[] = { 4, 'a', 'p', 'n', '1' };
+   static UChar ni[] = { 8, 'i', 'n', 't', 'e', 'r', 'n', 'e', 't' };
+   int idx;
+
+   req.node_id().node_id_value(ip);
+   req.cp_fseid().ip_address(ip);
+   req.cp_fseid().seid(req.session()->localSeid());
+   req.apn_dnn().apn_dnn(apn, sizeof(apn));
+   req.create_bar().bar_id().bar_id_value(1);
+   req.create_bar().dnlnk_data_notif_delay().delay_value(10);
+   req.create_bar().suggstd_buf_pckts_cnt().pckt_cnt_val(32);
+
+   while ((idx = req.next_create_pdr()) >= 0)
+   {
+      PFCP_R15::CreatePdrIE &pdr = req.create_pdr(idx);
+      pdr.pdr_id().rule_id(idx + 1);
+      pdr.precedence().prcdnc_val(100 + idx);
+      pdr.pdi().src_intfc().interface_value(PFCP_R15::SourceInterfaceEnum::Access);
+      pdr.pdi().local_fteid().teid(0x1000 + idx).ip_address(ip);
+      pdr.pdi().ntwk_inst().ntwk_inst(ni, sizeof(ni));
+      pdr.far_id().far_id_value(idx + 1);
+      pdr.urr_id(pdr.next_urr_id()).urr_id_value(idx + 1);
+      pdr.qer_id(pdr.next_qer_id()).qer_id_value(idx + 1);
+   }
+
+   while ((idx = req.next_create_far()) >= 0)
+   {
+      PFCP_R15::CreateFarIE &far = req.create_far(idx);
+      far.far_id().far_id_value(idx + 1);
+      far.apply_action().forw(True);
+      far.frwdng_parms().dst_intfc().interface_value(PFCP_R15::DestinationInterfaceEnum::core);
+      far.frwdng_parms().ntwk_inst().ntwk_inst(ni, sizeof(ni));
+   }
+
+   while ((idx = req.next_create_urr()) >= 0)
+   {
+      PFCP_R15::CreateUrrIE &urr = req.create_urr(idx);
+      urr.urr_id().urr_id_value(idx + 1);
+      urr.meas_mthd().volum(True).durat(True);
+      urr.vol_thresh().total_volume(1000000000);
+      urr.time_threshold().time_threshold(3600);
+   }
+
+   while ((idx = req.next_create_qer()) >= 0)
+   {
+      PFCP_R15::CreateQerIE &qer = req.create_qer(idx);
+      qer.qer_id().qer_id_value(idx + 1);
+      qer.gate_status().ul_gate(PFCP_R15::UplinkGateEnum::Open).dl_gate(PFCP_R15::DownlinkGateEnum::Open);
+      qer.maximum_bitrate().ul_mbr(100000000).dl_mbr(200000000);
+   }
+}
+
+Void ExamplePfcpApplicationWorkGroup::encodeBenchmark(Int iterations)
+{
+   static EString __method__ = __METHOD_NAME__;
+   PFCP::RemoteNodeSPtr rn = EMemory::makeRef<PFCP::RemoteNode>();
+   PFCP::SessionBaseSPtr ses = EMemory::makeRef<PFCP::SessionBase>(ln_, rn);
+   EIpAddress ip(lnip_.c_str());
+   UChar buffers[2][ESocket::UPD_MAX_MSG_LENGTH];
+   uint16_t lengths[2];
+
+   for (Int mode = 0; mode < 2; mode++)
+   {
+      Bool defer = mode == 1;
+      Bool prevDefer = PFCP_R15::LengthCalculator::deferLengths();
+      ETimer t;
+
+      PFCP_R15::LengthCalculator::setDeferLengths(defer);
+      for (Int i = 0; i < iterations; i++)
+      {
+         PFCP_R15::SessionEstablishmentReq *req = new PFCP_R15::SessionEstablishmentReq(ses, False);
+         buildLargeSessionEstablishmentReq(*req, ip);
+         req->encode(buffers[mode]);
+         lengths[mode] = req->length();
+         delete req;
+      }
+      PFCP_R15::LengthCalculator::setDeferLengths(prevDefer);
+
+      epctime_t elapsed = t.MicroSeconds();
+      ELogger::log(LOG_SYSTEM).startup("{} - built and encoded {} session establishment requests of {} bytes with {} lengths in {}us ({}us per message)",
+         __method__, iterations, lengths[mode], defer ? "deferred" : "immediate", elapsed, static_cast<Double>(elapsed) / iterations);
+   }
+
+   if (lengths[0] != lengths[1] || memcmp(buffers[0], buffers[1], lengths[0]) != 0)
+      ELogger::log(LOG_SYSTEM).major("{} - the encoded messages do not match", __method__);
+}
+
 Void ExamplePfcpApplicationWorkGroup::addSession()
 {
    static EString __method__ = __METHOD_NAME__;
@@ -351,6 +480,18 @@ Void ExamplePfcpApplicationWorkGroup::onCreateWorker(ExamplePfcpApplicationWorke
 {
    static EString __method__ = __METHOD_NAME__;
    worker.group(*this);
+   ELogger::log(LOG_SYSTEM).startup("{} - application worker {} placement {}",
+      __method__, worker.workerId(), worker.getPlacementReport());
+}
+
+Void ExamplePfcpApplicationWorkGroup::onScaleWorkers(const EThreadWorkGroupScaleEvent &evt)
+{
+   static EString __method__ = __METHOD_NAME__;
+   static cpStr reasons[] = { "backlog", "latency", "busy", "idle" };
+   EThreadWorkGroupScalingStats stats = getScalingStats();
+   ELogger::log(LOG_SYSTEM).info("{} - application workers {} -> {} reason={} depth={} busy={}% latency={}us scaleUps={} scaleDowns={} peak={}",
+      __method__, evt.before, evt.after, reasons[static_cast<Int>(evt.reason)], evt.depth, evt.busy, evt.latency,
+      stats.scaleUps, stats.scaleDowns, stats.peakWorkers);
 }
 
 Void ExamplePfcpApplicationWorkGroup::sendAssnSetupReq()
@@ -447,7 +588,7 @@ Void ExamplePfcpApplicationWorkGroup::sendSessionEstablishmentReq(PFCP::SessionB
    SEND_TO_TRANSLATION(SndMsg, req);
 }
 
-Void ExamplePfcpApplicationWorkGroup::sendSessionEstablishmentRsp(PFCP_R15::SessionEstablishmentReq *req)
+Void ExamplePfcpApplicationWorkGroup::sendSessionEstablishmentRsp(PFCP::AppMsgSessionReqPtr req)
 {
    static EString __method__ = __METHOD_NAME__;
 
@@ -634,8 +775,9 @@ Void ExamplePfcpApplicationWorker::onRcvdReq(PFCP::AppMsgReqPtr req)
       }
       case PFCP_SESS_ESTAB_REQ:
       {
-         PFCP_R15::SessionEstablishmentReq *am = static_cast<PFCP_R15::SessionEstablishmentReq*>(req);
-         ELogger::log(LOG_SYSTEM).debug("{} workerId={} - received PFCP_SESS_ESTAB_REQ", __method__, workerId());
+         // the request is a SessionEstablishmentReqView when the translator decodes views
+         PFCP::AppMsgSessionReqPtr am = static_cast<PFCP::AppMsgSessionReqPtr>(req);
+         ELogger::log(LOG_SYSTEM).debug("{} workerId={} - received PFCP_SESS_ESTAB_REQ view={}", __method__, workerId(), am->isView());
          group().sendSessionEstablishmentRsp(am);
          break;
       }
@@ -90,9 +90,9 @@ namespace PFCPTest
       GetTranslator().getMsgInfo(tmi, payload.data(), payload.size());
 
       ESocket::Address addr("0.0.0.0", 0);
-      PFCP::LocalNodeSPtr ln = std::make_shared<PFCP::LocalNode>();
+      PFCP::LocalNodeSPtr ln = EMemory::makeRef<PFCP::LocalNode>();
       ln->setAddress(addr);
-      PFCP::RemoteNodeSPtr rn = std::make_shared<PFCP::RemoteNode>();
+      PFCP::RemoteNodeSPtr rn = EMemory::makeRef<PFCP::RemoteNode>();
       rn->setAddress(addr);
 
       if (tmi.isReq())
@@ -100,7 +100,7 @@ namespace PFCPTest
          std::unique_ptr<PFCP::ReqIn> msgIn(new PFCP::ReqIn(ln, rn, tmi, payload.data(), payload.size()));
          if (tmi.msgClass() == PFCP::MsgClass::Session)
          {
-            PFCP::SessionBaseSPtr ses = std::make_shared<PFCP::SessionBase>(ln, rn);
+            PFCP::SessionBaseSPtr ses = EMemory::makeRef<PFCP::SessionBase>(ln, rn);
             ses->setSeid(ses, tmi.seid(), tmi.seid(), False);
             msgIn->setSession(ses);
          }
@@ -113,7 +113,7 @@ namespace PFCPTest
          PFCP::AppMsgReqPtr dummyReq;
          if (tmi.msgClass() == PFCP::MsgClass::Session)
          {
-            PFCP::SessionBaseSPtr ses = std::make_shared<PFCP::SessionBase>(ln, rn);
+            PFCP::SessionBaseSPtr ses = EMemory::makeRef<PFCP::SessionBase>(ln, rn);
             ses->setSeid(ses, tmi.seid(), tmi.seid(), False);
             dummyReq = new PFCP::AppMsgSessionReq(ses,False);
          }
@@ -49,9 +49,9 @@ namespace PFCPTest
          InitWrapperTest(resultPcap);
 
          ESocket::Address addr("1.2.3.4", 5);
-         PFCP::LocalNodeSPtr ln = std::make_shared<PFCP::LocalNode>();
+         PFCP::LocalNodeSPtr ln = EMemory::makeRef<PFCP::LocalNode>();
          ln->setAddress(addr);
-         PFCP::RemoteNodeSPtr rn = std::make_shared<PFCP::RemoteNode>();
+         PFCP::RemoteNodeSPtr rn = EMemory::makeRef<PFCP::RemoteNode>();
          rn->setAddress(addr);
 
          std::unique_ptr<PFCP::AppMsg> appMsg = buildAppMsg(ln, rn);
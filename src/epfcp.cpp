@@ -46,7 +46,9 @@ MessageStats::MessageStats(const MessageStats &m)
    : id_( m.id_ ),
      name_( m.name_ ),
      received_( m.received_.load() ),
-     timeout_( m.timeout_.load() )
+     timeout_( m.timeout_.load() ),
+     rspcachehit_( m.rspcachehit_.load() ),
+     rspcachemiss_( m.rspcachemiss_.load() )
 {
    sent_ = m.sent_;
 }
@@ -58,6 +60,8 @@ Void MessageStats::reset()
 
    received_ = 0;
    timeout_ = 0;
+   rspcachehit_ = 0;
+   rspcachemiss_ = 0;
 }
 
 UInt MessageStats::incSent(UInt attempt)
@@ -155,6 +159,8 @@ Void Stats::collectNodeStats(EJsonBuilder &builder)
                EJsonBuilder::StackUInt pushId(builder, m->getId(), "id");
                EJsonBuilder::StackUInt pushReceived(builder, m->getReceived(), "received");
                EJsonBuilder::StackUInt pushTimeout(builder, m->getTimeout(), "timeout");
+               EJsonBuilder::StackUInt pushRspCacheHit(builder, m->getRspCacheHit(), "rsp_cache_hit");
+               EJsonBuilder::StackUInt pushRspCacheMiss(builder, m->getRspCacheMiss(), "rsp_cache_miss");
                EJsonBuilder::StackArray pushSentArray(builder, "sent");
                for (auto sent : m->getSent())
                   EJsonBuilder::StackUInt pushSent(builder, sent);
@@ -205,6 +211,25 @@ Void Stats::reset()
 
 UShort Configuration::port_                        = 8805;
 Int Configuration::bufsize_                        = 2097152;
+Int Configuration::batchsz_                        = 32;
+Int Configuration::bufpoolsz_                      = 0;
+Int Configuration::sndpoolsz_                      = 0;
+Bool Configuration::rspcache_                      = True;
+Int Configuration::seqwndsz_                       = 0;
+Bool Configuration::nodepri_                       = True;
+Int Configuration::nodewt_                         = 0;
+Bool Configuration::hbfast_                        = True;
+Int Configuration::ovldhwm_                        = 0;
+Int Configuration::ovldlwm_                        = 0;
+OverloadAction Configuration::ovldact_             = OverloadAction::Reject;
+UChar Configuration::ovldcause_                    = 74;   // PFCP entity in congestion
+Int Configuration::ovldvalid_                      = 0;
+Bool Configuration::sesshp_                        = False;
+Int Configuration::shards_                         = 1;
+ShardMode Configuration::shardmode_                = ShardMode::ReusePort;
+EThreadPlacement Configuration::commplc_;
+EThreadPlacement Configuration::xlatplc_;
+EThreadPlacement Configuration::tmrplc_;
 LongLong Configuration::t1_                        = 3000;
 LongLong Configuration::hbt1_                      = 5000;
 Int Configuration::n1_                             = 2;
@@ -230,51 +255,75 @@ MsgType Configuration::pfcpAssociationSetupReq     = 5;
 MsgType Configuration::pfcpAssociationSetupRsp     = 6;
 
 /// @cond DOXYGEN_EXCLUDE
-TranslationThread *TranslationThread::this_     = nullptr;
-CommunicationThread *CommunicationThread::this_ = nullptr;
-EMemory::Pool SessionBase::pool_;
+TranslationThread **TranslationThread::this_      = nullptr;
+Int TranslationThread::nshards_                   = 0;
+CommunicationThread **CommunicationThread::this_  = nullptr;
+Int CommunicationThread::nshards_                 = 0;
+thread_local Int CommunicationThread::curshard_   = -1;
+EMutexPrivate CommunicationThread::trmmtx_;
+ERWLock CommunicationThread::lnslck_;
+LocalNodeUMap CommunicationThread::lns_;
+EMemory::NumaPool SessionBase::pool_;
+std::atomic<Bool> SessionBase::poolinit_(False);
+EMutexPrivate SessionBase::poolmtx_;
 ULongLong SessionBase::created_                 = 0;
 ULongLong SessionBase::deleted_                 = 0;
 ULongLong Node::created_                        = 0;
 ULongLong Node::deleted_                        = 0;
 EMemory::Pool InternalMsg::pool_;
+std::atomic<Bool> InternalMsg::poolinit_(False);
+EMutexPrivate InternalMsg::poolmtx_;
 EMemory::Pool EventBase::pool_;
+std::atomic<Bool> EventBase::poolinit_(False);
+EMutexPrivate EventBase::poolmtx_;
 /// @endcond
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void* EventBase::operator new(size_t sz)
+Void EventBase::initPool(size_t sz)
 {
-   if (pool_.allocSize() == 0)
-   {
-      size_t rawns = 4096;
-      size_t as=sizeof(EThreadMessage), ns, bs, bc;
+   // the events are created by every communication thread shard, so the
+   // pool is sized once under a lock
+   EMutexLock l(poolmtx_);
+   if (poolinit_.load(std::memory_order_relaxed))
+      return;
 
-      as = std::max(as, sizeof(LocalNodeStateChangeEvent));
-      as = std::max(as, sizeof(RemoteNodeStateChangeEvent));
-      as = std::max(as, sizeof(RemoteNodeRestartEvent));
+   size_t rawns = 4096;
+   size_t as=sizeof(EThreadMessage), ns, bs, bc;
 
-      while (rawns <= 32768)
-      {
-         // subtract the size of the node header (EMemory::Node)
-         ns = rawns - sizeof(EMemory::Node);
-         // set the block size equal to the allocation size + the block header
-         bs = as + sizeof(EMemory::Block);
-         // round the block size up to the CPU word size
-         bs += bs % sizeof(pVoid);
-         // calculate the number of blocks that can fit in a node
-         bc = ns / bs;
-         if (bc >= 10)
-            break;
-         rawns += 4096;
-      }
+   as = std::max(as, sizeof(LocalNodeStateChangeEvent));
+   as = std::max(as, sizeof(LocalNodeOverloadEvent));
+   as = std::max(as, sizeof(RemoteNodeStateChangeEvent));
+   as = std::max(as, sizeof(RemoteNodeRestartEvent));
 
-      if (sz >= ns)
-         pool_.setSize(sz, 0, 5);
-      else
-         pool_.setSize(as, rawns, bc);
+   while (rawns <= 32768)
+   {
+      // subtract the size of the node header (EMemory::Node)
+      ns = rawns - sizeof(EMemory::Node);
+      // set the block size equal to the allocation size + the block header
+      bs = as + sizeof(EMemory::Block);
+      // round the block size up to the CPU word size
+      bs += bs % sizeof(pVoid);
+      // calculate the number of blocks that can fit in a node
+      bc = ns / bs;
+      if (bc >= 10)
+         break;
+      rawns += 4096;
    }
+
+   if (sz >= ns)
+      pool_.setSize(sz, 0, 5);
+   else
+      pool_.setSize(as, rawns, bc);
+
+   poolinit_.store(True, std::memory_order_release);
+}
+
+void* EventBase::operator new(size_t sz)
+{
+   if (!poolinit_.load(std::memory_order_acquire))
+      initPool(sz);
    if (sz > pool_.allocSize())
    {
       EError ex;
@@ -290,6 +339,59 @@ void EventBase::operator delete(void* m)
    pool_.deallocate(m);
 }
 
+Void SessionBase::initPool(size_t sz)
+{
+   EMutexLock l(poolmtx_);
+   if (poolinit_.load(std::memory_order_relaxed))
+      return;
+
+   pool_.setHugePages(Configuration::sessionHugePages());
+   if (sz >= (32768 - sizeof(EMemory::Node)))
+   {
+      pool_.setSize(sz, 0, 5);
+   }
+   else
+   {
+      size_t ns = 32768 - sizeof(EMemory::Node);
+      size_t bs = sz + sizeof(EMemory::Block);
+      bs += bs % sizeof(pVoid);
+      size_t bc = ns / bs;
+      if (bc < 5)
+      {
+         pool_.setSize(sz, 0, 5);
+      }
+      else
+      {
+         ns = sizeof(EMemory::Node) + bc * bs;
+         pool_.setSize(sz, ns);
+      }
+   }
+
+   poolinit_.store(True, std::memory_order_release);
+}
+
+Void InternalMsg::initPool()
+{
+   EMutexLock l(poolmtx_);
+   if (poolinit_.load(std::memory_order_relaxed))
+      return;
+
+   size_t as = 0;
+   if (sizeof(RspOut) > as)   as = sizeof(RspOut);
+   if (sizeof(RspIn) > as)   as = sizeof(RspIn);
+   if (sizeof(ReqOut) > as)   as = sizeof(ReqOut);
+   if (sizeof(ReqIn) > as)   as = sizeof(ReqIn);
+
+   size_t ns = 32768 - sizeof(EMemory::Node);
+   size_t bs = as + sizeof(EMemory::Block);
+   bs += bs % sizeof(pVoid);
+   size_t bc = ns / bs;
+   ns = sizeof(EMemory::Node) + bc * bs;
+   pool_.setSize(as, ns);
+
+   poolinit_.store(True, std::memory_order_release);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -298,11 +400,30 @@ Void Initialize()
    static EString __method__ = __METHOD_NAME__;
 
    Configuration::logger().startup("{} - initializing the timer pool", __method__);
-   ETimerPool::Instance().init();
-   Configuration::logger().startup("{} - initializing the communication thread", __method__);
-   CommunicationThread::Instance().init(1, 101, NULL, 100000);
-   Configuration::logger().startup("{} - initializing the translation thread", __method__);
-   TranslationThread::Instance().init(1, 102, NULL, 100000);
+   ETimerPool::Instance().setPlacement(Configuration::timerPlacement()).init();
+   Configuration::logger().startup("{} - timer pool thread placement {}",
+      __method__, ETimerPool::Instance().getPlacementReport());
+   for (Int shard = 0; shard < CommunicationThread::shards(); shard++)
+   {
+      if (Configuration::nodeMessagePriority())
+      {
+         // a second queue priority for the node messages
+         EThreadQueuePolicy policy = Configuration::nodeMessageWeight() > 0 ?
+            EThreadQueuePolicy::Weighted : EThreadQueuePolicy::Strict;
+         CommunicationThread::Instance(shard).setQueuePriorities(2, policy, Configuration::nodeMessageWeight());
+         TranslationThread::Instance(shard).setQueuePriorities(2, policy, Configuration::nodeMessageWeight());
+      }
+      Configuration::logger().startup("{} - initializing the communication thread shard={}", __method__, shard);
+      CommunicationThread::Instance(shard).setPlacement(Configuration::communicationPlacement().forIndex(shard));
+      CommunicationThread::Instance(shard).init(1, 101 + shard * 2, NULL, 100000);
+      Configuration::logger().startup("{} - communication thread shard={} placement {}",
+         __method__, shard, CommunicationThread::Instance(shard).getPlacementReport());
+      Configuration::logger().startup("{} - initializing the translation thread shard={}", __method__, shard);
+      TranslationThread::Instance(shard).setPlacement(Configuration::translationPlacement().forIndex(shard));
+      TranslationThread::Instance(shard).init(1, 102 + shard * 2, NULL, 100000);
+      Configuration::logger().startup("{} - translation thread shard={} placement {}",
+         __method__, shard, TranslationThread::Instance(shard).getPlacementReport());
+   }
    #if 0
    Configuration::logger().startup("{} - sizeof(RspOut)={}", __method__, sizeof(RspOut));
    Configuration::logger().startup("{} - sizeof(RspIn)={}", __method__, sizeof(RspIn));
@@ -325,14 +446,20 @@ Void Uninitialize()
    Configuration::logger().startup("{} - releasing local nodes", __method__);
    CommunicationThread::Instance().releaseLocalNodes();
 
-   Configuration::logger().startup("{} - stopping the translation thread", __method__);
-   TranslationThread::Instance().quit();
-   TranslationThread::Instance().join();
+   Configuration::logger().startup("{} - stopping the translation threads", __method__);
+   for (Int shard = 0; shard < CommunicationThread::shards(); shard++)
+   {
+      TranslationThread::Instance(shard).quit();
+      TranslationThread::Instance(shard).join();
+   }
    TranslationThread::cleanup();
 
-   Configuration::logger().startup("{} - stopping the communication thread", __method__);
-   CommunicationThread::Instance().quit();
-   CommunicationThread::Instance().join();
+   Configuration::logger().startup("{} - stopping the communication threads", __method__);
+   for (Int shard = 0; shard < CommunicationThread::shards(); shard++)
+   {
+      CommunicationThread::Instance(shard).quit();
+      CommunicationThread::Instance(shard).join();
+   }
    CommunicationThread::cleanup();
 
    Configuration::logger().startup("{} - Session counts created={} deleted={}",
@@ -391,9 +518,18 @@ Void TeidRangeManager::release(RemoteNodeSPtr &n)
 ////////////////////////////////////////////////////////////////////////////////
 
 NodeSocket::NodeSocket()
-   : ESocket::UdpPrivate(CommunicationThread::Instance(), Configuration::socketBufferSize())
+   : NodeSocket(0)
+{
+}
+
+NodeSocket::NodeSocket(Int shard)
+   : ESocket::UdpLockFree(CommunicationThread::Instance(shard), Configuration::socketBufferSize())
 {
    static EString __method__ = __METHOD_NAME__;
+   if (Configuration::pooledReceiveBufferSize() > 0)
+      setBatchSize(Configuration::socketBatchSize(), ESocket::UPD_MAX_MSG_LENGTH, &bufferPool());
+   else
+      setBatchSize(Configuration::socketBatchSize());
 }
 
 NodeSocket::~NodeSocket()
@@ -405,9 +541,46 @@ Void NodeSocket::onReceive(const ESocket::Address &src, const ESocket::Address &
 {
    static EString __method__ = __METHOD_NAME__;
 
+   if (steer(src, dst, msg, len, nullptr))
+      return;
+
    ln_->onReceive(ln_, src, dst, msg, len);
 }
 
+Void NodeSocket::onReceiveBuffer(const ESocket::Address &src, const ESocket::Address &dst, EMemory::Buffer &buf)
+{
+   static EString __method__ = __METHOD_NAME__;
+
+   if (steer(src, dst, buf.data(), static_cast<Int>(buf.length()), &buf))
+      return;
+
+   ln_->onReceive(ln_, src, dst, buf.data(), static_cast<Int>(buf.length()), &buf);
+}
+
+Bool NodeSocket::steer(const ESocket::Address &src, const ESocket::Address &dst, cpUChar data, Int len, EMemory::Buffer *buf)
+{
+   static EString __method__ = __METHOD_NAME__;
+
+   // forward the message to the shard that owns the remote node, this is
+   // the normal path for ShardMode::Steering and only occurs while the
+   // SO_REUSEPORT group is being bound for ShardMode::ReusePort
+   Int shard = CommunicationThread::shardOf(src);
+   if (shard == CommunicationThread::currentShard())
+      return False;
+
+   RcvdMsgDataPtr rm = new RcvdMsgData(ln_, src, dst, data, len, buf);
+   CommunicationThread::Instance(shard).sendMessage(EThreadMessage(
+      static_cast<UInt>(CommunicationThread::Events::RcvdMsg), static_cast<pVoid>(rm)));
+   return True;
+}
+
+EMemory::BufferPool &NodeSocket::bufferPool()
+{
+   // shared by all of the NodeSocket's, which are serviced by the CommunicationThread
+   static EMemory::BufferPool pool(Configuration::pooledReceiveBufferSize());
+   return pool;
+}
+
 Void NodeSocket::onError()
 {
    static EString __method__ = __METHOD_NAME__;
@@ -419,6 +592,8 @@ Void NodeSocket::onError()
 RemoteNode::RemoteNode()
    : state_(RemoteNode::State::Initialized),
      trv_(-1),
+     shard_(0),
+     rrtbl_(Configuration::sequenceWindowSize()),
      awndcnt_(0),
      aw_(0)
 {
@@ -447,7 +622,8 @@ RemoteNode &RemoteNode::setNbrActivityWnds(size_t nbr)
 
 RemoteNode &RemoteNode::deleteAllSesssions(RemoteNodeSPtr &rn)
 {
-   auto rn2 = new RemoteNodeSPtr(rn);
+   // the message carries a reference to the remote node
+   RemoteNode *rn2 = RemoteNodeSPtr(rn).detach();
    SEND_TO_COMMUNICATION(DelNxtRmtSession, rn2);
    return *this;
 }
@@ -491,6 +667,8 @@ Void RemoteNode::Stats::reset()
 UInt RemoteNode::Stats::incReceived(MessageId msgid)            { INCREMENT_MESSAGE_STAT(msgid, incReceived) }
 UInt RemoteNode::Stats::incSent(MessageId msgid, UInt attempt)  { INCREMENT_MESSAGE_STAT(msgid, incSent, attempt) }
 UInt RemoteNode::Stats::incTimeout(MessageId msgid)             { INCREMENT_MESSAGE_STAT(msgid, incTimeout)}
+UInt RemoteNode::Stats::incRspCacheHit(MessageId msgid)         { INCREMENT_MESSAGE_STAT(msgid, incRspCacheHit)}
+UInt RemoteNode::Stats::incRspCacheMiss(MessageId msgid)        { INCREMENT_MESSAGE_STAT(msgid, incRspCacheMiss)}
 
 #undef INCREMENT_MESSAGE_STAT
 
@@ -542,21 +720,33 @@ Bool RemoteNode::addRcvdReq(ULong sn)
    if (rcvdReqExists(sn))
       return False;
 
-   RcvdReq rr(sn);
+   return rrtbl_.insert(sn, RcvdReq(sn)) != nullptr;
+}
+
+Bool RemoteNode::setRcvdReqRspWnd(ULong sn, Int wnd)
+{
+   static EString __method__ = __METHOD_NAME__;
 
-   auto result = rrumap_.insert(std::make_pair(rr.seqNbr(), rr));
+   RcvdReq *rr = rrtbl_.setWindow(sn, wnd);
+   if (rr == nullptr)
+      return False;
+   rr->setRspWnd(wnd);
+   return True;
+}
 
-   return result.second;
+const RcvdReq *RemoteNode::rcvdReq(ULong sn) const
+{
+   return rrtbl_.find(sn);
 }
 
-Bool RemoteNode::setRcvdReqRspWnd(ULong sn, Int wnd)
+Bool RemoteNode::setRcvdReqRsp(ULong sn, cpUChar data, UShort len, const EMemory::Buffer *buf)
 {
    static EString __method__ = __METHOD_NAME__;
 
-   auto it = rrumap_.find(sn);
-   if (it == rrumap_.end())
+   RcvdReq *rr = rrtbl_.find(sn);
+   if (rr == nullptr)
       return False;
-   it->second.setRspWnd(wnd);
+   rr->setRsp(data, len, buf);
    return True;
 }
 
@@ -564,14 +754,7 @@ Void RemoteNode::removeRcvdRqstEntries(Int wnd)
 {
    static EString __method__ = __METHOD_NAME__;
 
-   auto it = rrumap_.begin();
-   while (it != rrumap_.end())
-   {
-      if (it->second.rspWnd() == wnd)
-         it = rrumap_.erase(it);
-      else
-         it++;
-   }
+   rrtbl_.expire(wnd);
 }
 
 Void RemoteNode::nextActivityWnd(Int wnd)
@@ -608,14 +791,7 @@ Void RemoteNode::removeOldReqs(Int rw)
 {
    static EString __method__ = __METHOD_NAME__;
 
-   auto entry = rrumap_.begin();
-   while (entry != rrumap_.end())
-   {
-      if (entry->second.rspWnd() == rw)
-         entry = rrumap_.erase(entry);
-      else
-         entry++;
-   }
+   rrtbl_.expire(rw);
 }
 
 RemoteNode &RemoteNode::addSession(SessionBaseSPtr &s)
@@ -639,20 +815,45 @@ RemoteNode &RemoteNode::delSession(SessionBaseSPtr &s)
 ////////////////////////////////////////////////////////////////////////////////
 
 LocalNode::LocalNode()
-   : state_(LocalNode::State::Initialized)
+   : state_(LocalNode::State::Initialized),
+     shards_(CommunicationThread::shards()),
+     ovldshards_(0),
+     ovldrej_(0),
+     ovlddrop_(0),
+     ovldseq_(0),
+     ovldmetric_(0)
 {
    static EString __method__ = __METHOD_NAME__;
+
+   Int shards = static_cast<Int>(shards_.size());
+   for (auto &sh : shards_)
+      sh.sessions.setSeidManager(seidmgr_);
+   shards_[0].socket = &socket_;
+   if (shards > 1 && Configuration::shardMode() == ShardMode::ReusePort)
+   {
+      socket_.setReusePort(shards);
+      for (Int i = 1; i < shards; i++)
+      {
+         shards_[i].socket = new NodeSocket(i);
+         shards_[i].socket->setReusePort(shards);
+      }
+   }
+   else
+   {
+      for (Int i = 1; i < shards; i++)
+         shards_[i].socket = &socket_;
+   }
 }
 
 LocalNode::~LocalNode()
 {
    static EString __method__ = __METHOD_NAME__;
 
-   auto entry = roumap_.begin();
-   while (entry != roumap_.end())
+   for (auto &sh : shards_)
    {
-      delete entry->second;
-      entry = roumap_.erase(entry);
+      sh.rotbl.clear([](ReqOutPtr &ro) { delete ro; });
+      if (sh.socket != &socket_)
+         delete sh.socket;
    }
 }
 
@@ -693,30 +894,24 @@ Bool LocalNode::rqstOutExists(ULong seqnbr) const
 {
    static EString __method__ = __METHOD_NAME__;
 
-   auto it = roumap_.find(seqnbr);
-   return it != roumap_.end();
+   return shard().rotbl.exists(seqnbr);
 }
 
 Bool LocalNode::addRqstOut(ReqOut *ro)
 {
    static EString __method__ = __METHOD_NAME__;
 
-   if (rqstOutExists(ro->seqNbr()))
-      return False;
-   
-   auto result = roumap_.insert(std::make_pair(ro->seqNbr(), ro));
-
-   return result.second;
+   return shard().rotbl.insert(ro->seqNbr(), ro) != nullptr;
 }
 
 Bool LocalNode::setRqstOutRespWnd(ULong seqnbr, Int wnd)
 {
    static EString __method__ = __METHOD_NAME__;
 
-   auto it = roumap_.find(seqnbr);
-   if (it == roumap_.end())
+   ReqOutPtr *ro = shard().rotbl.setWindow(seqnbr, wnd);
+   if (ro == nullptr)
       return False;
-   it->second->setRspWnd(wnd);
+   (*ro)->setRspWnd(wnd);
    return True;
 }
 
@@ -724,30 +919,14 @@ Void LocalNode::removeRqstOutEntries(Int wnd)
 {
    static EString __method__ = __METHOD_NAME__;
 
-   auto it = roumap_.begin();
-   while (it != roumap_.end())
-   {
-      if (it->second->rspWnd() == wnd)
-      {
-         ReqOut *ro = it->second;
-         it = roumap_.erase(it);
-         delete ro;
-      }
-      else
-      {
-         it++;
-      }
-   }
+   shard().rotbl.expire(wnd, [](ReqOutPtr &ro) { delete ro; });
 }
 
 Void LocalNode::clearRqstOutEntries()
 {
-   auto it = roumap_.begin();
-   while (it != roumap_.end())
+   for (auto &sh : shards_)
    {
-      ReqOutPtr ro = it->second;
-      it = roumap_.erase(it);
-      delete ro;
+      sh.rotbl.clear([](ReqOutPtr &ro) { delete ro; });
    }
 }
 /// @endcond
@@ -756,9 +935,11 @@ Void LocalNode::setNbrActivityWnds(size_t nbr)
 {
    static EString __method__ = __METHOD_NAME__;
 
+   Int shard = CommunicationThread::currentShard();
    ERDLock lck(rnslck_);
    for (auto &kv : rns_)
-      kv.second->setNbrActivityWnds(nbr);
+      if (kv.second->shard() == shard)
+         kv.second->setNbrActivityWnds(nbr);
 }
 
 /// @cond DOXYGEN_EXCLUDE
@@ -766,19 +947,24 @@ Void LocalNode::nextActivityWnd(Int wnd)
 {
    static EString __method__ = __METHOD_NAME__;
 
+   Int shard = CommunicationThread::currentShard();
    ERDLock lck(rnslck_);
    for (auto &kv : rns_)
-      kv.second->nextActivityWnd(wnd);
+      if (kv.second->shard() == shard)
+         kv.second->nextActivityWnd(wnd);
 }
 
 Void LocalNode::checkActivity(LocalNodeSPtr &ln)
 {
    static EString __method__ = __METHOD_NAME__;
 
-   // check for activity from all of the RemoteNode's
+   // check for activity from all of the RemoteNode's owned by this shard
+   Int shard = CommunicationThread::currentShard();
    ERDLock lck(rnslck_);
    for (auto &kv : rns_)
    {
+      if (kv.second->shard() != shard)
+         continue;
       if (kv.second->state() == RemoteNode::State::Started && !kv.second->checkActivity())
       {
          // Configuration::logger().info("{} - remote {} is inactive", __method__, kv.second->ipAddress().address());
@@ -823,6 +1009,9 @@ RemoteNodeSPtr LocalNode::createRemoteNode(EIpAddress &address, UShort port)
          rn->setAddress(ESocket::Address(address.ipv6Address(), port));
       rn->setIpAddress(address);
 
+      // assign the communication thread shard that owns the RemoteNode
+      rn->setShard(CommunicationThread::shardOf(rn->address()));
+
       // assign the TEID range value for the RemotNode
       if (!CommunicationThread::Instance().assignTeidRangeValue(rn))
          throw RemoteNodeException_UnableToAssignTeidRangeValue();
@@ -831,7 +1020,7 @@ RemoteNodeSPtr LocalNode::createRemoteNode(EIpAddress &address, UShort port)
       rn->setNbrActivityWnds(Configuration::nbrActivityWnds());
 
       // set the activity wnd
-      rn->nextActivityWnd(CommunicationThread::Instance().currentActivityWnd());
+      rn->nextActivityWnd(CommunicationThread::Instance(rn->shard()).currentActivityWnd());
 
       // add the RemoteNode to the RemodeNode collection for this LocalNode
       auto result = rns_.insert(std::make_pair(rn->ipAddress(), rn));
@@ -858,6 +1047,9 @@ Void LocalNode::collectStats(EJsonBuilder &builder)
    try
    {
       EJsonBuilder::StackString pushLocalAddress(builder, ipAddress().address(), "local_address");
+      EJsonBuilder::StackUInt pushOverloaded(builder, overloaded() ? 1 : 0, "overloaded");
+      EJsonBuilder::StackUInt pushOverloadRejected(builder, overloadRejected(), "overload_rejected");
+      EJsonBuilder::StackUInt pushOverloadDropped(builder, overloadDropped(), "overload_dropped");
    }
    catch(std::exception &e)
    {
@@ -879,8 +1071,85 @@ SessionBaseSPtr LocalNode::createSession(LocalNodeSPtr &ln, Seid rs, RemoteNodeS
    return s;
 }
 
+RemoteNodeSPtr LocalNode::findRemoteNode(const ESocket::Address &src)
+{
+   static EString __method__ = __METHOD_NAME__;
+   EIpAddress remoteIpAddress(src.getSockAddrStorage());
+
+   // the shard's copy of the remote nodes is only accessed by this thread
+   RemoteNodeUMap &rns = shard().rns;
+   auto it = rns.find(remoteIpAddress);
+   if (it != rns.end())
+      return it->second;
+
+   RemoteNodeSPtr rn;
+   {
+      ERDLock lck(rnslck_);
+      RemoteNodeUMap::iterator rnit = rns_.find(remoteIpAddress);
+      if (rnit != rns_.end())
+         rn = rnit->second;
+   }
+
+   if (!rn)
+   {
+      // Configuration::logger().debug("{} - remoteNode {} NOT found", __method__, remoteIpAddress.address());
+      rn = createRemoteNode(remoteIpAddress, Configuration::port());
+   }
+
+   rns.insert(std::make_pair(remoteIpAddress, rn));
+   return rn;
+}
+
 /// @cond DOXYGEN_EXCLUDE
-Void LocalNode::onReceive(LocalNodeSPtr &ln, const ESocket::Address &src, const ESocket::Address &dst, cpUChar msg, Int len)
+Bool LocalNode::checkOverload(LocalNodeSPtr &ln)
+{
+   static EString __method__ = __METHOD_NAME__;
+   Int hwm = Configuration::overloadHighWatermark();
+   Int lwm = Configuration::overloadLowWatermark();
+
+   if (hwm <= 0)
+      return False;
+
+   // the load is the percentage in use of the busiest queue that a req passes
+   // through, the TranslationThread of this shard or the application queue
+   TranslationThread &tt = TranslationThread::Instance(CommunicationThread::currentShard());
+   Int size = tt.queueSize();
+   Int load = size > 0 ? static_cast<Int>(static_cast<LongLong>(tt.queueDepth()) * 100 / size) : 0;
+   load = std::max(load, Configuration::baseApplication()._queueLoad());
+
+   // the low watermark must be below the high watermark to leave overload
+   Shard &sh = shard();
+   Bool overloaded = sh.overloaded ? load > std::min(lwm, hwm - 1) : load >= hwm;
+
+   // ask the peers for the reduction that brings the load to the low watermark
+   if (overloaded)
+      ovldmetric_.store(load > lwm ? (load - lwm) * 100 / load : 0, std::memory_order_relaxed);
+
+   if (overloaded == sh.overloaded)
+      return overloaded;
+
+   sh.overloaded = overloaded;
+   if (overloaded)
+   {
+      ovldshards_.fetch_add(1, std::memory_order_relaxed);
+      ovldseq_.fetch_add(1, std::memory_order_relaxed);
+   }
+   else
+   {
+      ovldshards_.fetch_sub(1, std::memory_order_relaxed);
+   }
+
+   Configuration::logger().info("{} - local node {} overloaded={} load={}% shard={}",
+      __method__, ipAddress().address(), sh.overloaded ? "True" : "False", load,
+      CommunicationThread::currentShard());
+
+   LocalNodeOverloadEvent *evnt = new LocalNodeOverloadEvent(ln, sh.overloaded, load);
+   SEND_TO_APPLICATION(LocalNodeOverload, evnt);
+
+   return sh.overloaded;
+}
+
+Void LocalNode::onReceive(LocalNodeSPtr &ln, const ESocket::Address &src, const ESocket::Address &dst, cpUChar msg, Int len, const EMemory::Buffer *buf)
 {
    static EString __method__ = __METHOD_NAME__;
    TranslatorMsgInfo tmi;
@@ -892,29 +1161,9 @@ Void LocalNode::onReceive(LocalNodeSPtr &ln, const ESocket::Address &src, const
       Configuration::translator().getMsgInfo(tmi, msg, len);
 
       // lookup the remote node and create it if it does not exist
-      {
-         EIpAddress remoteIpAddress(src.getSockAddrStorage());
-         Bool exists = False;
-         {
-            ERDLock lck(rnslck_);
-            RemoteNodeUMap::iterator rnit = rns_.find(remoteIpAddress);
-            // Configuration::logger().debug("{} - looking up remoteNode {}", __method__, remoteIpAddress.address());
-            if (rnit != rns_.end())
-            {
-               // Configuration::logger().debug("{} - remoteNode {} found", __method__, remoteIpAddress.address());
-               rn = rnit->second;
-               if (rn->state() != RemoteNode::State::Started)
-                  rn->changeState(rn, RemoteNode::State::Started);
-               exists = True;
-            }
-         }
-         
-         if (!exists)
-         {
-            // Configuration::logger().debug("{} - remoteNode {} NOT found", __method__, remoteIpAddress.address());
-            rn = createRemoteNode(remoteIpAddress, Configuration::port());
-         }
-      }
+      rn = findRemoteNode(src);
+      if (rn->state() != RemoteNode::State::Started)
+         rn->changeState(rn, RemoteNode::State::Started);
 
       // increment the activity for the RemoteNode
       rn->incrementActivity();
@@ -927,11 +1176,34 @@ Void LocalNode::onReceive(LocalNodeSPtr &ln, const ESocket::Address &src, const
          // check to see if this is a duplicate req
          if (!rn->rcvdReqExists(tmi.seqNbr()))
          {
+            // answer a heartbeat req without the round trips through the TranslationThread
+            if (tmi.msgType() == Configuration::pfcpHeartbeatReq && Configuration::heartbeatFastPath() &&
+                ln->sndHeartbeatRsp(rn, tmi, msg, len))
+               return;
+
+            // no new sessions are admitted while overloaded
+            Bool overloaded = ln->checkOverload(ln) && tmi.createSession();
+            if (overloaded && Configuration::overloadAction() == OverloadAction::Drop)
+            {
+               ln->ovlddrop_.fetch_add(1, std::memory_order_relaxed);
+               Configuration::logger().debug(
+                  "{} - overloaded, discarding req local={} remote={} msgType={} seqNbr={} version={} msgLen={}",
+                  __method__, ln->ipAddress().address(), rn->ipAddress().address(), tmi.msgType(),
+                  tmi.seqNbr(), tmi.version(), len);
+               return;
+            }
+
             // create and populate ReqIn
-            ReqInPtr ri = new ReqIn(ln, rn, tmi, msg, len);
+            ReqInPtr ri = buf ? new ReqIn(ln, rn, tmi, *buf) : new ReqIn(ln, rn, tmi, msg, len);
 
             // lookup or create the session
-            if (tmi.createSession())
+            if (overloaded)
+            {
+               // the TranslationThread answers the req without a session
+               ri->rejectCause(Configuration::overloadCause());
+               ln->ovldrej_.fetch_add(1, std::memory_order_relaxed);
+            }
+            else if (tmi.createSession())
             {
                ri->setSession(ln->createSession(ln, rn));
                if(!ri->session())
@@ -989,39 +1261,63 @@ Void LocalNode::onReceive(LocalNodeSPtr &ln, const ESocket::Address &src, const
          }
          else
          {
-            // duplicate msg, so discard it
-            if (tmi.msgClass() == MsgClass::Session)
+            const RcvdReq *rr = rn->rcvdReq(tmi.seqNbr());
+            if (Configuration::responseCache() && rr->hasRsp())
             {
+               // duplicate req that has already been answered, resend the rsp
+               // without involving the TranslationThread or the application
+               if (rr->rspBuffer().valid())
+                  shard().socket->write(rn->address(), rr->rspBuffer());
+               else
+                  shard().socket->write(rn->address(), rr->rspData(), rr->rspLen());
+               rn->stats().incRspCacheHit(tmi.msgType());
+
                Configuration::logger().debug(
-                  "{} - discarding duplicate req local={} remote={} seid={} msgType={} msgClass=SESSION seqNbr={} version={} msgLen={}",
-                  __method__, ln->ipAddress().address(), rn->ipAddress().address(), tmi.seid(),
-                  tmi.msgType(), tmi.seqNbr(), tmi.version(), len);
+                  "{} - resending the rsp to a duplicate req local={} remote={} msgType={} seqNbr={} version={} msgLen={}",
+                  __method__, ln->ipAddress().address(), rn->ipAddress().address(), tmi.msgType(),
+                  tmi.seqNbr(), tmi.version(), len);
             }
             else
             {
-               Configuration::logger().debug(
-                  "{} - discarding duplicate req local={} remote={} msgType={} msgClass={} seqNbr={} version={} msgLen={}",
-                  __method__, ln->ipAddress().address(), rn->ipAddress().address(), tmi.msgType(),
-                  tmi.msgClass()==MsgClass::Node?"NODE":"UNKNOWN", tmi.seqNbr(), tmi.version(), len);
+               // duplicate msg, so discard it
+               rn->stats().incRspCacheMiss(tmi.msgType());
+               if (tmi.msgClass() == MsgClass::Session)
+               {
+                  Configuration::logger().debug(
+                     "{} - discarding duplicate req local={} remote={} seid={} msgType={} msgClass=SESSION seqNbr={} version={} msgLen={}",
+                     __method__, ln->ipAddress().address(), rn->ipAddress().address(), tmi.seid(),
+                     tmi.msgType(), tmi.seqNbr(), tmi.version(), len);
+               }
+               else
+               {
+                  Configuration::logger().debug(
+                     "{} - discarding duplicate req local={} remote={} msgType={} msgClass={} seqNbr={} version={} msgLen={}",
+                     __method__, ln->ipAddress().address(), rn->ipAddress().address(), tmi.msgType(),
+                     tmi.msgClass()==MsgClass::Node?"NODE":"UNKNOWN", tmi.seqNbr(), tmi.version(), len);
+               }
             }
          }
       }
       else
       {
          // locate the corresponding ReqOut entry
-         auto roit = roumap_.find(tmi.seqNbr());
-         if (roit != roumap_.end())
+         Int rw = CommunicationThread::Instance().currentRspWnd();
+         ReqOutPtr *roit = shard().rotbl.setWindow(tmi.seqNbr(), rw);
+         if (roit != nullptr)
          {
             // ReqOut entry found, set the rsp wnd for the req
-            roit->second->setRspWnd(CommunicationThread::Instance().currentRspWnd());
+            ReqOutPtr ro = *roit;
+            ro->setRspWnd(rw);
 
             // stop the retransmit timer
-            roit->second->stopT1();
+            ro->stopT1();
 
             // create and poulate RspIn
-            RspInPtr ri = new RspIn(ln, rn, tmi, msg, len, roit->second->appMsg());
+            // the remote node is not used again, so its reference is handed to the RspIn
+            RspInPtr ri = buf ? new RspIn(ln, std::move(rn), tmi, *buf, ro->appMsg()) :
+               new RspIn(ln, std::move(rn), tmi, msg, len, ro->appMsg());
 
-            roit->second->setAppMsg(nullptr);
+            ro->setAppMsg(nullptr);
 
             // snd RspIn to TranslationThread
             SEND_TO_TRANSLATION(RcvdRsp, ri);
@@ -1077,12 +1373,12 @@ Bool LocalNode::onReqOutTimeout(ReqOutPtr ro)
    }
 
    // lookup the ReqOut entry
-   auto entry = roumap_.find(ro->seqNbr());
-   if (entry != roumap_.end()) // found the entry
+   ReqOutTable &rotbl = shard().rotbl;
+   if (rotbl.exists(ro->seqNbr())) // found the entry
    {
       if (sndReq(ro))
          return True;
-      roumap_.erase(entry);
+      rotbl.erase(ro->seqNbr());
    }
    else
    {
@@ -1103,37 +1399,24 @@ Void LocalNode::removeOldReqs(Int rw)
    static EString __method__ = __METHOD_NAME__;
 
    // remove the old ReqOut entries
-   auto entry = roumap_.begin();
-   while (entry != roumap_.end())
-   {
-      if (entry->second->rspWnd() == rw)
-      {
-         ReqOutPtr ro = entry->second;
-         entry = roumap_.erase(entry);
-         delete ro;
-      }
-      else
-      {
-         entry++;
-      }
-   }
+   shard().rotbl.expire(rw, [](ReqOutPtr &ro) { delete ro; });
 
    // remove the old RcvdReq entries
+   Int shard = CommunicationThread::currentShard();
    ERDLock lck(rnslck_);
    for (auto &kv : rns_)
-      kv.second->removeOldReqs(rw);
+      if (kv.second->shard() == shard)
+         kv.second->removeOldReqs(rw);
 }
 
 Void LocalNode::sndInitialReq(ReqOutPtr ro)
 {
    static EString __method__ = __METHOD_NAME__;
 
-   // check to see if the ReqOut entry already exists
-   auto roit = roumap_.find(ro->seqNbr());
-   if (roit == roumap_.end())
+   // add the ReqOut entry to retransmit collection if it does not already exist
+   ReqOutTable &rotbl = shard().rotbl;
+   if (rotbl.insert(ro->seqNbr(), ro) != nullptr)
    {
-      // add the ReqOut entry to retransmit collection
-      roumap_.insert(std::make_pair(ro->seqNbr(), ro));
       sndReq(ro);
    }
    else
@@ -1172,8 +1455,12 @@ Bool LocalNode::sndReq(ReqOutPtr ro)
 
    if (ro->okToSnd()) // implicitly decrements the retransmission count
    {
-      // snd the data
-      socket_.write(ro->remoteNode()->address(), ro->data(), ro->len());
+      // snd the data, a pooled buffer is referenced by the socket and
+      // reused by each retransmission instead of being copied
+      if (ro->buffer())
+         shard().socket->write(ro->remoteNode()->address(), *ro->buffer());
+      else
+         shard().socket->write(ro->remoteNode()->address(), ro->data(), ro->len());
       ro->startT1();
 
       UInt attempt = (ro->msgType() == Configuration::pfcpHeartbeatReq ? Configuration::heartbeatN1() : Configuration::n1()) - (ro->n1() + 1);
@@ -1212,7 +1499,14 @@ Void LocalNode::sndRsp(RspOutPtr ro)
    if (ro->remoteNode()->setRcvdReqRspWnd(ro->seqNbr()))
    {
       // snd the data
-      socket_.write(ro->remoteNode()->address(), ro->data(), ro->len());
+      if (ro->buffer())
+         shard().socket->write(ro->remoteNode()->address(), *ro->buffer());
+      else
+         shard().socket->write(ro->remoteNode()->address(), ro->data(), ro->len());
+
+      // keep the encoded rsp for the rsp window to answer a duplicate req
+      if (Configuration::responseCache())
+         ro->remoteNode()->setRcvdReqRsp(ro->seqNbr(), ro->data(), ro->len(), ro->buffer());
 
       ro->remoteNode()->stats().incSent(ro->msgType());
    }
@@ -1225,6 +1519,37 @@ Void LocalNode::sndRsp(RspOutPtr ro)
    // delete the RspOut object
    delete ro;
 }
+
+Bool LocalNode::sndHeartbeatRsp(RemoteNodeSPtr &rn, const TranslatorMsgInfo &tmi, cpUChar msg, Int len)
+{
+   static EString __method__ = __METHOD_NAME__;
+   Shard &sh = shard();
+   ETime startTime;
+
+   if (sh.hbrsplen < 0)
+      sh.hbrsplen = Configuration::translator().encodeHeartbeatRspTemplate(*this, sh.hbrsp, sizeof(sh.hbrsp));
+
+   // fall back to the TranslationThread for anything unexpected
+   if (sh.hbrsplen == 0 || !Configuration::translator().parseHeartbeatReq(msg, len, startTime) ||
+       !rn->addRcvdReq(tmi.seqNbr()))
+      return False;
+
+   // if remote has restarted, snd notification to application thread
+   if (rn->startTime() != startTime)
+      rn->restarted(rn, startTime);
+
+   Configuration::translator().assignRspSeqNbr(sh.hbrsp, tmi.seqNbr());
+   rn->setRcvdReqRspWnd(tmi.seqNbr());
+   sh.socket->write(rn->address(), sh.hbrsp, sh.hbrsplen);
+
+   // keep the encoded rsp for the rsp window to answer a duplicate req
+   if (Configuration::responseCache())
+      rn->setRcvdReqRsp(tmi.seqNbr(), sh.hbrsp, sh.hbrsplen, nullptr);
+
+   rn->stats().incSent(Configuration::pfcpHeartbeatRsp);
+
+   return True;
+}
 /// @endcond
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1238,6 +1563,63 @@ Translator::~Translator()
 {
 }
 
+RspOutPtr Translator::encodeOverloadRsp(ReqInPtr msg, UChar cause)
+{
+   return nullptr;
+}
+
+Bool Translator::parseHeartbeatReq(cpUChar msg, Int len, ETime &startTime)
+{
+   return False;
+}
+
+UShort Translator::encodeHeartbeatRspTemplate(LocalNode &ln, pUChar dest, UShort len)
+{
+   return 0;
+}
+
+Void Translator::assignRspSeqNbr(pUChar rsp, ULong seqNbr)
+{
+}
+
+pUChar Translator::encodeBuffer(EMemory::Buffer &buf)
+{
+   if (Configuration::pooledSendBufferSize() <= 0)
+      return scratch();
+
+   // the message is encoded directly into the buffer that is sent, and
+   // retransmitted, by the CommunicationThread, the encoders expect the
+   // destination to be zeroed
+   buf = sendBufferPool().allocate();
+   std::memset(buf.data(), 0, buf.capacity());
+   return buf.data();
+}
+
+Void Translator::assignEncoded(InternalMsg &msg, EMemory::Buffer &buf, UShort len)
+{
+   if (buf.valid())
+      msg.assign(buf.setLength(len));
+   else
+      msg.assign(scratch(), len);
+}
+
+pUChar Translator::scratch()
+{
+   // the TranslationThread shards share the Translator and encode
+   // concurrently, so each thread has its own encode buffer
+   thread_local std::unique_ptr<UChar[]> data;
+   if (!data)
+      data.reset(new UChar[ESocket::UPD_MAX_MSG_LENGTH]());
+   return data.get();
+}
+
+EMemory::BufferPool &Translator::sendBufferPool()
+{
+   // shared by all of the TranslationThread's
+   static EMemory::BufferPool pool(Configuration::pooledSendBufferSize());
+   return pool;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -1257,14 +1639,14 @@ Void ApplicationWorker::onInit()
 {
    static EString __method__ = __METHOD_NAME__;
 
-   EThreadWorkerPrivate::onInit();
+   EThreadWorkerLockFree::onInit();
 }
 
 Void ApplicationWorker::onQuit()
 {
    static EString __method__ = __METHOD_NAME__;
 
-   EThreadWorkerPrivate::onQuit();
+   EThreadWorkerLockFree::onQuit();
 }
 
 Void ApplicationWorker::onRcvdReq(AppMsgReqPtr req)
@@ -1349,6 +1731,16 @@ Void ApplicationWorker::onLocalNodeStateChange(LocalNodeSPtr &ln, LocalNode::Sta
       __method__, workerId(), ln->ipAddress().address(), oldState, newState);
 }
 
+Void ApplicationWorker::onLocalNodeOverload(LocalNodeSPtr &ln, Bool overloaded, Int load)
+{
+   static EString __method__ = __METHOD_NAME__;
+   Configuration::logger().debug(
+      "{}"
+      " workerId={}"
+      " address={} overloaded={} load={}",
+      __method__, workerId(), ln->ipAddress().address(), overloaded ? "True" : "False", load);
+}
+
 Void ApplicationWorker::onRemoteNodeStateChange(RemoteNodeSPtr &rn, RemoteNode::State oldState, RemoteNode::State newState)
 {
    static EString __method__ = __METHOD_NAME__;
@@ -1503,6 +1895,14 @@ Void ApplicationWorker::_onLocalNodeStateChange(EThreadMessage &msg)
    delete evnt;
 }
 
+Void ApplicationWorker::_onLocalNodeOverload(EThreadMessage &msg)
+{
+   static EString __method__ = __METHOD_NAME__;
+   LocalNodeOverloadEvent *evnt = static_cast<LocalNodeOverloadEvent*>(msg.getVoidPtr());
+   onLocalNodeOverload(evnt->localNode(), evnt->overloaded(), evnt->load());
+   delete evnt;
+}
+
 Void ApplicationWorker::_onRemoteNodeStateChange(EThreadMessage &msg)
 {
    static EString __method__ = __METHOD_NAME__;
@@ -1555,7 +1955,7 @@ Void ApplicationWorker::_onEncodeRspError(EThreadMessage &msg)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-BEGIN_MESSAGE_MAP(TranslationThread, EThreadPrivate)
+BEGIN_MESSAGE_MAP(TranslationThread, EThreadLockFree)
    ON_MESSAGE(static_cast<UInt>(TranslationThread::Events::SndMsg), TranslationThread::onSndPfcpMsg)
    ON_MESSAGE(static_cast<UInt>(TranslationThread::Events::RcvdReq), TranslationThread::onRcvdReq)
    ON_MESSAGE(static_cast<UInt>(TranslationThread::Events::RcvdRsp), TranslationThread::onRcvdRsp)
@@ -1564,35 +1964,35 @@ BEGIN_MESSAGE_MAP(TranslationThread, EThreadPrivate)
 END_MESSAGE_MAP()
 
 /// @cond DOXYGEN_EXCLUDE
-TranslationThread::TranslationThread()
-   : xlator_(Configuration::translator())
+TranslationThread::TranslationThread(Int shard)
+   : xlator_(Configuration::translator()),
+     shard_(shard)
 {
    static EString __method__ = __METHOD_NAME__;
-
-   this_ = this;
 }
 
 TranslationThread::~TranslationThread()
 {
    static EString __method__ = __METHOD_NAME__;
-
-   this_ = nullptr;
 }
 
 Void TranslationThread::onInit()
 {
    static EString __method__ = __METHOD_NAME__;
 
-   EThreadPrivate::onInit();
+   // messages sent from this thread stay within the shard
+   CommunicationThread::curshard_ = shard_;
+
+   EThreadLockFree::onInit();
 
-   Configuration::logger().startup("{} - the translation thread has been started", __method__);
+   Configuration::logger().startup("{} - the translation thread has been started shard={}", __method__, shard_);
 }
 
 Void TranslationThread::onQuit()
 {
    static EString __method__ = __METHOD_NAME__;
 
-   EThreadPrivate::onQuit();
+   EThreadLockFree::onQuit();
 }
 
 Void TranslationThread::onSndPfcpMsg(EThreadMessage &msg)
@@ -1710,7 +2110,23 @@ Void TranslationThread::onRcvdReq(EThreadMessage &msg)
    {
       if (xlator_.isVersionSupported(ri->version()))
       {
-         if (ri->msgType() == Configuration::pfcpHeartbeatReq)
+         if (ri->rejectCause() != 0)
+         {
+            // rejected while overloaded, the application never sees the req
+            RspOutPtr ro = xlator_.encodeOverloadRsp(ri, ri->rejectCause());
+            if (ro != nullptr)
+            {
+               SEND_TO_COMMUNICATION(SndRsp, ro);
+            }
+            else
+            {
+               // no rsp will set the response window of the RcvdReq, so the
+               // CommunicationThread removes it and deletes the ReqIn
+               SEND_TO_COMMUNICATION(RcvdReqDropped, ri);
+               ri = nullptr;
+            }
+         }
+         else if (ri->msgType() == Configuration::pfcpHeartbeatReq)
          {
             hb = xlator_.decodeHeartbeatReq(ri);
             // Configuration::logger().debug(
@@ -1910,7 +2326,7 @@ Void TranslationThread::onSndHeartbeatRsp(EThreadMessage &msg)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-BEGIN_MESSAGE_MAP(CommunicationThread, ESocket::ThreadPrivate)
+BEGIN_MESSAGE_MAP(CommunicationThread, ESocket::ThreadLockFree)
    ON_MESSAGE(static_cast<UInt>(CommunicationThread::Events::SndReq), CommunicationThread::onSndReq)
    ON_MESSAGE(static_cast<UInt>(CommunicationThread::Events::SndRsp), CommunicationThread::onSndRsp)
    ON_MESSAGE(static_cast<UInt>(CommunicationThread::Events::HeartbeatReq), CommunicationThread::onHeartbeatReq)
@@ -1923,29 +2339,35 @@ BEGIN_MESSAGE_MAP(CommunicationThread, ESocket::ThreadPrivate)
    ON_MESSAGE(static_cast<UInt>(CommunicationThread::Events::AddSession), CommunicationThread::onAddSession)
    ON_MESSAGE(static_cast<UInt>(CommunicationThread::Events::DelSession), CommunicationThread::onDelSession)
    ON_MESSAGE(static_cast<UInt>(CommunicationThread::Events::DelNxtRmtSession), CommunicationThread::onDelNxtRmtSession)
+   ON_MESSAGE(static_cast<UInt>(CommunicationThread::Events::RcvdMsg), CommunicationThread::onRcvdMsg)
+   ON_MESSAGE(static_cast<UInt>(CommunicationThread::Events::RcvdReqDropped), CommunicationThread::onRcvdReqDropped)
 END_MESSAGE_MAP()
 
 /// @cond DOXYGEN_EXCLUDE
-CommunicationThread::CommunicationThread()
+CommunicationThread::CommunicationThread(Int shard)
    : trm_(Configuration::teidRangeBits()),
+     shard_(shard),
      caw_(0),
      crw_(rwOne_)
 {
    static EString __method__ = __METHOD_NAME__;
-   this_ = this;
+
+   // the activity and response timers expire from the socket event loop
+   setTimerMode(EThreadEventTimerMode::EventLoop);
 }
 
 CommunicationThread::~CommunicationThread()
 {
    static EString __method__ = __METHOD_NAME__;
-   this_ = nullptr;
 }
 
 Void CommunicationThread::onInit()
 {
    static EString __method__ = __METHOD_NAME__;
 
-   ESocket::ThreadPrivate::onInit();
+   curshard_ = shard_;
+
+   ESocket::ThreadLockFree::onInit();
 
    setNbrActivityWnds(Configuration::nbrActivityWnds());
 
@@ -1961,7 +2383,7 @@ Void CommunicationThread::onInit()
    initTimer(rsptmr_);
    rsptmr_.start();
 
-   Configuration::logger().startup("{} - the communication thread has been started", __method__);
+   Configuration::logger().startup("{} - the communication thread has been started shard={}", __method__, shard_);
 }
 
 Void CommunicationThread::onQuit()
@@ -1970,7 +2392,7 @@ Void CommunicationThread::onQuit()
 
    atmr_.stop();
 
-   ESocket::ThreadPrivate::onQuit();
+   ESocket::ThreadLockFree::onQuit();
 }
 
 Void CommunicationThread::onTimer(EThreadEventTimer *ptimer)
@@ -1994,7 +2416,7 @@ Void CommunicationThread::onTimer(EThreadEventTimer *ptimer)
    }
 }
 
-Void CommunicationThread::errorHandler(EError &err, ESocket::BasePrivate *psocket)
+Void CommunicationThread::errorHandler(EError &err, ESocket::BaseLockFree *psocket)
 {
    static EString __method__ = __METHOD_NAME__;
 
@@ -2002,7 +2424,7 @@ Void CommunicationThread::errorHandler(EError &err, ESocket::BasePrivate *psocke
    {
       case ESocket::SocketType::Udp:
       {
-         ESocket::UdpPrivate *s = static_cast<ESocket::UdpPrivate*>(psocket);
+         ESocket::UdpLockFree *s = static_cast<ESocket::UdpLockFree*>(psocket);
          Configuration::logger().major("CommunicationThread socket exception for [{} : {}] error - {}",
             s->getLocalAddress(), s->getLocalPort(), err.what());
          break;
@@ -2024,8 +2446,16 @@ LocalNodeSPtr CommunicationThread::createLocalNode(ESocket::Address &addr, Bool
    ln->setAddress(addr);
    ln->setStartTime();
 
-   ln->socket().setLocalNode(ln);
-   ln->socket().bind(addr);
+   // the sockets of a SO_REUSEPORT group are bound in shard order, which
+   // is the order that the steering program selects them in
+   for (auto &sh : ln->shards_)
+   {
+      if (&sh == &ln->shards_[0] || sh.socket != &ln->socket())
+      {
+         sh.socket->setLocalNode(ln);
+         sh.socket->bind(addr);
+      }
+   }
 
    if (start)
       startLocalNode(ln);
@@ -2056,8 +2486,14 @@ Void CommunicationThread::releaseLocalNodes()
    {
       stopLocalNode(entry->second);
       entry->second->clearRqstOutEntries();
-      entry->second->socket().disconnect();
-      entry->second->socket().clearLocalNode();
+      for (auto &sh : entry->second->shards_)
+      {
+         if (&sh == &entry->second->shards_[0] || sh.socket != &entry->second->socket())
+         {
+            sh.socket->disconnect();
+            sh.socket->clearLocalNode();
+         }
+      }
       Configuration::logger().info("{} - localNode={} use_count={}", __method__,
          entry->second->address().getAddress(), entry->second.use_count());
       entry = lns_.erase(entry);
@@ -2302,50 +2738,74 @@ Void CommunicationThread::onReqTimeout(EThreadMessage &msg)
 Void CommunicationThread::onAddSession(EThreadMessage &msg)
 {
    static EString __method__ = __METHOD_NAME__;
-   SessionBaseSPtr *s = reinterpret_cast<SessionBaseSPtr*>(msg.getVoidPtr());
+   SessionBaseSPtr s = SessionBaseSPtr::attach(static_cast<SessionBase*>(msg.getVoidPtr()));
 
-   if (s == nullptr || !*s)
+   if (!s)
       Configuration::logger().minor("{} - SessionBaseSPtr is not valid", __method__);
    else
-      addSession(*s);
-
-   delete s;
+      addSession(s);
 }
 
 Void CommunicationThread::onDelSession(EThreadMessage &msg)
 {
    static EString __method__ = __METHOD_NAME__;
-   SessionBaseSPtr *s = reinterpret_cast<SessionBaseSPtr*>(msg.getVoidPtr());
-   if (s == nullptr || !*s)
+   SessionBaseSPtr s = SessionBaseSPtr::attach(static_cast<SessionBase*>(msg.getVoidPtr()));
+   if (!s)
       Configuration::logger().minor("{} - SessionBaseSPtr is not valid", __method__);
    else
-      delSession(*s);
-
-   delete s;
+      delSession(s);
 }
 
 Void CommunicationThread::onDelNxtRmtSession(EThreadMessage &msg)
 {
    static EString __method__ = __METHOD_NAME__;
-   RemoteNodeSPtr *rn = reinterpret_cast<RemoteNodeSPtr*>(msg.getVoidPtr());
+   RemoteNodeSPtr rn = RemoteNodeSPtr::attach(static_cast<RemoteNode*>(msg.getVoidPtr()));
    if (rn)
    {
-      SessionBaseSPtr s = (*rn)->getFirstSession();
+      SessionBaseSPtr s = rn->getFirstSession();
       if (s)
       {
          delSession(s);
-         SEND_TO_COMMUNICATION(DelNxtRmtSession, rn);
+         RemoteNode *rn2 = rn.detach();
+         SEND_TO_COMMUNICATION(DelNxtRmtSession, rn2);
       }
       else
       {
-         if ((*rn)->state() == RemoteNode::State::Stopping)
-            (*rn)->changeState(*rn, RemoteNode::State::Stopped);
-         // the remote node should be deleted after the final statistics have been reported.
-         delete rn;
+         if (rn->state() == RemoteNode::State::Stopping)
+            rn->changeState(rn, RemoteNode::State::Stopped);
+         // the remote node should be released after the final statistics have been reported.
       }
    }
 }
 
+Void CommunicationThread::onRcvdMsg(EThreadMessage &msg)
+{
+   static EString __method__ = __METHOD_NAME__;
+   RcvdMsgDataPtr rm = static_cast<RcvdMsgDataPtr>(msg.getVoidPtr());
+   if (rm)
+   {
+      if (rm->localNode())
+         rm->localNode()->onReceive(rm->localNode(), rm->src(), rm->dst(), rm->data(), rm->len(), rm->buffer());
+      delete rm;
+   }
+}
+
+Void CommunicationThread::onRcvdReqDropped(EThreadMessage &msg)
+{
+   static EString __method__ = __METHOD_NAME__;
+   ReqInPtr ri = static_cast<ReqInPtr>(msg.getVoidPtr());
+   if (ri)
+   {
+      // remove the RcvdReq so that a retransmission is not discarded as a duplicate
+      ri->remoteNode()->delRcvdReq(ri->seqNbr());
+      Configuration::logger().debug(
+         "{} - overloaded, discarding req local={} remote={} msgType={} seqNbr={}",
+         __method__, ri->localNode()->ipAddress().address(), ri->remoteNode()->ipAddress().address(),
+         ri->msgType(), ri->seqNbr());
+      delete ri;
+   }
+}
+
 Void CommunicationThread::addSession(SessionBaseSPtr &s)
 {
    static EString __method__ = __METHOD_NAME__;
@@ -212,9 +212,219 @@ ThreadError_UnableToWritePipe::ThreadError_UnableToWritePipe()
    appendLastOsError();
 }
 
+ThreadError_UnableToCreateDemultiplexer::ThreadError_UnableToCreateDemultiplexer()
+{
+   setSevere();
+   setTextf("%s: Error while creating the event demultiplexer - ", Name());
+   appendLastOsError();
+}
+
+ThreadError_UnableToRegisterSocket::ThreadError_UnableToRegisterSocket(cpStr msg)
+{
+   setSevere();
+   setTextf("%s: Unable to register the socket with the event demultiplexer - %s", Name(), msg);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
 /// @endcond
 
+////////////////////////////////////////////////////////////////////////////////
+// EventDemultiplexer
+////////////////////////////////////////////////////////////////////////////////
+
+EventDemultiplexer *EventDemultiplexer::create(DemuxType type)
+{
+   if (type == DemuxType::Epoll)
+   {
+      try
+      {
+         return new EpollDemultiplexer();
+      }
+      catch (ThreadError_UnableToCreateDemultiplexer &e)
+      {
+         // fall back to select()
+      }
+   }
+
+   return new SelectDemultiplexer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+SelectDemultiplexer::SelectDemultiplexer()
+   : m_maxfd(-1)
+{
+   FD_ZERO(&m_read);
+   FD_ZERO(&m_write);
+}
+
+Void SelectDemultiplexer::add(Int fd)
+{
+   if (fd < 0 || fd >= FD_SETSIZE)
+   {
+      EString msg;
+      msg.format("file descriptor %d exceeds the select() limit of %d, use the epoll demultiplexer", fd, FD_SETSIZE);
+      throw ThreadError_UnableToRegisterSocket(msg.c_str());
+   }
+
+   EMutexLock l(m_mutex);
+   FD_SET(fd, &m_read);
+   FD_CLR(fd, &m_write);
+   if (fd > m_maxfd)
+      m_maxfd = fd;
+}
+
+Void SelectDemultiplexer::remove(Int fd)
+{
+   if (fd < 0 || fd >= FD_SETSIZE)
+      return;
+
+   EMutexLock l(m_mutex);
+   FD_CLR(fd, &m_read);
+   FD_CLR(fd, &m_write);
+   while (m_maxfd >= 0 && !FD_ISSET(m_maxfd, &m_read))
+      m_maxfd--;
+}
+
+Bool SelectDemultiplexer::setWriteInterest(Int fd, Bool enable)
+{
+   if (fd < 0 || fd >= FD_SETSIZE)
+      return False;
+
+   EMutexLock l(m_mutex);
+   if (enable)
+      FD_SET(fd, &m_write);
+   else
+      FD_CLR(fd, &m_write);
+   return True;
+}
+
+Int SelectDemultiplexer::wait(Event *events, Int maxEvents, Int timeout)
+{
+   fd_set readworking, writeworking, errorworking;
+   Int maxfd;
+
+   {
+      EMutexLock l(m_mutex);
+      memcpy(&readworking, &m_read, sizeof(m_read));
+      memcpy(&writeworking, &m_write, sizeof(m_write));
+      memcpy(&errorworking, &m_read, sizeof(m_read));
+      maxfd = m_maxfd + 1;
+   }
+
+   struct timeval tv, *ptv = NULL;
+   if (timeout >= 0)
+   {
+      tv.tv_sec = timeout / 1000;
+      tv.tv_usec = (timeout % 1000) * 1000;
+      ptv = &tv;
+   }
+
+   Int fdcnt = select(maxfd, &readworking, &writeworking, &errorworking, ptv);
+   if (fdcnt <= 0)
+      return fdcnt;
+
+   // any events beyond maxEvents are reported again by the next call since
+   // select() is level triggered
+   Int evcnt = 0;
+   for (Int fd = 0; fd < maxfd && fdcnt > 0 && evcnt < maxEvents; fd++)
+   {
+      Int ev = 0;
+      if (FD_ISSET(fd, &errorworking))
+      {
+         ev |= EventError;
+         fdcnt--;
+      }
+      if (FD_ISSET(fd, &readworking))
+      {
+         ev |= EventRead;
+         fdcnt--;
+      }
+      if (FD_ISSET(fd, &writeworking))
+      {
+         ev |= EventWrite;
+         fdcnt--;
+      }
+      if (ev)
+      {
+         events[evcnt].fd = fd;
+         events[evcnt].events = ev;
+         evcnt++;
+      }
+   }
+
+   return evcnt;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+EpollDemultiplexer::EpollDemultiplexer()
+{
+   m_epfd = epoll_create1(EPOLL_CLOEXEC);
+   if (m_epfd == -1)
+      throw ThreadError_UnableToCreateDemultiplexer();
+}
+
+EpollDemultiplexer::~EpollDemultiplexer()
+{
+   if (m_epfd != -1)
+      ::close(m_epfd);
+}
+
+Void EpollDemultiplexer::add(Int fd)
+{
+   struct epoll_event ev;
+   std::memset(&ev, 0, sizeof(ev));
+   ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+   ev.data.fd = fd;
+   if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, fd, &ev) == -1)
+   {
+      Char err[256];
+      throw ThreadError_UnableToRegisterSocket(strerror_r(errno, err, sizeof(err)));
+   }
+}
+
+Void EpollDemultiplexer::remove(Int fd)
+{
+   struct epoll_event ev;
+   std::memset(&ev, 0, sizeof(ev));
+   // the descriptor may already be closed, which also removes it from the epoll set
+   epoll_ctl(m_epfd, EPOLL_CTL_DEL, fd, &ev);
+}
+
+Bool EpollDemultiplexer::setWriteInterest(Int fd, Bool enable)
+{
+   struct epoll_event ev;
+   std::memset(&ev, 0, sizeof(ev));
+   ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET | (enable ? EPOLLOUT : 0);
+   ev.data.fd = fd;
+   return epoll_ctl(m_epfd, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+Int EpollDemultiplexer::wait(Event *events, Int maxEvents, Int timeout)
+{
+   if (maxEvents > MaxEvents)
+      maxEvents = MaxEvents;
+
+   Int cnt = epoll_wait(m_epfd, m_events, maxEvents, timeout);
+   for (Int i = 0; i < cnt; i++)
+   {
+      uint32_t ev = m_events[i].events;
+      events[i].fd = m_events[i].data.fd;
+      events[i].events =
+         ((ev & (EPOLLIN | EPOLLHUP | EPOLLRDHUP)) ? EventRead : 0) |
+         ((ev & EPOLLOUT) ? EventWrite : 0) |
+         ((ev & EPOLLERR) ? EventError : 0);
+   }
+
+   return cnt;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 }
\ No newline at end of file
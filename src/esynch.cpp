@@ -471,23 +471,98 @@ Bool ESemaphoreData::Decrement(Bool wait)
    if (!initialized())
       throw ESemaphoreError_NotInitialized();
 
+   // without waiting, the count is only decremented when it is positive so a
+   // concurrent Increment() never posts for a waiter that does not exist
+   if (!wait)
+      return TryDecrement(1) == 1;
+
    Long val = atomic_dec(m_currCount);
    if (val < 0)
    {
-      if (wait)
+      // a signal delivered to this thread must not abandon the wait since
+      // an Increment() may already have posted for this waiter
+      while (sem_wait(&m_sem) != 0)
       {
-         if (sem_wait(&m_sem) != 0)
-         {
-            atomic_inc(m_currCount);
-            return False;
-         }
+         if (errno != EINTR)
+            return withdraw();
       }
-      else
-      {
-         atomic_inc(m_currCount);
+   }
+   return True;
+}
+
+Bool ESemaphoreData::TimedDecrement(LongLong timeout)
+{
+   if (!initialized())
+      throw ESemaphoreError_NotInitialized();
+
+   if (timeout <= 0)
+      return Decrement(False);
+
+   Long val = atomic_dec(m_currCount);
+   if (val >= 0)
+      return True;
+
+   struct timespec ts;
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2,30)
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+   clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+   ts.tv_sec += timeout / 1000000;
+   ts.tv_nsec += (timeout % 1000000) * 1000;
+   if (ts.tv_nsec >= 1000000000)
+   {
+      ts.tv_sec++;
+      ts.tv_nsec -= 1000000000;
+   }
+
+   while (True)
+   {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2,30)
+      if (sem_clockwait(&m_sem, CLOCK_MONOTONIC, &ts) == 0)
+#else
+      if (sem_timedwait(&m_sem, &ts) == 0)
+#endif
+         return True;
+      if (errno != EINTR)
+         return withdraw();
+   }
+}
+
+Long ESemaphoreData::TryDecrement(Long count)
+{
+   if (!initialized())
+      throw ESemaphoreError_NotInitialized();
+
+   // claim as much of the positive count as possible in one step
+   Long val = m_currCount;
+   while (val > 0 && count > 0)
+   {
+      Long take = std::min(val, count);
+      Long prev = atomic_cas(m_currCount, val, val - take);
+      if (prev == val)
+         return take;
+      val = prev;
+   }
+   return 0;
+}
+
+Bool ESemaphoreData::withdraw()
+{
+   // the wait was abandoned, so remove this waiter from the count unless an
+   // Increment() has already accounted for it, in which case the post it
+   // made (or is about to make) belongs to this waiter
+   Long val = m_currCount;
+   while (val < 0)
+   {
+      Long prev = atomic_cas(m_currCount, val, val + 1);
+      if (prev == val)
          return False;
-      }
+      val = prev;
    }
+
+   while (sem_wait(&m_sem) != 0 && errno == EINTR);
+
    return True;
 }
 
@@ -508,6 +583,27 @@ Bool ESemaphoreData::Increment()
    return True;
 }
 
+Bool ESemaphoreData::Increment(Long count)
+{
+   if (!initialized())
+      throw ESemaphoreError_NotInitialized();
+
+   if (count <= 0)
+      return True;
+
+   // post once for each waiter that the increment releases
+   Long val = __sync_add_and_fetch(&m_currCount, count);
+   for (Long waiters = std::min(count, count - val); waiters > 0; waiters--)
+   {
+      if (sem_post(&m_sem) != 0)
+      {
+         __sync_sub_and_fetch(&m_currCount, waiters);
+         throw ESemaphoreError_UnableToIncrement();
+      }
+   }
+   return True;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Public Semaphore Classes
 ////////////////////////////////////////////////////////////////////////////////
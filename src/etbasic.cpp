@@ -22,6 +22,7 @@
 #include <sys/syscall.h>
 
 #include "eatomic.h"
+#include "egetopt.h"
 #include "etbasic.h"
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -36,11 +37,211 @@ EThreadError_UnableToInitialize::EThreadError_UnableToInitialize() : EError()
    appendLastOsError();
 }
 
+EThreadError_InvalidCpuList::EThreadError_InvalidCpuList(cpStr list) : EError()
+{
+   setSevere();
+   setTextf("Invalid CPU list [%s]", list);
+}
+
 /// @endcond
 
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+EThreadPlacement::EThreadPlacement()
+   : m_numa(-1),
+     m_policy(SchedPolicy::Default),
+     m_priority(0),
+     m_spread(False)
+{
+}
+
+EThreadPlacement EThreadPlacement::forIndex(Int idx) const
+{
+   EThreadPlacement p(*this);
+   if (m_spread)
+   {
+      std::vector<Int> cpus = m_cpus.empty() && m_numa >= 0 ? numaCpus(m_numa) : m_cpus;
+      if (!cpus.empty())
+         p.m_cpus.assign(1, cpus[idx % cpus.size()]);
+   }
+   return p;
+}
+
+EThreadPlacement &EThreadPlacement::load(const EGetOpt &opt, cpStr path)
+{
+   EString base(path);
+
+   cpStr list = opt.get((base + "/cpus").c_str(), static_cast<cpStr>(nullptr));
+   if (list)
+      cpus(list);
+
+   m_numa = opt.get((base + "/numaNode").c_str(), static_cast<Long>(m_numa));
+
+   EString policy(opt.get((base + "/policy").c_str(), ""));
+   if (policy == "fifo")
+      m_policy = SchedPolicy::Fifo;
+   else if (policy == "rr")
+      m_policy = SchedPolicy::RoundRobin;
+   else if (policy == "default")
+      m_policy = SchedPolicy::Default;
+
+   m_priority = opt.get((base + "/priority").c_str(), static_cast<Long>(m_priority));
+   m_spread = opt.get((base + "/spread").c_str(), m_spread);
+
+   return *this;
+}
+
+std::vector<Int> EThreadPlacement::parseCpuList(cpStr list)
+{
+   std::vector<Int> cpus;
+   cpStr p = list;
+
+   while (*p)
+   {
+      if (isspace(*p) || *p == ',')
+      {
+         p++;
+         continue;
+      }
+
+      pStr end;
+      long first = strtol(p, &end, 10);
+      long last = first;
+      if (end == p || first < 0)
+         throw EThreadError_InvalidCpuList(list);
+      p = end;
+      if (*p == '-')
+      {
+         p++;
+         last = strtol(p, &end, 10);
+         if (end == p || last < first)
+            throw EThreadError_InvalidCpuList(list);
+         p = end;
+      }
+      if (*p && *p != ',' && !isspace(*p))
+         throw EThreadError_InvalidCpuList(list);
+
+      for (long cpu = first; cpu <= last; cpu++)
+      {
+         if (cpu >= CPU_SETSIZE)
+            throw EThreadError_InvalidCpuList(list);
+         cpus.push_back(static_cast<Int>(cpu));
+      }
+   }
+
+   return cpus;
+}
+
+EString EThreadPlacement::formatCpuList(const std::vector<Int> &cpus)
+{
+   EString list;
+   size_t i = 0;
+
+   while (i < cpus.size())
+   {
+      size_t j = i;
+      while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+         j++;
+
+      if (!list.empty())
+         list.append(",");
+      list.append(std::to_string(cpus[i]));
+      if (j > i)
+         list.append("-").append(std::to_string(cpus[j]));
+      i = j + 1;
+   }
+
+   return list;
+}
+
+std::vector<Int> EThreadPlacement::numaCpus(Int node)
+{
+   Char path[64];
+   Char list[1024];
+
+   epc_sprintf_s(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+   FILE *fp = fopen(path, "r");
+   if (!fp)
+      return std::vector<Int>();
+   Bool ok = fgets(list, sizeof(list), fp) != NULL;
+   fclose(fp);
+
+   try
+   {
+      return ok ? parseCpuList(list) : std::vector<Int>();
+   }
+   catch (EError &)
+   {
+      return std::vector<Int>();
+   }
+}
+
+EString EThreadPlacement::apply() const
+{
+   EString errors;
+   Int err;
+
+   std::vector<Int> cpus = m_cpus.empty() && m_numa >= 0 ? numaCpus(m_numa) : m_cpus;
+   if (!cpus.empty())
+   {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (auto cpu : cpus)
+         CPU_SET(cpu, &set);
+      if ((err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) != 0)
+         errors.append(" affinity error [").append(strerror(err)).append("]");
+   }
+
+   if (m_numa >= 0)
+   {
+      // prefer the node so an exhausted node falls back to another node
+      const int MpolPreferred = 1;
+      unsigned long mask[16] = {};
+      if (m_numa < static_cast<Int>(sizeof(mask) * 8))
+      {
+         mask[m_numa / (sizeof(unsigned long) * 8)] |= 1UL << (m_numa % (sizeof(unsigned long) * 8));
+         if (syscall(SYS_set_mempolicy, MpolPreferred, mask, sizeof(mask) * 8) != 0)
+            errors.append(" numa error [").append(strerror(errno)).append("]");
+      }
+   }
+
+   if (m_policy != SchedPolicy::Default)
+   {
+      int policy = m_policy == SchedPolicy::Fifo ? SCHED_FIFO : SCHED_RR;
+      struct sched_param sp;
+      sp.sched_priority = std::min(std::max(m_priority, sched_get_priority_min(policy)), sched_get_priority_max(policy));
+      if ((err = pthread_setschedparam(pthread_self(), policy, &sp)) != 0)
+         errors.append(" scheduling error [").append(strerror(err)).append("]");
+   }
+
+   // describe the resulting placement
+   std::vector<Int> actual;
+   cpu_set_t set;
+   if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0)
+   {
+      for (Int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+         if (CPU_ISSET(cpu, &set))
+            actual.push_back(cpu);
+   }
+
+   int policy = SCHED_OTHER;
+   struct sched_param sp;
+   sp.sched_priority = 0;
+   pthread_getschedparam(pthread_self(), &policy, &sp);
+
+   EString report;
+   report.format("cpus=%s policy=%s priority=%d numaNode=%d",
+      formatCpuList(actual).c_str(),
+      policy == SCHED_FIFO ? "fifo" : policy == SCHED_RR ? "rr" : "default",
+      sp.sched_priority, m_numa);
+
+   return report.append(errors);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
 EThreadPtrList EThreadBasic::m_thrdCtl;
 EMutexPrivate EThreadBasic::m_thrdCtlMutex(False);
 
@@ -163,6 +364,9 @@ pVoid EThreadBasic::_threadProc(pVoid arg)
 {
    EThreadBasic *ths = (EThreadBasic *)arg;
 
+   // the placement is applied before init() returns so the report is available
+   ths->m_placementReport = ths->m_placement.apply();
+
    // set to running state
    {
       EMutexLock l(ths->m_mutex);
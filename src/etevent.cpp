@@ -57,3 +57,389 @@ Long EThreadEventTimer::m_nextid = 0;
 static EThreadEventTimerHandler _initTimerHandler;
 
 /// @endcond
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ETimerWheel::ETimerWheel()
+   : m_current(0),
+     m_count(0)
+{
+   memset(m_wheel, 0, sizeof(m_wheel));
+}
+
+Void ETimerWheel::reset(ULongLong tick)
+{
+   m_current = tick;
+}
+
+Void ETimerWheel::start(Node &node, ULongLong expires)
+{
+   stop(node);
+   node.m_expires = expires;
+   add(node);
+}
+
+Void ETimerWheel::stop(Node &node)
+{
+   if (!node.m_slot)
+      return;
+
+   if (node.m_prev)
+      node.m_prev->m_next = node.m_next;
+   else
+      *node.m_slot = node.m_next;
+   if (node.m_next)
+      node.m_next->m_prev = node.m_prev;
+
+   node.m_next = nullptr;
+   node.m_prev = nullptr;
+   node.m_slot = nullptr;
+   m_count--;
+}
+
+ETimerWheel::Node *ETimerWheel::advance(ULongLong tick)
+{
+   Node *expired = nullptr;
+   Node **tail = &expired;
+
+   while (m_current <= tick)
+   {
+      if (m_count == 0)
+      {
+         // nothing to process, jump straight to the requested tick
+         m_current = tick + 1;
+         break;
+      }
+
+      Int index = static_cast<Int>(m_current & SlotMask);
+
+      // at the start of each level 0 rotation, move the timers from the next
+      // slot of each higher level down into the lower levels
+      if (index == 0)
+      {
+         for (Int level = 1; level < Levels; level++)
+         {
+            Int idx = static_cast<Int>((m_current >> (level * LevelBits)) & SlotMask);
+            cascade(level, idx);
+            if (idx != 0)
+               break;
+         }
+      }
+
+      Node *node = m_wheel[0][index];
+      m_wheel[0][index] = nullptr;
+      while (node)
+      {
+         Node *next = node->m_next;
+         node->m_next = nullptr;
+         node->m_prev = nullptr;
+         node->m_slot = nullptr;
+         *tail = node;
+         tail = &node->m_next;
+         m_count--;
+         node = next;
+      }
+
+      m_current++;
+   }
+
+   return expired;
+}
+
+Bool ETimerWheel::getNextExpiration(ULongLong &tick) const
+{
+   if (m_count == 0)
+      return False;
+
+   // the higher levels are cascaded when this tick is processed, so any of
+   // the cascaded timers may expire on it
+   if ((m_current & SlotMask) == 0)
+   {
+      tick = m_current;
+      return True;
+   }
+
+   for (Int index = static_cast<Int>(m_current & SlotMask); index < Slots; index++)
+   {
+      if (m_wheel[0][index])
+      {
+         tick = (m_current & ~static_cast<ULongLong>(SlotMask)) + index;
+         return True;
+      }
+   }
+
+   // nothing left in this rotation of level 0, the next tick of interest is
+   // the start of the next rotation when the higher levels are cascaded
+   tick = (m_current | SlotMask) + 1;
+   return True;
+}
+
+Void ETimerWheel::add(Node &node)
+{
+   Node **slot;
+
+   if (node.m_expires < m_current)
+   {
+      // already expired, process on the next tick
+      slot = &m_wheel[0][m_current & SlotMask];
+   }
+   else
+   {
+      ULongLong delta = node.m_expires - m_current;
+
+      if (delta < (1ULL << LevelBits))
+      {
+         slot = &m_wheel[0][node.m_expires & SlotMask];
+      }
+      else if (delta < (1ULL << (2 * LevelBits)))
+      {
+         slot = &m_wheel[1][(node.m_expires >> LevelBits) & SlotMask];
+      }
+      else if (delta < (1ULL << (3 * LevelBits)))
+      {
+         slot = &m_wheel[2][(node.m_expires >> (2 * LevelBits)) & SlotMask];
+      }
+      else
+      {
+         // clamp to the range of the wheel
+         if (delta >= (1ULL << (4 * LevelBits)))
+            node.m_expires = m_current + (1ULL << (4 * LevelBits)) - 1;
+         slot = &m_wheel[3][(node.m_expires >> (3 * LevelBits)) & SlotMask];
+      }
+   }
+
+   node.m_prev = nullptr;
+   node.m_next = *slot;
+   if (*slot)
+      (*slot)->m_prev = &node;
+   *slot = &node;
+   node.m_slot = slot;
+   m_count++;
+}
+
+Void ETimerWheel::cascade(Int level, Int index)
+{
+   Node *node = m_wheel[level][index];
+   m_wheel[level][index] = nullptr;
+
+   while (node)
+   {
+      Node *next = node->m_next;
+      m_count--;
+      add(*node);
+      node = next;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/// @cond DOXYGEN_EXCLUDE
+
+// The scheduler ticks are milliseconds of CLOCK_MONOTONIC, the resolution of
+// the EThreadEventTimer interval.
+
+_EThreadEventTimerScheduler::_EThreadEventTimerScheduler()
+   : m_nextTick(ULLONG_MAX),
+     m_notify(NULL),
+     m_wakeup(NULL),
+     m_owner(0),
+     m_running(False)
+{
+   m_wheel.reset(now() / 1000);
+}
+
+_EThreadEventTimerScheduler::~_EThreadEventTimerScheduler()
+{
+   EMutexLock l(m_mutex);
+
+   // the timers outlived the thread, leave them uninitialized
+   for (auto t : m_timers)
+   {
+      m_wheel.stop(t->m_node);
+      t->m_node.pending = False;
+      t->m_scheduler = NULL;
+      t->m_initialized = False;
+   }
+   m_timers.clear();
+   m_pending.clear();
+}
+
+Void _EThreadEventTimerScheduler::setWakeup(_EThreadEventNotification *notify, _EThreadEventMessageBase *msg)
+{
+   m_notify = notify;
+   m_wakeup = msg;
+}
+
+Void _EThreadEventTimerScheduler::setRunning(Bool running)
+{
+   EMutexLock l(m_mutex);
+   m_owner = pthread_self();
+   m_running = running;
+}
+
+Void _EThreadEventTimerScheduler::attach(EThreadEventTimer &t)
+{
+   EMutexLock l(m_mutex);
+   m_timers.push_back(&t);
+}
+
+Void _EThreadEventTimerScheduler::detach(EThreadEventTimer &t)
+{
+   EMutexLock l(m_mutex);
+
+   m_wheel.stop(t.m_node);
+   removePending(t);
+
+   for (auto it = m_timers.begin(); it != m_timers.end(); ++it)
+   {
+      if (*it == &t)
+      {
+         m_timers.erase(it);
+         break;
+      }
+   }
+}
+
+Void _EThreadEventTimerScheduler::start(EThreadEventTimer &t)
+{
+   Bool wakeup = False;
+
+   {
+      EMutexLock l(m_mutex);
+
+      removePending(t);
+
+      // a zero interval disarms the timer, the same as timer_settime()
+      if (t.m_interval <= 0)
+      {
+         m_wheel.stop(t.m_node);
+         return;
+      }
+
+      // round up so that the timer never expires early
+      ULongLong tick = (now() + t.m_interval * 1000 + 999) / 1000;
+      m_wheel.start(t.m_node, tick);
+      if (t.m_node.getExpires() < m_nextTick)
+         m_nextTick = t.m_node.getExpires();
+
+      // the owning thread may be waiting on an older expiration
+      wakeup = m_running && !pthread_equal(m_owner, pthread_self());
+   }
+
+   if (wakeup && m_notify && m_wakeup)
+      m_notify->_sendThreadMessage(*m_wakeup, False);
+}
+
+Void _EThreadEventTimerScheduler::stop(EThreadEventTimer &t)
+{
+   EMutexLock l(m_mutex);
+
+   // m_nextTick is left alone, an early wakeup just finds nothing to expire
+   m_wheel.stop(t.m_node);
+   removePending(t);
+}
+
+Void _EThreadEventTimerScheduler::expire()
+{
+   EMutexLock l(m_mutex);
+
+   ULongLong tick = now() / 1000;
+   if (tick < m_nextTick)
+      return;
+
+   for (ETimerWheel::Node *node = m_wheel.advance(tick); node; node = node->getNext())
+   {
+      EThreadEventTimer &t = static_cast<EThreadEventTimer::SchedulerNode*>(node)->timer;
+      t.m_node.pending = True;
+      m_pending.push_back(&t);
+   }
+
+   if (!m_wheel.getNextExpiration(m_nextTick))
+      m_nextTick = ULLONG_MAX;
+}
+
+EThreadEventTimer *_EThreadEventTimerScheduler::nextExpired()
+{
+   EMutexLock l(m_mutex);
+
+   if (m_pending.empty())
+      return NULL;
+
+   EThreadEventTimer *t = m_pending.front();
+   m_pending.pop_front();
+   t->m_node.pending = False;
+
+   // restart a periodic timer before its handler is called so that the
+   // handler can stop it, an overrun skips the missed expirations
+   if (!t->m_oneshot && t->m_interval > 0)
+   {
+      ULongLong tick = t->m_node.getExpires() + t->m_interval;
+      ULongLong current = now() / 1000;
+      if (tick <= current)
+         tick = current + t->m_interval;
+      m_wheel.start(t->m_node, tick);
+      if (t->m_node.getExpires() < m_nextTick)
+         m_nextTick = t->m_node.getExpires();
+   }
+
+   return t;
+}
+
+LongLong _EThreadEventTimerScheduler::getTimeout()
+{
+   EMutexLock l(m_mutex);
+
+   if (!m_pending.empty())
+      return 0;
+   if (m_nextTick == ULLONG_MAX)
+      return -1;
+
+   LongLong timeout = static_cast<LongLong>(m_nextTick * 1000) - now();
+   return timeout < 0 ? 0 : timeout;
+}
+
+LongLong _EThreadEventTimerScheduler::now()
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return static_cast<LongLong>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+Void _EThreadEventTimerScheduler::removePending(EThreadEventTimer &t)
+{
+   if (!t.m_node.pending)
+      return;
+
+   for (auto it = m_pending.begin(); it != m_pending.end(); ++it)
+   {
+      if (*it == &t)
+      {
+         m_pending.erase(it);
+         break;
+      }
+   }
+   t.m_node.pending = False;
+}
+
+/// @endcond
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+EThreadWorkGroupScaling &EThreadWorkGroupScaling::load(const EGetOpt &opt, cpStr path)
+{
+   EString base(path);
+
+   m_enabled = opt.get((base + "/enabled").c_str(), m_enabled);
+   m_interval = opt.get((base + "/interval").c_str(), static_cast<Long>(m_interval));
+   m_upDepth = opt.get((base + "/scaleUpDepth").c_str(), static_cast<Long>(m_upDepth));
+   m_upLatency = opt.get((base + "/scaleUpLatency").c_str(), m_upLatency);
+   m_upBusy = opt.get((base + "/scaleUpBusy").c_str(), static_cast<Long>(m_upBusy));
+   m_downBusy = opt.get((base + "/scaleDownBusy").c_str(), static_cast<Long>(m_downBusy));
+   m_coolDown = opt.get((base + "/coolDown").c_str(), static_cast<Long>(m_coolDown));
+   step(opt.get((base + "/step").c_str(), static_cast<Long>(m_step)));
+
+   return *this;
+}
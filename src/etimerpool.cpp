@@ -24,8 +24,12 @@
 
 #include "etimerpool.h"
 
+#include <climits>
 #include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <sys/syscall.h>
+#include <sys/timerfd.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -34,16 +38,22 @@
 ETimerPoolError_CreatingTimer::ETimerPoolError_CreatingTimer()
 {
    setSevere();
-   setTextf("%s: Error executing timer_create() - ", Name());
+   setTextf("%s: Error executing timerfd_create() - ", Name());
    appendLastOsError();
 }
 
 ETimerPoolError_TimerSetTimeFailed::ETimerPoolError_TimerSetTimeFailed()
 {
    setSevere();
-   setTextf("%s: Error executing timer_settime() - ", Name());
+   setTextf("%s: Error executing timerfd_settime() - ", Name());
    appendLastOsError();
 }
+
+ETimerPoolError_TooManyTimers::ETimerPoolError_TooManyTimers()
+{
+   setSevere();
+   setTextf("%s: The maximum number of timers has been reached", Name());
+}
 /// @endcond
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -52,17 +62,38 @@ ETimerPoolError_TimerSetTimeFailed::ETimerPoolError_TimerSetTimeFailed()
 ETimerPool *ETimerPool::m_instance = NULL;
 
 ETimerPool::ETimerPool()
-   : m_thread(*this)
+   : m_freehead(nullptr),
+     m_freetail(nullptr),
+     m_timerfd(-1),
+     m_quitfd(-1),
+     m_armed(ULLONG_MAX),
+     m_notifying(nullptr),
+     m_notifyWaiters(0),
+     m_thread(*this)
 {
-   m_nextid = 0;
    m_sigtimer = SIGRTMIN + 2;
    m_sigquit = SIGRTMIN + 3;
    m_resolution = 5000;
    m_rounding = Rounding::down;
+
+   m_timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+   if (m_timerfd == -1)
+      throw ETimerPoolError_CreatingTimer();
+   m_quitfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+   if (m_quitfd == -1)
+      throw ETimerPoolError_CreatingTimer();
 }
 
 ETimerPool::~ETimerPool()
 {
+   for (auto entry : m_entries)
+      delete entry;
+   m_entries.clear();
+
+   if (m_timerfd != -1)
+      close(m_timerfd);
+   if (m_quitfd != -1)
+      close(m_quitfd);
 }
 
 ULong ETimerPool::registerTimer(LongLong ms, _EThreadEventMessageBase *msg, _EThreadEventNotification &queue)
@@ -85,128 +116,130 @@ ULong ETimerPool::registerTimer(LongLong ms, ETimerPoolExpirationCallback func,
 
 ULong ETimerPool::_registerTimer(LongLong ms, const ETimerPool::ExpirationInfo &info)
 {
-   ExpirationTime et(ms, getRounding());
-   ExpirationTimeEntryPtr etep;
-   EntryPtr ep;
-
-   // create the entry pointer
-   ep = std::make_shared<Entry>(assignNextId(), et, info);
-
-   // see if the expiration time already exists
-   auto srch = m_etmap.find( et.getExpireTime() );
-   if (srch == m_etmap.end()) // the expiration time does not exist, so add a one
-   {
-      TimerPtr tp;
-
-      // get the timer 
-      if (m_freetimers.empty())
-      {
-         tp = std::make_shared<Timer>();
-         if (!tp->create(m_thread.getThreadId(), getTimerSignal()))
-            throw ETimerPoolError_CreatingTimer();
-      }
-      else
-      {
-         tp = m_freetimers.front();
-         m_freetimers.pop_front();
-      }
-
-      // create the expiration time entry
-      etep = std::make_shared<ExpirationTimeEntry>( et.getExpireTime() );
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
 
-      // associate the timer with the expiration time entry
-      etep->setTimer( tp );
+   ULongLong now = static_cast<ULongLong>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+   ULongLong expires = (now + ms * 1000) / m_resolution + (m_rounding == Rounding::down ? 0 : 1);
 
-      // associate the expiration time entry with the timer
-      tp->setExpirationTimeEntry( etep );
+   // an empty wheel has nothing to process before the current tick, so move
+   // it forward, this also starts a wheel when a timer is registered before
+   // init() is called
+   if (m_wheel.size() == 0 && now / m_resolution > m_wheel.getCurrent())
+      m_wheel.reset( now / m_resolution );
 
-      // start the timer
-      tp->start();
+   Entry *entry = allocEntry();
+   entry->m_duration = ms;
+   entry->m_info = info;
 
-      // add the expiration time entry to the expiration time entry map
-      m_etmap[etep->getExpireTime()] = etep;
-   }
-   else // the expiration time exists
-   {
-      etep = srch->second;
-   }
+   m_wheel.start( *entry, expires );
 
-   // add the entry to the expiration time entry object
-   etep->addEntry( ep );
+   // only touch the timerfd if this timer expires before it is armed for
+   if (entry->getExpires() < m_armed)
+      arm( entry->getExpires() );
 
-   // add the expiration time entry to the entry ID map
-   m_etidmap[ep->getId()] = etep;
-
-   return ep->getId();
+   return entry->getId();
 }
 
 ETimerPool &ETimerPool::unregisterTimer(ULong id)
 {
-   EMutexLock l(m_mutex);
+   Bool wait = False;
 
-   // retrieve the expiration time entry from the id map
-   auto idsrch = m_etidmap.find( id );
-   if (idsrch != m_etidmap.end()) // if the entry was found
    {
-      ExpirationTimeEntryPtr etep = idsrch->second;
-      
-      // remove from expiration time entry's entry map
-      etep->removeEntry( id );
-
-      // remove the expiration entry if necessary
-      removeExpirationTimeEntry( etep );
+      EMutexLock l(m_mutex);
 
-      // remove trom the expiration time entry ID map
-      m_etidmap.erase( idsrch );
+      Entry *entry = findEntry( id );
+      if (entry)
+      {
+         if (entry->m_firing)
+         {
+            // the timer has expired and is waiting to be notified, so suppress
+            // the notification, sendNotifications() will free the entry
+            entry->m_cancelled = True;
+
+            // if the callback has already started, wait for it to complete so
+            // that the caller can release the data associated with the timer,
+            // unless this is called from the callback itself.  A thread message
+            // is never waited for, since the caller may be the thread that the
+            // message is being posted to and its queue may be full.
+            if (entry == m_notifying &&
+                entry->m_info.type == ExpirationInfoType::Callback &&
+                syscall(SYS_gettid) != m_thread.getThreadId())
+            {
+               m_notifyWaiters++;
+               wait = True;
+            }
+         }
+         else if (entry->isActive())
+         {
+            m_wheel.stop( *entry );
+            freeEntry( entry );
+         }
+      }
    }
 
+   if (wait)
+      m_notifyDone.Decrement();
+
+   // the timerfd is left armed, if nothing expires when it fires it will be
+   // re-armed for the next expiration
+
    return *this;
 }
 
-ETimerPool &ETimerPool::removeExpirationTimeEntry(ETimerPool::ExpirationTimeEntryPtr &etep)
+/// @cond DOXYGEN_EXCLUDE
+Void ETimerPool::sendNotifications()
 {
-   if (etep->isEntryMapEmpty())
-   {
-      // get the timer
-      auto t = etep->getTimer();
+   ETimerWheel::Node *node;
 
-      // stop the timer
-      t->stop();
+   {
+      EMutexLock l(m_mutex);
 
-      // remove from the expiration time entry map
-      m_etmap.erase( etep->getExpireTime() );
+      m_armed = ULLONG_MAX;
 
-      // clear the expiration time entry ptr in the timer
-      t->clearExpirationTimeEntry();
+      node = m_wheel.advance( currentTick() );
 
-      // add the timer to the free timer list
-      m_freetimers.push_back( t );
+      // mark the expired entries so that unregisterTimer() only cancels the
+      // notification instead of freeing an entry that is still in this list
+      for (ETimerWheel::Node *n = node; n; n = n->getNext())
+         static_cast<Entry*>(n)->m_firing = True;
    }
 
-   return *this;
-}
-
-/// @cond DOXYGEN_EXCLUDE
-Void ETimerPool::sendNotifications(ETimerPool::ExpirationTimeEntryPtr &etep)
-{
-   EMutexLock l(m_mutex);
-
-   for (auto entry = etep->getEntryMap().begin(); entry != etep->getEntryMap().end();)
+   // the notifications are sent without holding the lock so that a callback
+   // can register and unregister timers
+   while (node)
    {
-      // send the notification
-      entry->second->notify();
+      Entry *entry = static_cast<Entry*>(node);
+      node = node->getNext();
+
+      Bool cancelled;
+      {
+         EMutexLock l(m_mutex);
+         cancelled = entry->m_cancelled;
+         if (!cancelled)
+            m_notifying = entry;
+      }
 
-      // remove from the expiration time entry ID map
-      m_etidmap.erase( entry->second->getId() );
+      if (!cancelled)
+         entry->notify();
 
-      // remove from the entry map
-      entry = etep->getEntryMap().erase( entry );
+      EMutexLock l(m_mutex);
+      // release any unregisterTimer() calls waiting for this notification
+      m_notifying = nullptr;
+      if (m_notifyWaiters > 0)
+      {
+         m_notifyDone.Increment( m_notifyWaiters );
+         m_notifyWaiters = 0;
+      }
+      freeEntry( entry );
    }
 
-   if (etep->isEntryMapEmpty())
-      removeExpirationTimeEntry( etep );
+   EMutexLock l(m_mutex);
+   ULongLong tick;
+   if (m_wheel.getNextExpiration(tick) && tick < m_armed)
+      arm( tick );
 }
-/// @cond DOXYGEN_EXCLUDE
+/// @endcond
 
 Void ETimerPool::init()
 {
@@ -214,6 +247,13 @@ Void ETimerPool::init()
 
    if (m_thread.isWaitingToRun())
    {
+      // start the wheel at the current time
+      {
+         EMutexLock l(m_mutex);
+         if (m_wheel.size() == 0)
+            m_wheel.reset( currentTick() );
+      }
+
       // start the thread
       m_thread.init(&evnt);
 
@@ -224,18 +264,21 @@ Void ETimerPool::init()
 
 Void ETimerPool::uninit(Bool dumpit)
 {
-   while (!m_etidmap.empty())
-   {
-      ULong id = m_etidmap.begin()->first;
-      unregisterTimer( id );
-   }
-
    m_thread.quit();
    m_thread.join();
 
-   while (!m_freetimers.empty())
-      m_freetimers.pop_front();
-   
+   {
+      EMutexLock l(m_mutex);
+      for (auto entry : m_entries)
+      {
+         if (entry->isActive())
+         {
+            m_wheel.stop( *entry );
+            freeEntry( entry );
+         }
+      }
+   }
+
    if (dumpit)
       dump();
 
@@ -243,108 +286,120 @@ Void ETimerPool::uninit(Bool dumpit)
    delete this;
 }
 
-ULong ETimerPool::assignNextId()
+Void ETimerPool::dump()
 {
-   ULong id = ++m_nextid;
+   EMutexLock l(m_mutex);
+   size_t freecnt = 0;
 
-   if (id == 0)
-      id = ++m_nextid;
-   
-   return id;
-}
+   for (Entry *entry = m_freehead; entry; entry = entry->m_nextfree)
+      freecnt++;
 
-Void ETimerPool::dump()
-{
    std::cout << std::string(80,'*') << std::endl;
-   std::cout << "ETimerPool::dump() - m_etidmap.size() = " << m_etidmap.size() << std::endl;
-   for (auto &a : m_etidmap)
+   std::cout << "ETimerPool::dump() - active timers = " << m_wheel.size()
+      << " current tick = " << m_wheel.getCurrent()
+      << " armed tick = " << (m_armed == ULLONG_MAX ? 0 : m_armed)
+      << " resolution = " << m_resolution << "us" << std::endl;
+   for (auto entry : m_entries)
    {
-      std::cout << "\tID=" << a.first << " entrymap size=" << a.second->getEntryMap().size() << std::endl;
-      for (auto &x : a.second->getEntryMap())
+      if (entry->isActive())
       {
-         std::cout << "\t\tID=" << x.second->getId()
-            << " duration=" << x.second->getExpirationTime().getDuration()
-            << " expiretime=" << x.second->getExpirationTime().getExpireTime()
+         std::cout << "\tID=" << entry->getId()
+            << " duration=" << entry->getDuration()
+            << " expiretick=" << entry->getExpires()
             << std::endl;
       }
    }
 
-   std::cout << "ETimerPool::dump() - m_etmap.size() = " << m_etmap.size() << std::endl;
-   for (auto &b : m_etmap)
-   {
-      std::cout << "\texpiretime=" << b.first
-         << " timerhandle=" << b.second->getTimer()->getHandle()
-         << " entrymap size=" << b.second->getEntryMap().size() << std::endl;
-      for (auto &x : b.second->getEntryMap())
-      {
-         std::cout << "\t\tID=" << x.second->getId()
-            << " duration=" << x.second->getExpirationTime().getDuration()
-            << " expiretime=" << x.second->getExpirationTime().getExpireTime()
-            << std::endl;
-      }
-   }
-
-   std::cout << "ETimerPool::dump() - m_freetimers.size() = " << m_freetimers.size() << std::endl;
+   std::cout << "ETimerPool::dump() - entries = " << m_entries.size()
+      << " free entries = " << freecnt << std::endl;
 
    std::cout << std::string(80,'*') << std::endl;
    std::cout << std::flush;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-
 /// @cond DOXYGEN_EXCLUDE
-
-ETimerPool::Timer::Timer()
+ETimerPool::Entry *ETimerPool::allocEntry()
 {
-   m_timer = 0;
-}
+   Entry *entry = m_freehead;
 
-ETimerPool::Timer::~Timer()
-{
-   if (m_timer)
+   if (entry)
    {
-      timer_delete( m_timer );
-      m_timer = 0;
+      m_freehead = entry->m_nextfree;
+      if (!m_freehead)
+         m_freetail = nullptr;
+      entry->m_nextfree = nullptr;
    }
+   else
+   {
+      if (m_entries.size() >= Entry::MaxEntries)
+         throw ETimerPoolError_TooManyTimers();
+      entry = new Entry( static_cast<UInt>(m_entries.size()) );
+      m_entries.push_back( entry );
+   }
+
+   return entry;
 }
 
-Bool ETimerPool::Timer::create(pid_t tid, int sig)
+Void ETimerPool::freeEntry(ETimerPool::Entry *entry)
 {
-   int status;
-   struct sigevent se;
+   // the entry owns the thread message
+   if (entry->m_info.type == ExpirationInfoType::Queue && entry->m_info.u.queue.msg)
+      delete entry->m_info.u.queue.msg;
+   entry->m_info.clear();
+
+   entry->m_duration = 0;
+   entry->m_firing = False;
+   entry->m_cancelled = False;
+
+   // invalidate any outstanding timer ID's for this entry
+   entry->m_generation = (entry->m_generation + 1) & Entry::GenerationMask;
+   if (entry->m_generation == 0)
+      entry->m_generation = 1;
+
+   entry->m_nextfree = nullptr;
+   if (m_freetail)
+      m_freetail->m_nextfree = entry;
+   else
+      m_freehead = entry;
+   m_freetail = entry;
+}
 
-   memset( &se, 0, sizeof(se) );
-   se.sigev_notify = SIGEV_THREAD_ID;
-   se._sigev_un._tid = tid;
-   se.sigev_signo = sig;
-   se.sigev_value.sival_ptr = this;
+ETimerPool::Entry *ETimerPool::findEntry(ULong timerid)
+{
+   UInt index = timerid & (Entry::MaxEntries - 1);
+   UInt generation = timerid >> Entry::IndexBits;
 
-   status = timer_create(CLOCK_REALTIME, &se, &m_timer);
+   if (index >= m_entries.size())
+      return nullptr;
 
-   return status == -1 ? False : True;
+   Entry *entry = m_entries[index];
+   return entry->m_generation == generation ? entry : nullptr;
 }
 
-Void ETimerPool::Timer::start()
+ULongLong ETimerPool::currentTick()
 {
-   struct itimerspec ts = {};
-
-   ts.it_interval.tv_sec = 0;
-   ts.it_interval.tv_nsec = 0;
-   ts.it_value.tv_sec = m_etep->getExpireTime() / 1000000;
-   ts.it_value.tv_nsec = m_etep->getExpireTime() % 1000000 * 1000;
-
-   if (timer_settime(m_timer, TIMER_ABSTIME, &ts, NULL) == -1)
-      throw ETimerPoolError_TimerSetTimeFailed();
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (static_cast<ULongLong>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000) / m_resolution;
 }
 
-Void ETimerPool::Timer::stop()
+Void ETimerPool::arm(ULongLong tick)
 {
-   struct itimerspec ts = {};
+   struct itimerspec its = {};
+   ULongLong us = tick * m_resolution;
 
-   timer_settime(m_timer, 0, &ts, NULL);
-}
+   // a zero value disarms the timer, so make sure it is in the past instead
+   if (us == 0)
+      us = 1;
+
+   its.it_value.tv_sec = us / 1000000;
+   its.it_value.tv_nsec = us % 1000000 * 1000;
+
+   if (timerfd_settime(m_timerfd, TFD_TIMER_ABSTIME, &its, NULL) == -1)
+      throw ETimerPoolError_TimerSetTimeFailed();
 
+   m_armed = tick;
+}
 /// @endcond
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -379,36 +434,45 @@ ETimerPool::Thread::Thread(ETimerPool &tp)
 
 Void ETimerPool::Thread::quit()
 {
-   signal( m_tp.getQuitSignal() );
+   uint64_t val = 1;
+   if (write( m_tp.m_quitfd, &val, sizeof(val) ) == -1)
+      return;
 }
 
 Dword ETimerPool::Thread::threadProc(Void *arg)
 {
    Bool run = True;
    EEvent *evnt = (EEvent*)arg;
-   sigset_t set;
-   siginfo_t si;
-   ETimerPool &tp( ETimerPool::Instance() );
+   struct pollfd fds[2];
 
    // retrieve the thread for this thread
    m_tid = syscall(SYS_gettid);
    evnt->set();
 
-   sigemptyset( &set );
-   sigaddset( &set, tp.getTimerSignal() );
-   sigaddset( &set, tp.getQuitSignal() );
+   fds[0].fd = m_tp.m_timerfd;
+   fds[0].events = POLLIN;
+   fds[1].fd = m_tp.m_quitfd;
+   fds[1].events = POLLIN;
 
    while (run)
    {
-      int sig = sigwaitinfo( &set, &si );
+      fds[0].revents = 0;
+      fds[1].revents = 0;
+
+      if (poll( fds, 2, -1 ) == -1)
+         continue;
 
-      if (sig == tp.getTimerSignal())
+      if (fds[1].revents & POLLIN)
       {
-         Instance().sendNotifications( ((Timer*)si.si_value.sival_ptr)->getExpirationTimeEntry() );
+         uint64_t val;
+         if (read( m_tp.m_quitfd, &val, sizeof(val) ) == -1) {}
+         run = False;
       }
-      else if (sig == tp.getQuitSignal())
+      else if (fds[0].revents & POLLIN)
       {
-         run = False;
+         uint64_t expirations;
+         if (read( m_tp.m_timerfd, &expirations, sizeof(expirations) ) == -1) {}
+         m_tp.sendNotifications();
       }
    }
 
@@ -418,4 +482,3 @@ Dword ETimerPool::Thread::threadProc(Void *arg)
 /// @endcond
 
 ////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
@@ -25,6 +25,8 @@ namespace PFCP_R15
 {
 
 /// @cond DOXYGEN_EXCLUDE
+thread_local Bool LengthCalculator::deferred_ = False;
+thread_local Bool LengthCalculator::finalizing_ = False;
 EMemory::Pool *HeartbeatReq::pool_ = nullptr;
 EMemory::Pool *HeartbeatRsp::pool_ = nullptr;
 EMemory::Pool *PfdMgmtReq::pool_ = nullptr;
@@ -48,10 +50,98 @@ EMemory::Pool *SessionDeletionReq::pool_ = nullptr;
 EMemory::Pool *SessionDeletionRsp::pool_ = nullptr;
 EMemory::Pool *SessionReportReq::pool_ = nullptr;
 EMemory::Pool *SessionReportRsp::pool_ = nullptr;
+EMemory::Pool *SessionEstablishmentReqView::pool_ = nullptr;
+EMemory::Pool *SessionModificationReqView::pool_ = nullptr;
 /// @endcond
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+MessageView::MessageView()
+   : data_(nullptr),
+     len_(0)
+{
+}
+
+MessageView::~MessageView()
+{
+   if (data_ != nullptr && !buf_.valid())
+      delete [] data_;
+}
+
+Void MessageView::assign(cpUChar data, UShort len, const EMemory::Buffer *buf)
+{
+   if (buf_.valid())
+      buf_.release();
+   else if (data_ != nullptr)
+      delete [] data_;
+   data_ = nullptr;
+   len_ = 0;
+   entries_.clear();
+
+   if (buf != nullptr && buf->valid())
+   {
+      // reference the pooled buffer instead of copying the data
+      buf_ = *buf;
+      data_ = buf_.data();
+      len_ = static_cast<UShort>(buf_.length());
+   }
+   else
+   {
+      data_ = new UChar[len];
+      std::memcpy(data_, data, len);
+      len_ = len;
+   }
+
+   if (len_ < 4)
+      return;
+
+   // the message length does not include the first 4 octets of the header
+   // and the header includes the SEID and sequence number when S is set
+   size_t end = std::min(static_cast<size_t>(len_), 4 + static_cast<size_t>((data_[2] << 8) | data_[3]));
+   size_t ofs = (data_[0] & 0x01) ? 16 : 8;
+
+   entries_.reserve(16);
+   while (ofs + 4 <= end)
+   {
+      uint16_t type = (data_[ofs] << 8) | data_[ofs + 1];
+      uint16_t len = (data_[ofs + 2] << 8) | data_[ofs + 3];
+      if (ofs + 4 + len > end)
+         break;
+      entries_.push_back({type, static_cast<uint16_t>(ofs)});
+      ofs += 4 + len;
+   }
+}
+
+UShort MessageView::count(uint16_t type) const
+{
+   UShort cnt = 0;
+   for (auto &e : entries_)
+      if (e.type == type)
+         cnt++;
+   return cnt;
+}
+
+cpUChar MessageView::find(uint16_t type, UShort occurrence) const
+{
+   for (auto &e : entries_)
+   {
+      if (e.type == type)
+      {
+         if (occurrence == 0)
+            return data_ + e.offset;
+         occurrence--;
+      }
+   }
+   return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 Translator::Translator()
-   : mp_{}
+   : mp_{},
+     views_(False)
 {
    {
       size_t as = 0;
@@ -60,12 +150,16 @@ Translator::Translator()
       as = std::max(as, sizeof(SessionDeletionReq));
       as = std::max(as, sizeof(HeartbeatReq));
       as = std::max(as, sizeof(PfdMgmtRsp));
+      as = std::max(as, sizeof(SessionEstablishmentReqView));
+      as = std::max(as, sizeof(SessionModificationReqView));
       mp_[0] = new EMemory::Pool(as,0,10);
       VersionNotSupportedRsp::setMemoryPool(*mp_[0]);
       HeartbeatRsp::setMemoryPool(*mp_[0]);
       SessionDeletionReq::setMemoryPool(*mp_[0]);
       HeartbeatReq::setMemoryPool(*mp_[0]);
       PfdMgmtRsp::setMemoryPool(*mp_[0]);
+      SessionEstablishmentReqView::setMemoryPool(*mp_[0]);
+      SessionModificationReqView::setMemoryPool(*mp_[0]);
    }
    {
       size_t as = 0;
@@ -151,10 +245,11 @@ PFCP::ReqOutPtr Translator::encodeHeartbeatReq(PFCP::SndHeartbeatReqData &hb)
    HeartbeatReq *req = new HeartbeatReq(ro->localNode(), ro->remoteNode());
    ro->setSeqNbr(req->seqNbr());
    req->rcvry_time_stmp().rcvry_time_stmp_val(ro->localNode()->startTime());
-   req->encode(data());
+   EMemory::Buffer buf;
+   req->encode(encodeBuffer(buf));
 
    ro->setAppMsg(req);
-   ro->assign(data(), req->length());
+   assignEncoded(*ro, buf, req->length());
 
    return ro;
 }
@@ -169,10 +264,11 @@ PFCP::RspOutPtr Translator::encodeHeartbeatRsp(PFCP::SndHeartbeatRspData &hb)
    HeartbeatRsp *rsp = new HeartbeatRsp();
    rsp->setReq(&hb.req());
    rsp->rcvry_time_stmp().rcvry_time_stmp_val(ro->localNode()->startTime());
-   rsp->encode(data());
+   EMemory::Buffer buf;
+   rsp->encode(encodeBuffer(buf));
 
    ro->setAppMsg(rsp);
-   ro->assign(data(), rsp->length());
+   assignEncoded(*ro, buf, rsp->length());
 
    return ro;
 }
@@ -192,18 +288,131 @@ PFCP::RspOutPtr Translator::encodeVersionNotSupportedRsp(PFCP::ReqInPtr msg)
 
    ro->setAppMsg(rsp);
 
-   UShort len = encode_pfcp_header_t(&rsp->data(), data());
-   reinterpret_cast<pfcp_header_t*>(data())->message_len = htons(len - 4);
+   EMemory::Buffer buf;
+   pUChar dest = encodeBuffer(buf);
+   UShort len = encode_pfcp_header_t(&rsp->data(), dest);
+   reinterpret_cast<pfcp_header_t*>(dest)->message_len = htons(len - 4);
 
-   ro->assign(data(), len);
+   assignEncoded(*ro, buf, len);
 
    return ro;
 }
 
+PFCP::RspOutPtr Translator::encodeOverloadRsp(PFCP::ReqInPtr msg, UChar cause)
+{
+   // only new sessions are refused while overloaded
+   if (msg->msgType() != PFCP_SESS_ESTAB_REQ)
+      return nullptr;
+
+   // there is no session, so the rsp SEID is the control plane F-SEID of the req
+   MessageView view;
+   view.assign(msg->data(), msg->len(), msg->buffer());
+   LazyIE<FSeidIE,pfcp_fseid_ie_t> cpfseid;
+   PFCP::Seid rs = view.find(PFCP_IE_FSEID) ?
+      view.decode(cpfseid, PFCP_IE_FSEID, 0, decode_pfcp_fseid_ie_t).seid() : 0;
+
+   PFCP::RspOutPtr ro = new PFCP::RspOut();
+   ro->setLocalNode(msg->localNode());
+   ro->setRemoteNode(msg->remoteNode());
+   ro->setSeqNbr(msg->seqNbr());
+
+   SessionEstablishmentRsp *rsp = new SessionEstablishmentRsp();
+   rsp->setSeqNbr(ro->seqNbr());
+   rsp->node_id().node_id_value(msg->localNode()->address());
+   rsp->cause().cause(static_cast<CauseEnum>(cause));
+
+   Int validity = PFCP::Configuration::overloadControlValidity();
+   if (validity > 0)
+   {
+      OverloadControlInformationIE &oci = rsp->ovrld_ctl_info();
+      oci.ovrld_ctl_seqn_nbr().sequence_number(msg->localNode()->overloadSeqNbr());
+      oci.ovrld_reduction_metric().metric(static_cast<uint8_t>(msg->localNode()->overloadMetric()));
+
+      // the timer value is 5 bits, so the coarsest unit that fits is used
+      if (validity < 64)
+         oci.period_of_validity().timer_unit(TimerTimerUnitEnum::two_seconds).timer_value(validity / 2);
+      else if (validity < 32 * 60)
+         oci.period_of_validity().timer_unit(TimerTimerUnitEnum::one_minute).timer_value(validity / 60);
+      else if (validity < 32 * 600)
+         oci.period_of_validity().timer_unit(TimerTimerUnitEnum::ten_minutes).timer_value(validity / 600);
+      else
+         oci.period_of_validity().timer_unit(TimerTimerUnitEnum::one_hour).timer_value(std::min(validity / 3600, 31));
+
+      LengthCalculator::Finalizer f;
+      oci.packedLength();
+   }
+
+   ro->setAppMsg(rsp);
+
+   rsp->data().header.seid_seqno.has_seid.seq_no = ro->seqNbr();
+   rsp->data().header.seid_seqno.has_seid.seid = rs;
+
+   EMemory::Buffer buf;
+   pUChar dest = encodeBuffer(buf);
+   UShort len = encode_pfcp_sess_estab_rsp_t(&rsp->data(), dest);
+   reinterpret_cast<pfcp_header_t*>(dest)->message_len = htons(len - 4);
+
+   assignEncoded(*ro, buf, len);
+
+   return ro;
+}
+
+Bool Translator::parseHeartbeatReq(cpUChar msg, Int len, ETime &startTime)
+{
+   const pfcp_header_t *header = reinterpret_cast<const pfcp_header_t*>(msg);
+   if (len < 8 || header->message_type != PFCP_HRTBEAT_REQ)
+      return False;
+
+   // walk the IE's for the recovery time stamp, the header is 8 or 16 bytes
+   Int end = std::min(len, ntohs(header->message_len) + 4);
+   for (Int ofs = header->s ? 16 : 8; ofs + 4 <= end; )
+   {
+      UShort type = (msg[ofs] << 8) | msg[ofs + 1];
+      UShort ielen = (msg[ofs + 2] << 8) | msg[ofs + 3];
+      if (type == PFCP_IE_RCVRY_TIME_STMP)
+      {
+         if (ielen < 4 || ofs + 8 > end)
+            return False;
+         ntp_time_t ntp;
+         ntp.second = (static_cast<UInt>(msg[ofs + 4]) << 24) | (msg[ofs + 5] << 16) | (msg[ofs + 6] << 8) | msg[ofs + 7];
+         ntp.fraction = 0;
+         startTime.setNTPTime(ntp);
+         return True;
+      }
+      ofs += 4 + ielen;
+   }
+
+   return False;
+}
+
+UShort Translator::encodeHeartbeatRspTemplate(PFCP::LocalNode &ln, pUChar dest, UShort len)
+{
+   // the encoded rsp is never larger than the structure it is encoded from
+   if (len < sizeof(pfcp_hrtbeat_rsp_t))
+      return 0;
+
+   HeartbeatRsp rsp;
+   rsp.rcvry_time_stmp().rcvry_time_stmp_val(ln.startTime());
+   rsp.data().header.seid_seqno.no_seid.seq_no = 0;
+
+   UShort encoded = encode_pfcp_hrtbeat_rsp_t(&rsp.data(), dest);
+   reinterpret_cast<pfcp_header_t*>(dest)->message_len = htons(encoded - 4);
+
+   return encoded;
+}
+
+Void Translator::assignRspSeqNbr(pUChar rsp, ULong seqNbr)
+{
+   // the 3 byte sequence number follows the SEID when one is present
+   pUChar sn = rsp + (reinterpret_cast<pfcp_header_t*>(rsp)->s ? 12 : 4);
+   sn[0] = static_cast<UChar>(seqNbr >> 16);
+   sn[1] = static_cast<UChar>(seqNbr >> 8);
+   sn[2] = static_cast<UChar>(seqNbr);
+}
+
 PFCP::ReqOutPtr Translator::encodeReq(PFCP::AppMsgReqPtr req)
 {
    static EString __method__ = __METHOD_NAME__;
-   UShort len = 0;
 
    PFCP::ReqOutPtr ro = new PFCP::ReqOut();
    ro->setLocalNode(req->localNode());
@@ -213,83 +422,86 @@ PFCP::ReqOutPtr Translator::encodeReq(PFCP::AppMsgReqPtr req)
    ro->setSeqNbr(req->seqNbr());
    ro->setAppMsg(req);
 
+   EMemory::Buffer buf;
+   pUChar dest = encodeBuffer(buf);
+
    switch (req->msgType())
    {
       case PFCP_HRTBEAT_REQ:
       {
          HeartbeatReq *am = static_cast<HeartbeatReq*>(req);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_PFD_MGMT_REQ:
       {
          PfdMgmtReq *am = static_cast<PfdMgmtReq*>(req);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_ASSN_SETUP_REQ:
       {
          AssnSetupReq *am = static_cast<AssnSetupReq*>(req);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_ASSN_UPD_REQ:
       {
          AssnUpdateReq *am = static_cast<AssnUpdateReq*>(req);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_ASSN_REL_REQ:
       {
          AssnReleaseReq *am = static_cast<AssnReleaseReq*>(req);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_NODE_RPT_REQ:
       {
          NodeReportReq *am = static_cast<NodeReportReq*>(req);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_SESS_SET_DEL_REQ:
       {
          SessionSetDeletionReq *am = static_cast<SessionSetDeletionReq*>(req);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_SESS_ESTAB_REQ:
       {
          SessionEstablishmentReq *am = static_cast<SessionEstablishmentReq*>(req);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_SESS_MOD_REQ:
       {
          SessionModificationReq *am = static_cast<SessionModificationReq*>(req);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_SESS_DEL_REQ:
       {
          SessionDeletionReq *am = static_cast<SessionDeletionReq*>(req);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_SESS_RPT_REQ:
       {
          SessionReportReq *am = static_cast<SessionReportReq*>(req);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       default:
@@ -300,9 +512,6 @@ PFCP::ReqOutPtr Translator::encodeReq(PFCP::AppMsgReqPtr req)
       }
    }
 
-   // update the header length
-   reinterpret_cast<pfcp_header_t*>(data())->message_len = htons(len - 4);
-
    return ro;
 }
 
@@ -310,7 +519,10 @@ PFCP::RspOutPtr Translator::encodeRsp(PFCP::AppMsgRspPtr rsp)
 {
    static EString __method__ = __METHOD_NAME__;
 
-   std::memset(data(), 0, ESocket::UPD_MAX_MSG_LENGTH);
+   EMemory::Buffer buf;
+   pUChar dest = encodeBuffer(buf);
+   if (!buf.valid())
+      std::memset(dest, 0, ESocket::UPD_MAX_MSG_LENGTH);
 
    PFCP::RspOutPtr ro = new PFCP::RspOut();
    ro->setLocalNode(rsp->localNode());
@@ -323,85 +535,85 @@ PFCP::RspOutPtr Translator::encodeRsp(PFCP::AppMsgRspPtr rsp)
       case PFCP_HRTBEAT_RSP:
       {
          HeartbeatRsp *am = static_cast<HeartbeatRsp*>(rsp);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_VERSION_NOT_SUPPORTED:
       {
          VersionNotSupportedRsp *am = static_cast<VersionNotSupportedRsp*>(rsp);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_PFD_MGMT_RSP:
       {
          PfdMgmtRsp *am = static_cast<PfdMgmtRsp*>(rsp);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_ASSN_SETUP_RSP:
       {
          AssnSetupRsp *am = static_cast<AssnSetupRsp*>(rsp);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_ASSN_UPD_RSP:
       {
          AssnUpdateRsp *am = static_cast<AssnUpdateRsp*>(rsp);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_ASSN_REL_RSP:
       {
          AssnReleaseRsp *am = static_cast<AssnReleaseRsp*>(rsp);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_NODE_RPT_RSP:
       {
          NodeReportRsp *am = static_cast<NodeReportRsp*>(rsp);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_SESS_SET_DEL_RSP:
       {
          SessionSetDeletionRsp *am = static_cast<SessionSetDeletionRsp*>(rsp);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_SESS_ESTAB_RSP:
       {
          SessionEstablishmentRsp *am = static_cast<SessionEstablishmentRsp*>(rsp);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_SESS_MOD_RSP:
       {
          SessionModificationRsp *am = static_cast<SessionModificationRsp*>(rsp);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_SESS_DEL_RSP:
       {
          SessionDeletionRsp *am = static_cast<SessionDeletionRsp*>(rsp);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       case PFCP_SESS_RPT_RSP:
       {
          SessionReportRsp *am = static_cast<SessionReportRsp*>(rsp);
-         am->encode(data());
-         ro->assign(data(), am->length());
+         am->encode(dest);
+         assignEncoded(*ro, buf, am->length());
          break;
       }
       default:
@@ -480,6 +692,14 @@ PFCP::AppMsgReqPtr Translator::decodeReq(PFCP::ReqInPtr req)
       }
       case PFCP_SESS_ESTAB_REQ:
       {
+         if (views_)
+         {
+            SessionEstablishmentReqView *tmp = new SessionEstablishmentReqView(req->session(), req->data(), req->len(), req->buffer());
+            am = tmp;
+            if (tmp->cp_fseid().present())
+               req->remoteSeid(tmp->cp_fseid().seid());
+            break;
+         }
          SessionEstablishmentReq *tmp = new SessionEstablishmentReq(req->session(), False);
          decode_pfcp_sess_estab_req_t((pUChar)req->data(), &tmp->data());
          am = tmp;
@@ -490,6 +710,11 @@ PFCP::AppMsgReqPtr Translator::decodeReq(PFCP::ReqInPtr req)
       }
       case PFCP_SESS_MOD_REQ:
       {
+         if (views_)
+         {
+            am = new SessionModificationReqView(req->session(), req->data(), req->len(), req->buffer());
+            break;
+         }
          SessionModificationReq *tmp = new SessionModificationReq(req->session(), False);
          decode_pfcp_sess_mod_req_t((pUChar)req->data(), &tmp->data());
          am = tmp;